@@ -0,0 +1,372 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/Version.hpp>
+#include <SoapySDR/Types.hpp>
+#include <SoapySDR/Formats.hpp>
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************************
+ * Converter throughput benchmark
+ *
+ * Every registered source/target/priority is measured for each buffer
+ * size and thread count. Each thread converts its own buffers, so the
+ * larger sizes show the DRAM bandwidth shared by all of the threads.
+ * Converters with a streaming variant are measured with both kinds of
+ * stores, and the buffer size where non-temporal stores stop losing
+ * is reported as the streaming threshold for this machine.
+ * Results are emitted as JSON so runs can be compared across releases
+ * and CPUs. Only the public API is used, and newer calls are guarded
+ * by the SOAPY_SDR_API_HAS_* defines, so this file also builds against
+ * an installed release that predates them for before/after numbers.
+ **********************************************************************/
+struct BenchResult
+{
+    std::string source;
+    std::string target;
+    SoapySDR::ConverterRegistry::FunctionPriority priority;
+    bool streaming;
+    size_t bufferBytes;
+    size_t numElems;
+    size_t numThreads;
+    double scaler;
+    double msps;
+    double gbps;
+};
+
+//! Split a space separated list from the options markup
+static std::vector<std::string> splitList(const std::string &list)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (ss >> item) items.push_back(item);
+    return items;
+}
+
+//! Parse a byte count with an optional K, M, or G suffix
+static size_t parseBytes(const std::string &str)
+{
+    size_t pos(0);
+    const size_t num = std::stoul(str, &pos);
+    const std::string suffix = str.substr(pos);
+    if (suffix.empty()) return num;
+    if (suffix == "K" or suffix == "k") return num << 10;
+    if (suffix == "M" or suffix == "m") return num << 20;
+    if (suffix == "G" or suffix == "g") return num << 30;
+    throw std::invalid_argument("bad size suffix: " + str);
+}
+
+static std::string getOption(const SoapySDR::Kwargs &options, const std::string &key)
+{
+    const auto it = options.find(key);
+    return (it == options.end())?"":it->second;
+}
+
+static std::string priorityName(const SoapySDR::ConverterRegistry::FunctionPriority priority)
+{
+    switch (priority)
+    {
+    case SoapySDR::ConverterRegistry::GENERIC: return "GENERIC";
+    case SoapySDR::ConverterRegistry::VECTORIZED: return "VECTORIZED";
+    case SoapySDR::ConverterRegistry::CUSTOM: return "CUSTOM";
+    }
+    return std::to_string(int(priority));
+}
+
+static std::string jsonString(const std::string &str)
+{
+    std::string out("\"");
+    for (const char ch : str)
+    {
+        if (ch == '"' or ch == '\\') out += '\\';
+        out += ch;
+    }
+    return out + "\"";
+}
+
+static std::string getCPUModel(void)
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+    {
+        if (line.compare(0, 10, "model name") != 0) continue;
+        const auto pos = line.find(':');
+        if (pos != std::string::npos) return line.substr(std::min(pos+2, line.size()));
+    }
+    return "unknown";
+}
+
+//! Fill a buffer with samples in the nominal range of the format
+static void fillBuffer(std::vector<char> &buff, const std::string &format)
+{
+    for (auto &b : buff) b = char(std::rand());
+    if (format.find('F') == std::string::npos) return;
+
+    //floating point formats: keep the narrowing conversions in range
+    const size_t width = SoapySDR::formatToSize(format)/((format[0] == 'C')?2:1);
+    if (width == sizeof(float))
+    {
+        auto *p = (float *)buff.data();
+        for (size_t i = 0; i < buff.size()/sizeof(float); i++) p[i] = float(std::rand())/RAND_MAX - 0.5f;
+    }
+    if (width == sizeof(double))
+    {
+        auto *p = (double *)buff.data();
+        for (size_t i = 0; i < buff.size()/sizeof(double); i++) p[i] = double(std::rand())/RAND_MAX - 0.5;
+    }
+}
+
+//! Run the converter on numThreads threads and return the total Msps
+static double measureMsps(
+    const SoapySDR::ConverterRegistry::ConverterFunction function,
+    const std::string &source, const std::string &target,
+    const size_t numElems, const size_t numThreads,
+    const double scaler, const double duration)
+{
+    std::vector<std::vector<char>> srcs(numThreads), dsts(numThreads);
+    for (size_t t = 0; t < numThreads; t++)
+    {
+        srcs[t].resize(numElems*SoapySDR::formatToSize(source));
+        dsts[t].resize(numElems*SoapySDR::formatToSize(target));
+        fillBuffer(srcs[t], source);
+    }
+
+    std::atomic<size_t> ready(0);
+    std::vector<double> rates(numThreads);
+    auto worker = [&](const size_t t)
+    {
+        //warm up the caches and the branch predictors
+        function(srcs[t].data(), dsts[t].data(), numElems, scaler);
+        ready++;
+        while (ready.load() < numThreads) std::this_thread::yield();
+
+        size_t numIters(0);
+        const auto start = std::chrono::high_resolution_clock::now();
+        auto elapsed = std::chrono::duration<double>::zero();
+        while (numIters < 2 or elapsed.count() < duration)
+        {
+            function(srcs[t].data(), dsts[t].data(), numElems, scaler);
+            numIters++;
+            elapsed = std::chrono::high_resolution_clock::now() - start;
+        }
+        rates[t] = (numIters*numElems)/elapsed.count()/1e6;
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < numThreads; t++) threads.emplace_back(worker, t);
+    worker(0);
+    for (auto &thread : threads) thread.join();
+
+    double total(0.0);
+    for (const auto rate : rates) total += rate;
+    return total;
+}
+
+/*!
+ * The smallest buffer size from which the streaming stores are at least as fast
+ * as the cached stores for every larger size, over all measured pairs,
+ * thread counts, and scalers. Zero when streaming never catches up.
+ */
+static size_t findStreamingThreshold(const std::vector<BenchResult> &results)
+{
+    size_t threshold(0);
+    for (const auto &s : results)
+    {
+        if (not s.streaming) continue;
+        const auto cached = std::find_if(results.begin(), results.end(), [&](const BenchResult &c)
+        {
+            return not c.streaming and c.source == s.source and c.target == s.target and c.priority == s.priority and
+                c.bufferBytes == s.bufferBytes and c.numThreads == s.numThreads and c.scaler == s.scaler;
+        });
+        if (cached == results.end() or s.msps >= cached->msps) continue;
+        //streaming lost at this size, so the crossover is above it
+        threshold = std::max(threshold, s.bufferBytes+1);
+    }
+
+    //round up to the next measured size
+    size_t measured(0);
+    for (const auto &r : results)
+    {
+        if (r.streaming and r.bufferBytes >= threshold and (measured == 0 or r.bufferBytes < measured)) measured = r.bufferBytes;
+    }
+    return measured;
+}
+
+static void writeJSON(std::ostream &os, const SoapySDR::Kwargs &options, const std::vector<BenchResult> &results)
+{
+    os << "{" << std::endl;
+    os << "  \"libVersion\": " << jsonString(SoapySDR::getLibVersion()) << "," << std::endl;
+    os << "  \"abiVersion\": " << jsonString(SoapySDR::getABIVersion()) << "," << std::endl;
+    os << "  \"cpuModel\": " << jsonString(getCPUModel()) << "," << std::endl;
+    os << "  \"hardwareConcurrency\": " << std::thread::hardware_concurrency() << "," << std::endl;
+    os << "  \"options\": {";
+    bool first(true);
+    for (const auto &pair : options)
+    {
+        os << (first?"":", ") << jsonString(pair.first) << ": " << jsonString(pair.second);
+        first = false;
+    }
+    os << "}," << std::endl;
+    os << "  \"streamingThreshold\": " << findStreamingThreshold(results) << "," << std::endl;
+    os << "  \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const auto &r = results[i];
+        os << "    {\"source\": " << jsonString(r.source)
+           << ", \"target\": " << jsonString(r.target)
+           << ", \"priority\": " << jsonString(priorityName(r.priority))
+           << ", \"stores\": " << jsonString(r.streaming?"streaming":"cached")
+           << ", \"bufferBytes\": " << r.bufferBytes
+           << ", \"numElems\": " << r.numElems
+           << ", \"threads\": " << r.numThreads
+           << ", \"scaler\": " << r.scaler
+           << ", \"msps\": " << r.msps
+           << ", \"gbps\": " << r.gbps << "}"
+           << ((i+1 == results.size())?"":",") << std::endl;
+    }
+    os << "  ]" << std::endl;
+    os << "}" << std::endl;
+}
+
+/***********************************************************************
+ * Benchmark entry point, options are key=value markup:
+ *  - source: space separated source formats (default all)
+ *  - target: space separated target formats (default all)
+ *  - sizes: space separated buffer sizes in bytes with K/M/G suffix
+ *  - threads: space separated thread counts
+ *  - scalers: space separated scale factors (default 1.0)
+ *  - time: seconds to measure each configuration (default 0.02)
+ *  - streaming: also measure the streaming store variants (default true)
+ *  - output: JSON file path (default stdout)
+ **********************************************************************/
+int SoapySDRConverterBench(const std::string &argStr)
+{
+    SoapySDR::Kwargs options = SoapySDR::KwargsFromString(argStr);
+
+    //defaults span L1-resident buffers through DRAM-sized buffers
+    if (options.count("sizes") == 0) options["sizes"] = "16K 256K 4M 64M";
+    if (options.count("threads") == 0)
+    {
+        std::string threads("1");
+        const size_t maxThreads = std::min<size_t>(std::thread::hardware_concurrency(), 8);
+        for (size_t n = 2; n <= maxThreads; n *= 2) threads += " " + std::to_string(n);
+        options["threads"] = threads;
+    }
+    if (options.count("scalers") == 0) options["scalers"] = "1.0";
+    if (options.count("time") == 0) options["time"] = "0.02";
+    if (options.count("streaming") == 0) options["streaming"] = "true";
+    const bool benchStreaming = SoapySDR::StringToSetting<bool>(options.at("streaming"));
+
+    std::vector<size_t> sizes, threads;
+    std::vector<double> scalers;
+    double duration(0.0);
+    try
+    {
+        for (const auto &s : splitList(options.at("sizes"))) sizes.push_back(parseBytes(s));
+        for (const auto &s : splitList(options.at("threads"))) threads.push_back(std::max<size_t>(std::stoul(s), 1));
+        for (const auto &s : splitList(options.at("scalers"))) scalers.push_back(std::stod(s));
+        duration = std::stod(options.at("time"));
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error parsing benchmark options: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto sourceFilter = splitList(getOption(options, "source"));
+    const auto targetFilter = splitList(getOption(options, "target"));
+    auto selected = [](const std::vector<std::string> &filter, const std::string &format)
+    {
+        return filter.empty() or std::find(filter.begin(), filter.end(), format) != filter.end();
+    };
+
+    std::vector<BenchResult> results;
+    for (const auto &source : SoapySDR::ConverterRegistry::listAvailableSourceFormats())
+    {
+        if (not selected(sourceFilter, source)) continue;
+        for (const auto &target : SoapySDR::ConverterRegistry::listTargetFormats(source))
+        {
+            if (not selected(targetFilter, target)) continue;
+            const size_t srcSize = SoapySDR::formatToSize(source);
+            const size_t dstSize = SoapySDR::formatToSize(target);
+            if (srcSize == 0 or dstSize == 0) continue;
+
+            for (const auto priority : SoapySDR::ConverterRegistry::listPriorities(source, target))
+            {
+                //the streaming variant is only available through the handle
+                SoapySDR::ConverterRegistry::ConverterFunction streamingFunction(nullptr);
+#ifdef SOAPY_SDR_API_HAS_CONVERTER_STREAMING_STORES
+                const auto *handle = SoapySDR::ConverterRegistry::resolve(
+                    SoapySDR::ConverterRegistry::internFormat(source),
+                    SoapySDR::ConverterRegistry::internFormat(target), priority);
+                if (handle != nullptr) streamingFunction = handle->streamingFunction;
+#endif
+                std::vector<bool> stores(1, false);
+                if (benchStreaming and streamingFunction != nullptr) stores.push_back(true);
+
+                for (const bool streaming : stores)
+                {
+                    const auto function = streaming?streamingFunction:SoapySDR::ConverterRegistry::getFunction(source, target, priority);
+                    std::cerr << "Benchmarking " << source << " -> " << target << " " << priorityName(priority) << (streaming?" streaming":"") << std::endl;
+                    for (const auto bytes : sizes)
+                    {
+                        //the larger of the two buffers has the requested size
+                        const size_t numElems = std::max<size_t>(bytes/std::max(srcSize, dstSize), 1);
+                        for (const auto numThreads : threads)
+                        {
+                            for (const auto scaler : scalers)
+                            {
+                                BenchResult r;
+                                r.source = source;
+                                r.target = target;
+                                r.priority = priority;
+                                r.streaming = streaming;
+                                r.bufferBytes = bytes;
+                                r.numElems = numElems;
+                                r.numThreads = numThreads;
+                                r.scaler = scaler;
+                                r.msps = measureMsps(function, source, target, numElems, numThreads, scaler, duration);
+                                r.gbps = r.msps*(srcSize+dstSize)/1e3;
+                                results.push_back(r);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    const size_t streamingThreshold = findStreamingThreshold(results);
+    if (streamingThreshold != 0) std::cerr << "Streaming stores win from " << streamingThreshold
+        << " bytes, set SOAPY_SDR_CONVERTER_STREAMING_THRESHOLD=" << streamingThreshold << " to apply" << std::endl;
+
+    const auto output = getOption(options, "output");
+    if (output.empty())
+    {
+        writeJSON(std::cout, options, results);
+        return EXIT_SUCCESS;
+    }
+
+    std::ofstream file(output);
+    if (not file)
+    {
+        std::cerr << "Error opening " << output << std::endl;
+        return EXIT_FAILURE;
+    }
+    writeJSON(file, options, results);
+    std::cerr << "Wrote " << results.size() << " results to " << output << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -4,6 +4,7 @@
 #include <SoapySDR/Device.hpp>
 #include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Errors.hpp>
+#include <SoapySDR/StreamBuffers.hpp>
 #include <string>
 #include <cstdlib>
 #include <iostream>
@@ -22,14 +23,13 @@ void runRateTestStreamLoop(
     SoapySDR::Device *device,
     SoapySDR::Stream *stream,
     const int direction,
+    const std::string &format,
     const size_t numChans,
     const size_t elemSize)
 {
-    //allocate buffers for the stream read/write
+    //allocate aligned buffers for the stream read/write
     const size_t numElems = device->getStreamMTU(stream);
-    std::vector<std::vector<char>> buffMem(numChans, std::vector<char>(elemSize*numElems));
-    std::vector<void *> buffs(numChans);
-    for (size_t i = 0; i < numChans; i++) buffs[i] = buffMem[i].data();
+    void **buffs = SoapySDR::allocStreamBuffers(device, stream, direction, format, numChans);
 
     //state collected in this loop
     unsigned int overflows(0);
@@ -52,10 +52,10 @@ void runRateTestStreamLoop(
         switch(direction)
         {
         case SOAPY_SDR_RX:
-            ret = device->readStream(stream, buffs.data(), numElems, flags, timeNs);
+            ret = device->readStream(stream, buffs, numElems, flags, timeNs);
             break;
         case SOAPY_SDR_TX:
-            ret = device->writeStream(stream, buffs.data(), numElems, flags, timeNs);
+            ret = device->writeStream(stream, buffs, numElems, flags, timeNs);
             break;
         }
 
@@ -112,6 +112,7 @@ void runRateTestStreamLoop(
 
     }
     device->deactivateStream(stream);
+    SoapySDR::freeStreamBuffers(buffs);
 }
 
 int SoapySDRRateTest(
@@ -158,7 +159,7 @@ int SoapySDRRateTest(
         std::cout << "Num channels: " << channels.size() << std::endl;
         std::cout << "Element size: " << elemSize << " bytes" << std::endl;
         std::cout << "Begin " << directionStr << " rate test at " << (sampleRate/1e6) << " Msps" << std::endl;
-        runRateTestStreamLoop(device, stream, direction, channels.size(), elemSize);
+        runRateTestStreamLoop(device, stream, direction, format, channels.size(), elemSize);
 
         //cleanup stream and device
         device->closeStream(stream);
@@ -0,0 +1,28 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int SoapySDRConverterBench(const std::string &argStr);
+
+/***********************************************************************
+ * Standalone converter benchmark, same as SoapySDRUtil --bench-converters
+ **********************************************************************/
+int main(int argc, char *argv[])
+{
+    if (argc > 2 or (argc == 2 and (std::string(argv[1]) == "--help" or std::string(argv[1]) == "-h")))
+    {
+        std::cout << "Usage SoapySDRConverterBench [\"key=value, ...\"]" << std::endl;
+        std::cout << "  source=\"CS16 CF32\" \t Source formats, default all" << std::endl;
+        std::cout << "  target=\"CS16 CF32\" \t Target formats, default all" << std::endl;
+        std::cout << "  sizes=\"16K 256K 4M 64M\" \t Buffer sizes in bytes" << std::endl;
+        std::cout << "  threads=\"1 2 4\" \t\t Thread counts, default powers of 2 up to 8" << std::endl;
+        std::cout << "  scalers=\"1.0 0.5\" \t\t Scale factors, default 1.0" << std::endl;
+        std::cout << "  time=0.02 \t\t\t Seconds per measurement" << std::endl;
+        std::cout << "  output=results.json \t\t JSON output file, default stdout" << std::endl;
+        return (argc == 2)?EXIT_SUCCESS:EXIT_FAILURE;
+    }
+    return SoapySDRConverterBench((argc == 2)?argv[1]:"");
+}
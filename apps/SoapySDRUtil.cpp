@@ -32,6 +32,8 @@ int SoapySDRRateTest(
     const std::string &formatStr,
     const std::string &channelStr,
     const std::string &directionStr);
+int SoapySDRConverterBench(const std::string &argStr);
+int SoapySDRStreamRingBench(const std::string &argStr);
 
 /***********************************************************************
  * Print the banner
@@ -72,6 +74,11 @@ static int printHelp(void)
     std::cout << "    --channels[=\"0, 1, 2\"] \t\t List of channels, default 0" << std::endl;
     std::cout << "    --direction[=RX or TX] \t\t Specify the channel direction" << std::endl;
     std::cout << std::endl;
+
+    std::cout << "  Benchmark options:" << std::endl;
+    std::cout << "    --bench-converters[=\"sizes=16K 4M\"] \t Measure converter throughput as JSON" << std::endl;
+    std::cout << "    --bench-stream-ring[=\"buffs=4 16\"] \t Measure stream ring contention as JSON" << std::endl;
+    std::cout << std::endl;
     return EXIT_SUCCESS;
 }
 
@@ -295,6 +302,8 @@ int main(int argc, char *argv[])
     bool makeDeviceFlag(false);
     bool probeDeviceFlag(false);
     bool watchDeviceFlag(false);
+    bool benchConvertersFlag(false);
+    bool benchStreamRingFlag(false);
 
     /*******************************************************************
      * parse command line options
@@ -316,6 +325,9 @@ int main(int argc, char *argv[])
         {"format", optional_argument, nullptr, 't'},
         {"channels", optional_argument, nullptr, 'n'},
         {"direction", optional_argument, nullptr, 'd'},
+
+        {"bench-converters", optional_argument, nullptr, 'B'},
+        {"bench-stream-ring", optional_argument, nullptr, 'R'},
         {nullptr, no_argument, nullptr, '\0'}
     };
     int long_index = 0;
@@ -370,6 +382,14 @@ int main(int argc, char *argv[])
         case 'd':
             if (optarg != nullptr) dirStr = optarg;
             break;
+        case 'B':
+            benchConvertersFlag = true;
+            if (optarg != nullptr) argStr = optarg;
+            break;
+        case 'R':
+            benchStreamRingFlag = true;
+            if (optarg != nullptr) argStr = optarg;
+            break;
         }
     }
 
@@ -381,6 +401,10 @@ int main(int argc, char *argv[])
         argStr = SoapySDR::KwargsToString(args);
     }
 
+    //the benchmarks write JSON to stdout, so they skip the banner
+    if (benchConvertersFlag) return SoapySDRConverterBench(argStr);
+    if (benchStreamRingFlag) return SoapySDRStreamRingBench(argStr);
+
     if (not sparsePrintFlag) printBanner();
     if (not driverName.empty()) return checkDriver(driverName);
     if (findDevicesFlag) return findDevices(argStr, sparsePrintFlag);
@@ -0,0 +1,292 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/Version.hpp>
+#include <SoapySDR/Types.hpp>
+#include <SoapySDR/StreamRing.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************************
+ * Stream ring contention benchmark
+ *
+ * A producer thread passes buffers to a consumer thread as fast as
+ * possible, like a driver callback thread feeding readStream().
+ * The StreamRing is measured against the mutex and condition variable
+ * queue that drivers usually implement, with the same acquire/release
+ * calls. Each buffer is stamped with the time of its release, so the
+ * hand-off latency is reported next to the throughput.
+ * Results are emitted as JSON like --bench-converters.
+ **********************************************************************/
+struct RingBenchResult
+{
+    std::string queue;
+    size_t numBuffs;
+    size_t buffSize;
+    double buffsPerSec;
+    double gbps;
+    double latencyMedianUs;
+    double latencyP99Us;
+};
+
+//! The usual driver queue: a mutex and condition variables around the buffer indexes
+class MutexQueue
+{
+public:
+    MutexQueue(const size_t numBuffs, const size_t buffSize):
+        _buffSize(buffSize),
+        _storage(numBuffs*buffSize),
+        _slots(numBuffs)
+    {
+        for (size_t i = 0; i < numBuffs; i++) _free.push_back(i);
+    }
+
+    int acquireWriteBuffer(size_t &handle, void **buffs, const long timeoutUs)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (not _freeCond.wait_for(lock, std::chrono::microseconds(timeoutUs), [this]{return not _free.empty();})) return SOAPY_SDR_TIMEOUT;
+        handle = _free.front();
+        _free.pop_front();
+        buffs[0] = _storage.data() + handle*_buffSize;
+        return int(_buffSize);
+    }
+
+    void releaseWriteBuffer(const size_t handle, const size_t numElems, const int flags, const long long timeNs)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _slots[handle].numElems = numElems;
+        _slots[handle].flags = flags;
+        _slots[handle].timeNs = timeNs;
+        _ready.push_back(handle);
+        _readyCond.notify_one();
+    }
+
+    int acquireReadBuffer(size_t &handle, const void **buffs, int &flags, long long &timeNs, const long timeoutUs)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (not _readyCond.wait_for(lock, std::chrono::microseconds(timeoutUs), [this]{return not _ready.empty();})) return SOAPY_SDR_TIMEOUT;
+        handle = _ready.front();
+        _ready.pop_front();
+        buffs[0] = _storage.data() + handle*_buffSize;
+        flags = _slots[handle].flags;
+        timeNs = _slots[handle].timeNs;
+        return int(_slots[handle].numElems);
+    }
+
+    void releaseReadBuffer(const size_t handle)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _free.push_back(handle);
+        _freeCond.notify_one();
+    }
+
+private:
+    struct Slot
+    {
+        size_t numElems;
+        int flags;
+        long long timeNs;
+    };
+    const size_t _buffSize;
+    std::vector<char> _storage;
+    std::vector<Slot> _slots;
+    std::deque<size_t> _free, _ready;
+    std::mutex _mutex;
+    std::condition_variable _freeCond, _readyCond;
+};
+
+//! The consumer sums the buffers into the sink so the reads are not optimized out
+static volatile unsigned benchSink;
+
+static long long nowNs(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//! Pass buffers from a producer thread to the calling thread for the duration
+template <typename Queue>
+static void measureQueue(Queue &queue, RingBenchResult &r, const double duration, const bool touch)
+{
+    std::atomic<bool> done(false);
+    std::thread producer([&]()
+    {
+        size_t handle(0);
+        void *buffs[1];
+        while (not done)
+        {
+            if (queue.acquireWriteBuffer(handle, buffs, 10000) < 0) continue;
+            if (touch) std::memset(buffs[0], int(handle), r.buffSize);
+            queue.releaseWriteBuffer(handle, r.buffSize, 0, nowNs());
+        }
+    });
+
+    size_t handle(0), numBuffs(0);
+    const void *buffs[1];
+    int flags(0);
+    long long timeNs(0);
+    unsigned sum(0);
+    std::vector<long long> latencies;
+    latencies.reserve(1 << 20);
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto exitTime = t0 + std::chrono::duration<double>(duration);
+    while (std::chrono::steady_clock::now() < exitTime)
+    {
+        if (queue.acquireReadBuffer(handle, buffs, flags, timeNs, 10000) < 0) continue;
+        if (latencies.size() < latencies.capacity()) latencies.push_back(nowNs() - timeNs);
+        if (touch) for (size_t i = 0; i < r.buffSize; i += sizeof(unsigned)) sum += *(const unsigned *)((const char *)buffs[0] + i);
+        queue.releaseReadBuffer(handle);
+        numBuffs++;
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t0;
+
+    //drain so the producer can observe the done flag
+    done = true;
+    while (queue.acquireReadBuffer(handle, buffs, flags, timeNs, 10000) >= 0) queue.releaseReadBuffer(handle);
+    producer.join();
+    benchSink = sum;
+
+    r.buffsPerSec = numBuffs/elapsed.count();
+    r.gbps = r.buffsPerSec*r.buffSize/1e9;
+    r.latencyMedianUs = 0.0;
+    r.latencyP99Us = 0.0;
+    if (latencies.empty()) return;
+    std::sort(latencies.begin(), latencies.end());
+    r.latencyMedianUs = latencies[latencies.size()/2]/1e3;
+    r.latencyP99Us = latencies[(latencies.size()*99)/100]/1e3;
+}
+
+static std::vector<std::string> splitList(const std::string &list)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (ss >> item) items.push_back(item);
+    return items;
+}
+
+static size_t parseBytes(const std::string &str)
+{
+    size_t pos(0);
+    const size_t num = std::stoul(str, &pos);
+    const std::string suffix = str.substr(pos);
+    if (suffix.empty()) return num;
+    if (suffix == "K" or suffix == "k") return num << 10;
+    if (suffix == "M" or suffix == "m") return num << 20;
+    throw std::invalid_argument("bad size suffix: " + str);
+}
+
+static void writeJSON(std::ostream &os, const SoapySDR::Kwargs &options, const std::vector<RingBenchResult> &results)
+{
+    os << "{" << std::endl;
+    os << "  \"libVersion\": \"" << SoapySDR::getLibVersion() << "\"," << std::endl;
+    os << "  \"hardwareConcurrency\": " << std::thread::hardware_concurrency() << "," << std::endl;
+    os << "  \"options\": {";
+    bool first(true);
+    for (const auto &pair : options)
+    {
+        os << (first?"":", ") << "\"" << pair.first << "\": \"" << pair.second << "\"";
+        first = false;
+    }
+    os << "}," << std::endl;
+    os << "  \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const auto &r = results[i];
+        os << "    {\"queue\": \"" << r.queue << "\""
+           << ", \"numBuffs\": " << r.numBuffs
+           << ", \"buffSize\": " << r.buffSize
+           << ", \"buffsPerSec\": " << r.buffsPerSec
+           << ", \"gbps\": " << r.gbps
+           << ", \"latencyMedianUs\": " << r.latencyMedianUs
+           << ", \"latencyP99Us\": " << r.latencyP99Us << "}"
+           << ((i+1 == results.size())?"":",") << std::endl;
+    }
+    os << "  ]" << std::endl;
+    os << "}" << std::endl;
+}
+
+/***********************************************************************
+ * Benchmark entry point, options are key=value markup:
+ *  - buffs: space separated ring depths (default "4 16 64")
+ *  - sizes: space separated buffer sizes in bytes with K/M suffix
+ *  - time: seconds to measure each configuration (default 0.2)
+ *  - touch: write and read every buffer byte (default true)
+ *  - output: JSON file path (default stdout)
+ **********************************************************************/
+int SoapySDRStreamRingBench(const std::string &argStr)
+{
+    SoapySDR::Kwargs options = SoapySDR::KwargsFromString(argStr);
+    if (options.count("buffs") == 0) options["buffs"] = "4 16 64";
+    if (options.count("sizes") == 0) options["sizes"] = "256 4K 64K";
+    if (options.count("time") == 0) options["time"] = "0.2";
+    if (options.count("touch") == 0) options["touch"] = "true";
+
+    std::vector<size_t> depths, sizes;
+    double duration(0.0);
+    bool touch(true);
+    try
+    {
+        for (const auto &s : splitList(options.at("buffs"))) depths.push_back(std::max<size_t>(std::stoul(s), 1));
+        for (const auto &s : splitList(options.at("sizes"))) sizes.push_back(std::max<size_t>(parseBytes(s), sizeof(unsigned)));
+        duration = std::stod(options.at("time"));
+        touch = SoapySDR::StringToSetting<bool>(options.at("touch"));
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "Error parsing benchmark options: " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<RingBenchResult> results;
+    for (const auto depth : depths)
+    {
+        for (const auto size : sizes)
+        {
+            std::cerr << "Benchmarking " << depth << " x " << size << " bytes" << std::endl;
+            RingBenchResult r;
+            r.numBuffs = depth;
+            r.buffSize = size;
+
+            r.queue = "mutex";
+            MutexQueue mutexQueue(depth, size);
+            measureQueue(mutexQueue, r, duration, touch);
+            results.push_back(r);
+
+            r.queue = "ring";
+            SoapySDR::StreamRing ring(depth, size, 1);
+            measureQueue(ring, r, duration, touch);
+            results.push_back(r);
+        }
+    }
+
+    const auto it = options.find("output");
+    if (it == options.end() or it->second.empty())
+    {
+        writeJSON(std::cout, options, results);
+        return EXIT_SUCCESS;
+    }
+
+    std::ofstream file(it->second);
+    if (not file)
+    {
+        std::cerr << "Error opening " << it->second << std::endl;
+        return EXIT_FAILURE;
+    }
+    writeJSON(file, options, results);
+    std::cerr << "Wrote " << results.size() << " results to " << it->second << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -10,6 +10,7 @@
 
 #pragma once
 #include <stdint.h>
+#include <limits>
 
 namespace SoapySDR
 {
@@ -28,7 +29,25 @@ const uint8_t   S8_FULL_SCALE =  uint8_t(1<<7);
  * \return the converted value
  */
 
-// type conversion: float <> signed integers
+// saturation: clip a scaled value to the range of an integer type,
+// not-a-number converts to zero in the scalar and vectorized converters
+
+template <typename T, typename R>
+inline T SaturateInt(const R from){
+  if (from >= R(std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+  if (from <= R(std::numeric_limits<T>::min())) return std::numeric_limits<T>::min();
+  return (from == from)?T(from):T(0);
+}
+
+inline int16_t SaturateS16(double from){
+  return SaturateInt<int16_t>(from);
+}
+
+inline int8_t SaturateS8(double from){
+  return SaturateInt<int8_t>(from);
+}
+
+// type conversion: float <> signed integers (16 and 8 bit saturate at full scale)
 
 inline int32_t F32toS32(float from){
   return int32_t(from * S32_FULL_SCALE);
@@ -38,14 +57,14 @@ inline float S32toF32(int32_t from){
 }
 
 inline int16_t F32toS16(float from){
-  return int16_t(from * S16_FULL_SCALE);
+  return SaturateS16(from * S16_FULL_SCALE);
 }
 inline float S16toF32(int16_t from){
   return float(from) / S16_FULL_SCALE;
 }
 
 inline int8_t F32toS8(float from){
-  return int8_t(from * S8_FULL_SCALE);
+  return SaturateS8(from * S8_FULL_SCALE);
 }
 inline float S8toF32(int8_t from){
   return float(from) / S8_FULL_SCALE;
@@ -150,4 +169,32 @@ inline int8_t U16toS8(uint16_t from){
 }
 
 
+// packed complex formats: 12-bit <> 16-bit and 4-bit <> 8-bit integers
+//
+// CS12 packs I and Q into 3 bytes: I[7:0], Q[3:0] I[11:8], Q[11:4].
+// CS4 packs I and Q into 1 byte: Q[3:0] I[3:0].
+// The packed values occupy the most significant bits of the wider type,
+// so the conversions preserve the full scale of the samples.
+
+inline void CS12toCS16(const uint8_t *from, int16_t *to){
+  to[0] = int16_t(uint16_t(uint16_t(from[1]) << 12) | uint16_t(uint16_t(from[0]) << 4));
+  to[1] = int16_t(uint16_t(uint16_t(from[2]) << 8) | uint16_t(from[1] & 0xf0));
+}
+inline void CS16toCS12(const int16_t *from, uint8_t *to){
+  const uint16_t i = uint16_t(from[0]);
+  const uint16_t q = uint16_t(from[1]);
+  to[0] = uint8_t(i >> 4);
+  to[1] = uint8_t((q & 0xf0) | (i >> 12));
+  to[2] = uint8_t(q >> 8);
+}
+
+inline void CS4toCS8(const uint8_t from, int8_t *to){
+  to[0] = int8_t(uint8_t(from << 4));
+  to[1] = int8_t(uint8_t(from & 0xf0));
+}
+inline uint8_t CS8toCS4(const int8_t *from){
+  return uint8_t((uint8_t(from[0]) >> 4) | (uint8_t(from[1]) & 0xf0));
+}
+
+
 }
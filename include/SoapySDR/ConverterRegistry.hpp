@@ -14,6 +14,9 @@
 #include <SoapySDR/Logger.hpp>
 #include <SoapySDR/Formats.hpp>
 #include <utility>
+#include <complex>
+#include <cstddef>
+#include <stdint.h>
 #include <vector>
 #include <map>
 #include <string>
@@ -29,6 +32,10 @@ namespace SoapySDR
    * custom formats can be created and ConverterFunctions registered to be used as needed.
    * Additionally, different functions can be registered for the same source/target pair
    * with FunctionPriority serving as a selector to allow specialization.
+   *
+   * The registry is thread-safe. Registrations are serialized and published
+   * as an immutable snapshot, so queries and resolve() never block on a lock
+   * and may run concurrently with modules registering new converters.
    */
   class SOAPY_SDR_API ConverterRegistry
   {
@@ -38,9 +45,117 @@ namespace SoapySDR
      * A converter function copies and optionally converts an input buffer of one format into an
      * output buffer of another format.
      * The parameters are (input pointer, output pointer, number of elements, optional scalar)
+     * The buffers must not overlap, unless the converter is registered as in-place safe:
+     * then the input and output pointers may be the same buffer.
      */
     typedef void (*ConverterFunction)(const void *, void *, const size_t, const double);
 
+    /*!
+     * A typedef for declaring a batch-native BatchConverterFunction.
+     * A batch converter function converts an array of channel buffers in a single call,
+     * using the same buffer layout as Device::readStream() and Device::writeStream().
+     * The parameters are (input buffers, output buffers, number of channels,
+     * number of elements per channel, optional scalar)
+     */
+    typedef void (*BatchConverterFunction)(const void * const *, void * const *, const size_t, const size_t, const double);
+
+    /*!
+     * A typedef for declaring a clip-counting ClipConverterFunction.
+     * A clip converter saturates out of range samples to the target range,
+     * and returns the number of samples that were clipped, so headroom can be
+     * monitored without another pass over the buffer.
+     * The parameters are the same as ConverterFunction.
+     */
+    typedef size_t (*ClipConverterFunction)(const void *, void *, const size_t, const double);
+
+    /*!
+     * IQCorrection: DC offset removal and IQ balance correction applied by a
+     * correction converter, using the same complex values as Device::setDCOffset()
+     * and Device::setIQBalance(). With x the converted and scaled sample and
+     * x' = x - dcOffset, the output is y = x' + iqBalance * conj(x').
+     *
+     * When dcTracking is non-zero, the converter estimates the DC offset itself,
+     * emulating Device::setDCOffsetMode(true): dcOffset tracks x with a single-pole IIR
+     * of per-sample coefficient dcTracking, updated from the mean of each block of 64 samples.
+     * The converter updates dcOffset in place, so a stream passes the same struct on every call.
+     */
+    struct IQCorrection
+    {
+      IQCorrection(void):
+        dcTracking(0.0)
+      {
+        return;
+      }
+
+      //! The DC offset subtracted from each converted sample
+      std::complex<double> dcOffset;
+
+      //! The IQ balance correction factor (0 for no correction)
+      std::complex<double> iqBalance;
+
+      //! The IIR coefficient of the DC tracker in (0, 1), or 0 for a fixed dcOffset
+      double dcTracking;
+    };
+
+    /*!
+     * A typedef for declaring a CorrectionConverterFunction.
+     * A correction converter converts a complex input buffer into an output buffer
+     * and applies the IQCorrection in the same pass over the samples.
+     * The parameters are (input pointer, output pointer, number of elements, optional scalar, correction state).
+     * The pointer parameter gives the function the same type as SoapySDRCorrectionConverterFunction.
+     */
+    typedef void (*CorrectionConverterFunction)(const void *, void *, const size_t, const double, IQCorrection *);
+
+    /*!
+     * ConverterStats: signal level statistics accumulated by a stats converter.
+     * Levels are measured on the floating point side of the conversion in
+     * normalized units, so 1.0 is full scale of the integer format: the output
+     * samples for integer to float, and the scaled input samples for float to integer.
+     * Each call adds to the counters, so use one struct per channel and
+     * reset it with a default constructed struct at the start of each metering period.
+     */
+    struct ConverterStats
+    {
+      ConverterStats(void):
+        numElems(0),
+        sumSquares(0.0),
+        peakMagnitude(0.0),
+        numClipped(0)
+      {
+        return;
+      }
+
+      //! The number of complex elements accumulated
+      size_t numElems;
+
+      //! The sum of the squared magnitudes |I + jQ|^2
+      double sumSquares;
+
+      //! The largest magnitude |I + jQ|
+      double peakMagnitude;
+
+      /*!
+       * The number of saturated I or Q samples: samples at the rails of the
+       * integer source format, or samples clipped to the integer target format.
+       */
+      size_t numClipped;
+
+      //! The mean power, or 0.0 when no elements were accumulated
+      double meanPower(void) const
+      {
+        return (numElems == 0)?0.0:(sumSquares/numElems);
+      }
+    };
+
+    /*!
+     * A typedef for declaring a StatsConverterFunction.
+     * A stats converter converts a complex input buffer into an output buffer
+     * and accumulates ConverterStats in the same pass over the samples.
+     * The parameters are (input pointer, output pointer, number of elements, optional scalar, statistics).
+     * The pointer parameter gives the function the same type as SoapySDRStatsConverterFunction.
+     */
+    typedef void (*StatsConverterFunction)(const void *, void *, const size_t, const double, ConverterStats *);
+
     /*!
      * FunctionPriority: allow selection of a converter function with a given source and target format.
      */
@@ -50,6 +165,27 @@ namespace SoapySDR
       CUSTOM = 5            //!< Custom user re-implementation. Max priority.
     };
 
+    /*!
+     * ChannelLayout: how a channel converter maps between one interleaved buffer
+     * and per-channel buffers. A channel converter is a BatchConverterFunction
+     * where the interleaved side uses only the first buffer of its array.
+     */
+    enum ChannelLayout{
+      DEINTERLEAVE = 0,     //!< One interleaved source buffer to numChans target buffers (RX)
+      INTERLEAVE = 1        //!< numChans source buffers to one interleaved target buffer (TX)
+    };
+
+    /*!
+     * StoreMode: how a converter handle writes the target buffer.
+     * Streaming stores are non-temporal: the output bypasses the cache,
+     * so converting large buffers does not evict the working set of other threads.
+     */
+    enum StoreMode{
+      AUTO_STORES = 0,      //!< Streaming stores when the target buffer is at least getStreamingThreshold() bytes
+      CACHED_STORES = 1,    //!< Always write through the cache
+      STREAMING_STORES = 2  //!< Always use the streaming converter when available
+    };
+
     /*!
      * TargetFormatConverterPriority: a map of possible conversion functions for a given Priority.
      * Maintained by the registry.
@@ -68,6 +204,83 @@ namespace SoapySDR
      */
     typedef std::map<std::string, TargetFormatConverters> FormatConverters;
 
+    /*!
+     * FormatId: a compact identifier for an interned format markup string.
+     * Identifiers are assigned by internFormat() and remain valid for the process lifetime.
+     */
+    typedef uint32_t FormatId;
+
+    //! An invalid FormatId, never returned by internFormat()
+    static const FormatId INVALID_FORMAT_ID = FormatId(~0u);
+
+    /*!
+     * ConverterHandle: a resolved converter for a source/target format pair.
+     * Handles are immutable, occupy a single cache line, and are owned by the registry.
+     * A handle remains valid for the process lifetime; however, converters registered
+     * after resolution are only visible by resolving a new handle.
+     */
+    struct alignas(64) ConverterHandle
+    {
+      //! The resolved converter function
+      ConverterFunction function;
+
+      //! The batch-native converter function or nullptr when not registered
+      BatchConverterFunction batchFunction;
+
+      //! The size in bytes of one source element
+      size_t sourceElemSize;
+
+      //! The size in bytes of one target element
+      size_t targetElemSize;
+
+      //! The priority of the resolved converter function
+      FunctionPriority priority;
+
+      //! The interned source format
+      FormatId sourceFormat;
+
+      //! The interned target format
+      FormatId targetFormat;
+
+      /*!
+       * True when the converter functions of this handle accept the same
+       * buffer as the source and the target. Partially overlapping buffers
+       * are never supported. The built-in converters are in-place safe
+       * when the target element is not larger than the source element.
+       */
+      bool inPlaceSafe;
+
+      /*!
+       * The clip-counting converter function or nullptr when not available.
+       * When registered without one, a handle uses the clip converter
+       * of the highest lower priority handle for the same formats.
+       */
+      ClipConverterFunction clipFunction;
+
+      /*!
+       * The converter function with non-temporal stores or nullptr when not available.
+       * It produces the same output as function. Call either function directly
+       * to fix the store mode for every conversion with this handle.
+       */
+      ConverterFunction streamingFunction;
+
+      //! Convert numElems from the source to the target buffer with AUTO_STORES
+      void operator()(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler = 1.0) const
+      {
+        (*this)(srcBuff, dstBuff, numElems, scaler, AUTO_STORES);
+      }
+
+      //! Convert numElems from the source to the target buffer with the given StoreMode
+      void operator()(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler, const StoreMode mode) const
+      {
+        const bool streaming = streamingFunction != nullptr and mode != CACHED_STORES and
+          (mode == STREAMING_STORES or numElems*targetElemSize >= getStreamingThreshold());
+        (streaming?streamingFunction:function)(srcBuff, dstBuff, numElems, scaler);
+      }
+    };
+
+    struct ConverterPath;
+
     /*!
      * Class constructor. Registers a ConverterFunction with a
      * given source format, target format, and priority.
@@ -79,7 +292,101 @@ namespace SoapySDR
      * \param converter function to register
      */
     ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority, ConverterFunction converter);
-    
+
+    /*!
+     * ConverterDescriptor: the functions of one converter registration.
+     * Every member except function is optional and defaults to nullptr or false,
+     * so a registration sets only the functions it implements:
+     * \code
+     * SoapySDR::ConverterRegistry::ConverterDescriptor desc;
+     * desc.function = &myConverter;
+     * desc.clipFunction = &myClipConverter;
+     * SoapySDR::ConverterRegistry(SOAPY_SDR_CF32, SOAPY_SDR_CS16, SoapySDR::ConverterRegistry::CUSTOM, desc);
+     * \endcode
+     */
+    struct ConverterDescriptor
+    {
+      ConverterDescriptor(void):
+        function(nullptr),
+        batchFunction(nullptr),
+        clipFunction(nullptr),
+        streamingFunction(nullptr),
+        inPlaceSafe(false)
+      {
+        return;
+      }
+
+      //! The converter function (required)
+      ConverterFunction function;
+
+      //! The batch-native function used by convertChannels(), or nullptr
+      BatchConverterFunction batchFunction;
+
+      //! The clip-counting function, or nullptr; it must produce the same output as function
+      ClipConverterFunction clipFunction;
+
+      /*!
+       * The function with non-temporal stores, or nullptr.
+       * It must produce the same output as function,
+       * and is selected by ConverterHandle for large buffers.
+       */
+      ConverterFunction streamingFunction;
+
+      //! True when the converter and clip-counting functions support in-place conversion
+      bool inPlaceSafe;
+    };
+
+    /*!
+     * Class constructor. Registers the functions of a ConverterDescriptor
+     * with a given source format, target format, and priority.
+     *
+     * refuses to register converter and logs error if a source/target/priority entry already exists
+     * or when the descriptor has no converter function
+     * \param sourceFormat the source format markup string
+     * \param targetFormat the target format markup string
+     * \param priority the FunctionPriority of the converter to register
+     * \param descriptor the converter functions to register
+     */
+    ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority, const ConverterDescriptor &descriptor);
+
+    /*!
+     * Class constructor. Registers a channel converter that fuses format conversion
+     * with an N-way deinterleave or interleave of the given ChannelLayout.
+     * The converter must support any number of channels.
+     *
+     * refuses to register converter and logs error if a source/target/layout/priority entry already exists
+     * \param sourceFormat the source format markup string
+     * \param targetFormat the target format markup string
+     * \param layout the ChannelLayout of the converter
+     * \param priority the FunctionPriority of the converter to register
+     * \param converter function to register
+     */
+    ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const ChannelLayout &layout, const FunctionPriority &priority, BatchConverterFunction converter);
+
+    /*!
+     * Class constructor. Registers a CorrectionConverterFunction with a
+     * given source format, target format, and priority.
+     *
+     * refuses to register converter and logs error if a source/target/priority entry already exists
+     * \param sourceFormat the source format markup string
+     * \param targetFormat the target format markup string
+     * \param priority the FunctionPriority of the converter to register
+     * \param converter function to register
+     */
+    ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority, CorrectionConverterFunction converter);
+
+    /*!
+     * Class constructor. Registers a StatsConverterFunction with a
+     * given source format, target format, and priority.
+     *
+     * refuses to register converter and logs error if a source/target/priority entry already exists
+     * \param sourceFormat the source format markup string
+     * \param targetFormat the target format markup string
+     * \param priority the FunctionPriority of the converter to register
+     * \param converter function to register
+     */
+    ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority, StatsConverterFunction converter);
+
     /*!
      * Get a list of existing target formats to which we can convert the specified source from.
      * There is a source format converter function registered for each target format
@@ -126,6 +433,230 @@ namespace SoapySDR
      */
     static std::vector<std::string> listAvailableSourceFormats(void);
 
+    /*!
+     * Get a list of available channel converter priorities for a given source and target format.
+     * \param sourceFormat the source format markup string
+     * \param targetFormat the target format markup string
+     * \param layout the ChannelLayout of the converter
+     * \return a vector of priorities or an empty vector if none found
+     */
+    static std::vector<FunctionPriority> listPriorities(const std::string &sourceFormat, const std::string &targetFormat, const ChannelLayout &layout);
+
+    /*!
+     * Get a channel converter between a source and target format with the highest available priority.
+     * \throws runtime_error when the conversion does not exist
+     * \param sourceFormat the source format markup string
+     * \param targetFormat the target format markup string
+     * \param layout the ChannelLayout of the converter
+     * \return a conversion function pointer
+     */
+    static BatchConverterFunction getFunction(const std::string &sourceFormat, const std::string &targetFormat, const ChannelLayout &layout);
+
+    /*!
+     * Get a channel converter between a source and target format with a given priority.
+     * \throws runtime_error when the conversion does not exist
+     */
+    static BatchConverterFunction getFunction(const std::string &sourceFormat, const std::string &targetFormat, const ChannelLayout &layout, const FunctionPriority &priority);
+
+    /*!
+     * Get a list of available correction converter priorities for a given source and target format.
+     * \param sourceFormat the source format markup string
+     * \param targetFormat the target format markup string
+     * \return a vector of priorities or an empty vector if none found
+     */
+    static std::vector<FunctionPriority> listCorrectionPriorities(const std::string &sourceFormat, const std::string &targetFormat);
+
+    /*!
+     * Get a correction converter between a source and target format with the highest available priority.
+     * \throws runtime_error when the conversion does not exist
+     * \param sourceFormat the source format markup string
+     * \param targetFormat the target format markup string
+     * \return a conversion function pointer
+     */
+    static CorrectionConverterFunction getCorrectionFunction(const std::string &sourceFormat, const std::string &targetFormat);
+
+    /*!
+     * Get a correction converter between a source and target format with a given priority.
+     * \throws runtime_error when the conversion does not exist
+     */
+    static CorrectionConverterFunction getCorrectionFunction(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority);
+
+    /*!
+     * Get a list of available stats converter priorities for a given source and target format.
+     * \param sourceFormat the source format markup string
+     * \param targetFormat the target format markup string
+     * \return a vector of priorities or an empty vector if none found
+     */
+    static std::vector<FunctionPriority> listStatsPriorities(const std::string &sourceFormat, const std::string &targetFormat);
+
+    /*!
+     * Get a stats converter between a source and target format with the highest available priority.
+     * \throws runtime_error when the conversion does not exist
+     * \param sourceFormat the source format markup string
+     * \param targetFormat the target format markup string
+     * \return a conversion function pointer
+     */
+    static StatsConverterFunction getStatsFunction(const std::string &sourceFormat, const std::string &targetFormat);
+
+    /*!
+     * Get a stats converter between a source and target format with a given priority.
+     * \throws runtime_error when the conversion does not exist
+     */
+    static StatsConverterFunction getStatsFunction(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority);
+
+    /*!
+     * Intern a format markup string into a compact identifier.
+     * The same format string always yields the same identifier.
+     * Call once when a stream is configured, and use the identifier with resolve().
+     * \param format the format markup string
+     * \return the identifier for the format
+     */
+    static FormatId internFormat(const std::string &format);
+
+    /*!
+     * Get the format markup string for an interned identifier.
+     * \param formatId an identifier returned by internFormat()
+     * \return the format markup string or empty string for an unknown identifier
+     */
+    static std::string getFormatString(const FormatId formatId);
+
+    /*!
+     * Resolve the converter with the highest available priority.
+     * The lookup is constant time, does not allocate, and does not throw.
+     * When auto-tuning is enabled and the pair was tuned by tune() or getFunction(),
+     * the tuned converter is returned instead. Resolution never tunes a pair.
+     * \param sourceFormat the interned source format
+     * \param targetFormat the interned target format
+     * \return a pointer to the converter handle or nullptr if none is registered
+     */
+    static const ConverterHandle *resolve(const FormatId sourceFormat, const FormatId targetFormat) noexcept;
+
+    /*!
+     * Resolve the converter with a given priority.
+     * The lookup does not allocate and does not throw.
+     * \param sourceFormat the interned source format
+     * \param targetFormat the interned target format
+     * \param priority the FunctionPriority of the converter
+     * \return a pointer to the converter handle or nullptr if none is registered
+     */
+    static const ConverterHandle *resolve(const FormatId sourceFormat, const FormatId targetFormat, const FunctionPriority &priority) noexcept;
+
+    /*!
+     * Select the fastest registered priority of a pair on this CPU.
+     * Each priority is timed on representative buffer sizes unless the tuning cache
+     * has a choice for the pair, and the choice is stored in the tuning cache file.
+     * Later calls return the stored choice without measuring again.
+     * Call when a stream is configured, not from the streaming thread:
+     * tuning allocates and may take a while.
+     * \param sourceFormat the interned source format
+     * \param targetFormat the interned target format
+     * \return a pointer to the tuned converter handle or nullptr if none is registered
+     */
+    static const ConverterHandle *tune(const FormatId sourceFormat, const FormatId targetFormat);
+
+    /*!
+     * Convert multiple channel buffers with a resolved converter.
+     * The buffer arrays have the same layout as Device::readStream() and Device::writeStream(),
+     * so the stream buffer arrays can be passed in directly.
+     * The handle's batch-native function is used when one was registered,
+     * otherwise the converter function is called once per channel.
+     * \param handle a resolved converter handle
+     * \param srcBuffs an array of numChans source buffers
+     * \param dstBuffs an array of numChans target buffers
+     * \param numChans the number of channels
+     * \param numElems the number of elements in each channel buffer
+     * \param scaler the scale factor passed to the converter
+     * \param numThreads spread channels across up to this many threads (1 uses only the calling thread)
+     */
+    static void convertChannels(const ConverterHandle &handle, const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler = 1.0, const size_t numThreads = 1);
+
+    /*!
+     * Resolve the cheapest chain of converters between two formats.
+     * Formats are the nodes of a graph and registered converters are its edges.
+     * The cost of a converter is measured when auto-tuning is enabled,
+     * otherwise it is declared by the bytes per element and the priority.
+     * Intermediate formats never have less precision than the source or target,
+     * and a registered direct converter is returned as a path with a single hop.
+     * \param sourceFormat the interned source format
+     * \param targetFormat the interned target format
+     * \return a pointer to the path or nullptr if the formats are not connected
+     */
+    static const ConverterPath *resolvePath(const FormatId sourceFormat, const FormatId targetFormat);
+
+    /*!
+     * Convert a buffer through a resolved path of converters.
+     * Intermediate formats are converted in blocks through a per-thread scratch buffer,
+     * so the intermediate data stays in the L1/L2 cache. The scale factor is applied once.
+     * \param path a resolved converter path
+     * \param srcBuff the source buffer
+     * \param dstBuff the target buffer
+     * \param numElems the number of elements to convert
+     * \param scaler the scale factor
+     */
+    static void convertPath(const ConverterPath &path, const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler = 1.0);
+
+    /*!
+     * ConverterPath: a chain of converters from a source to a target format,
+     * returned by resolvePath(). Paths are immutable, owned by the registry,
+     * and remain valid for the process lifetime.
+     */
+    struct ConverterPath
+    {
+      //! The converter of each hop from the source to the target format
+      std::vector<const ConverterHandle *> hops;
+
+      //! The index of the hop that applies the scale factor
+      size_t scalerHop;
+
+      //! The number of elements converted per block through the scratch buffer
+      size_t blockElems;
+
+      //! The total cost used to select this path
+      double cost;
+
+      //! Convert numElems from the source to the target buffer
+      void operator()(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler = 1.0) const
+      {
+        convertPath(*this, srcBuff, dstBuff, numElems, scaler);
+      }
+    };
+
+    /*!
+     * Enable or disable auto-tuning of the converter priority.
+     * When enabled, getFunction(sourceFormat, targetFormat) and resolve(sourceFormat, targetFormat)
+     * select the fastest registered priority on this CPU instead of the highest one.
+     * getFunction() tunes a pair on first use, while resolve() only returns
+     * the choice of a pair that was already tuned, see tune().
+     * The choices are stored in the tuning cache file, so later processes start tuned.
+     * Auto-tuning is disabled unless the SOAPY_SDR_CONVERTER_TUNING environment variable is set to true.
+     * \param enable true to enable auto-tuning
+     */
+    static void setAutoTuning(const bool enable);
+
+    //! Is auto-tuning of the converter priority enabled?
+    static bool getAutoTuning(void);
+
+    /*!
+     * Get the path of the tuning cache file.
+     * The file name is keyed by the CPU model and the library and module versions.
+     * The directory is SOAPY_SDR_CONVERTER_TUNING_CACHE when set,
+     * otherwise the user cache directory (XDG_CACHE_HOME, ~/.cache, or LOCALAPPDATA) + "/SoapySDR".
+     * \return the file path or empty string when there is no cache directory
+     */
+    static std::string getTuningCachePath(void);
+
+    /*!
+     * Set the target buffer size at which ConverterHandle switches to streaming stores.
+     * The default is three quarters of the last level cache, or the value of the
+     * SOAPY_SDR_CONVERTER_STREAMING_THRESHOLD environment variable in bytes when set.
+     * The crossover for this machine is reported by SoapySDRUtil --bench-converters.
+     * \param numBytes the threshold in bytes of the target buffer
+     */
+    static void setStreamingThreshold(const size_t numBytes);
+
+    //! Get the target buffer size in bytes at which ConverterHandle switches to streaming stores
+    static size_t getStreamingThreshold(void);
+
   };
   
 }
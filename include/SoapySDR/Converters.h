@@ -13,6 +13,8 @@
 #include <SoapySDR/Errors.h>
 #include <SoapySDR/Types.h>
 #include <SoapySDR/Constants.h>
+#include <stddef.h> //size_t
+#include <stdint.h> //uint32_t
 
 /*!
  * A typedef for declaring a ConverterFunction to be maintained in the ConverterRegistry.
@@ -22,6 +24,23 @@
  */
 typedef void (*SoapySDRConverterFunction)(const void *, void *, const size_t, const double);
 
+/*!
+ * A typedef for declaring a batch-native converter function.
+ * A batch converter function converts an array of channel buffers in a single call,
+ * using the same buffer layout as SoapySDRDevice_readStream() and SoapySDRDevice_writeStream().
+ * The parameters are (input buffers, output buffers, number of channels,
+ * number of elements per channel, optional scalar)
+ */
+typedef void (*SoapySDRBatchConverterFunction)(const void * const *, void * const *, const size_t, const size_t, const double);
+
+/*!
+ * A typedef for declaring a clip-counting converter function.
+ * A clip converter saturates out of range samples to the target range,
+ * and returns the number of samples that were clipped.
+ * The parameters are the same as SoapySDRConverterFunction.
+ */
+typedef size_t (*SoapySDRClipConverterFunction)(const void *, void *, const size_t, const double);
+
 /*!
  * Allow selection of a converter function with a given source and target format.
  */
@@ -37,6 +56,123 @@ typedef enum
     SOAPY_SDR_CONVERTER_CUSTOM = 5
 } SoapySDRConverterFunctionPriority;
 
+/*!
+ * How a channel converter maps between one interleaved buffer and per-channel buffers.
+ */
+typedef enum
+{
+    //! One interleaved source buffer to numChans target buffers (RX)
+    SOAPY_SDR_CONVERTER_DEINTERLEAVE = 0,
+
+    //! numChans source buffers to one interleaved target buffer (TX)
+    SOAPY_SDR_CONVERTER_INTERLEAVE = 1
+} SoapySDRConverterChannelLayout;
+
+/*!
+ * A compact identifier for an interned format markup string.
+ */
+typedef uint32_t SoapySDRConverterFormatId;
+
+//! An invalid format identifier, never returned by SoapySDRConverter_internFormat()
+#define SOAPY_SDR_CONVERTER_INVALID_FORMAT_ID ((SoapySDRConverterFormatId)0xffffffff)
+
+/*!
+ * A resolved converter for a source/target format pair.
+ * Handles are immutable and owned by the library,
+ * and they remain valid for the lifetime of the process.
+ */
+typedef struct
+{
+    //! The resolved converter function
+    SoapySDRConverterFunction function;
+
+    //! The batch-native converter function or NULL when not registered
+    SoapySDRBatchConverterFunction batchFunction;
+
+    //! The size in bytes of one source element
+    size_t sourceElemSize;
+
+    //! The size in bytes of one target element
+    size_t targetElemSize;
+
+    //! The priority of the resolved converter function
+    SoapySDRConverterFunctionPriority priority;
+
+    //! The interned source format
+    SoapySDRConverterFormatId sourceFormat;
+
+    //! The interned target format
+    SoapySDRConverterFormatId targetFormat;
+
+    //! True when the source and target may be the same buffer
+    bool inPlaceSafe;
+
+    //! The clip-counting converter function or NULL when not available
+    SoapySDRClipConverterFunction clipFunction;
+
+    //! The converter function with non-temporal stores or NULL when not available
+    SoapySDRConverterFunction streamingFunction;
+} SoapySDRConverterHandle;
+
+/*!
+ * DC offset removal and IQ balance correction applied by a correction converter.
+ * Complex values are stored as {real, imag}. With x the converted sample and
+ * x' = x - dcOffset, the output is y = x' + iqBalance * conj(x').
+ * A non-zero dcTracking is the IIR coefficient of the automatic DC tracker,
+ * which updates dcOffset in place.
+ */
+#ifdef __cplusplus
+//C++ uses the layout compatible IQCorrection, so the correction functions have one type in both APIs
+#include <SoapySDR/ConverterRegistry.hpp>
+typedef SoapySDR::ConverterRegistry::IQCorrection SoapySDRIQCorrection;
+#else
+typedef struct
+{
+    double dcOffset[2];
+    double iqBalance[2];
+    double dcTracking;
+} SoapySDRIQCorrection;
+#endif
+
+/*!
+ * A typedef for declaring a correction converter function,
+ * which converts and applies the IQ correction in a single pass.
+ * The parameters are (input pointer, output pointer, number of elements, optional scalar, correction state)
+ */
+typedef void (*SoapySDRCorrectionConverterFunction)(const void *, void *, const size_t, const double, SoapySDRIQCorrection *);
+
+/*!
+ * Signal level statistics accumulated by a stats converter,
+ * in normalized units where 1.0 is full scale of the integer format.
+ * Each call adds to the counters; zero the struct to start a new period.
+ */
+#ifdef __cplusplus
+//C++ uses the layout compatible ConverterStats, so the stats functions have one type in both APIs
+typedef SoapySDR::ConverterRegistry::ConverterStats SoapySDRConverterStats;
+#else
+typedef struct
+{
+    //! The number of complex elements accumulated
+    size_t numElems;
+
+    //! The sum of the squared magnitudes |I + jQ|^2
+    double sumSquares;
+
+    //! The largest magnitude |I + jQ|
+    double peakMagnitude;
+
+    //! The number of saturated I or Q samples
+    size_t numClipped;
+} SoapySDRConverterStats;
+#endif
+
+/*!
+ * A typedef for declaring a stats converter function,
+ * which converts and accumulates the statistics in a single pass.
+ * The parameters are (input pointer, output pointer, number of elements, optional scalar, statistics)
+ */
+typedef void (*SoapySDRStatsConverterFunction)(const void *, void *, const size_t, const double, SoapySDRConverterStats *);
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -90,6 +226,146 @@ SOAPY_SDR_API SoapySDRConverterFunction SoapySDRConverter_getFunctionWithPriorit
  */
 SOAPY_SDR_API char **SoapySDRConverter_listAvailableSourceFormats(size_t *length);
 
+/*!
+ * Get a channel converter that fuses format conversion with an N-way
+ * deinterleave or interleave, with the highest available priority.
+ * \param sourceFormat the source format markup string
+ * \param targetFormat the target format markup string
+ * \param layout the channel layout of the converter
+ * \return a conversion function pointer or nullptr if none are found
+ */
+SOAPY_SDR_API SoapySDRBatchConverterFunction SoapySDRConverter_getChannelFunction(const char *sourceFormat, const char *targetFormat, const SoapySDRConverterChannelLayout layout);
+
+/*!
+ * Get a channel converter with a given priority.
+ * \param sourceFormat the source format markup string
+ * \param targetFormat the target format markup string
+ * \param layout the channel layout of the converter
+ * \param priority the priority of the converter
+ * \return a conversion function pointer or nullptr if none are found
+ */
+SOAPY_SDR_API SoapySDRBatchConverterFunction SoapySDRConverter_getChannelFunctionWithPriority(const char *sourceFormat, const char *targetFormat, const SoapySDRConverterChannelLayout layout, const SoapySDRConverterFunctionPriority priority);
+
+/*!
+ * Get a correction converter between a source and target format with the highest available priority.
+ * \param sourceFormat the source format markup string
+ * \param targetFormat the target format markup string
+ * \return a conversion function pointer or NULL on error
+ */
+SOAPY_SDR_API SoapySDRCorrectionConverterFunction SoapySDRConverter_getCorrectionFunction(const char *sourceFormat, const char *targetFormat);
+
+/*!
+ * Get a stats converter between a source and target format with the highest available priority.
+ * \param sourceFormat the source format markup string
+ * \param targetFormat the target format markup string
+ * \return a conversion function pointer or NULL on error
+ */
+SOAPY_SDR_API SoapySDRStatsConverterFunction SoapySDRConverter_getStatsFunction(const char *sourceFormat, const char *targetFormat);
+
+/*!
+ * Intern a format markup string into a compact identifier.
+ * The same format string always yields the same identifier.
+ * \param format the format markup string
+ * \return the format identifier or SOAPY_SDR_CONVERTER_INVALID_FORMAT_ID on error
+ */
+SOAPY_SDR_API SoapySDRConverterFormatId SoapySDRConverter_internFormat(const char *format);
+
+/*!
+ * Resolve the converter with the highest available priority.
+ * The lookup is constant time and does not allocate.
+ * \param sourceFormat the interned source format
+ * \param targetFormat the interned target format
+ * \return a converter handle or nullptr if none are found
+ */
+SOAPY_SDR_API const SoapySDRConverterHandle *SoapySDRConverter_resolve(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat);
+
+/*!
+ * Select the fastest registered priority of a pair on this CPU.
+ * The choice is measured or loaded from the tuning cache once,
+ * and returned by SoapySDRConverter_resolve() while auto-tuning is enabled.
+ * Call when a stream is configured: tuning allocates and may take a while.
+ * \param sourceFormat the interned source format
+ * \param targetFormat the interned target format
+ * \return the tuned converter handle or nullptr if none are found
+ */
+SOAPY_SDR_API const SoapySDRConverterHandle *SoapySDRConverter_tune(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat);
+
+/*!
+ * Resolve the converter with a given priority.
+ * \param sourceFormat the interned source format
+ * \param targetFormat the interned target format
+ * \param priority the priority of the converter
+ * \return a converter handle or nullptr if none are found
+ */
+SOAPY_SDR_API const SoapySDRConverterHandle *SoapySDRConverter_resolveWithPriority(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat, const SoapySDRConverterFunctionPriority priority);
+
+/*!
+ * Convert multiple channel buffers with a resolved converter.
+ * The buffer arrays have the same layout as SoapySDRDevice_readStream()
+ * and SoapySDRDevice_writeStream(), so stream buffers can be passed in directly.
+ * \param handle a resolved converter handle
+ * \param srcBuffs an array of numChans source buffers
+ * \param dstBuffs an array of numChans target buffers
+ * \param numChans the number of channels
+ * \param numElems the number of elements in each channel buffer
+ * \param scaler the scale factor passed to the converter
+ * \param numThreads spread channels across up to this many threads (1 uses only the calling thread)
+ * \return 0 for success or error code on failure
+ */
+SOAPY_SDR_API int SoapySDRConverter_convertChannels(const SoapySDRConverterHandle *handle, const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler, const size_t numThreads);
+
+/*!
+ * An opaque chain of converters between two formats.
+ * Paths are owned by the library and remain valid for the process lifetime.
+ */
+typedef struct SoapySDRConverterPath SoapySDRConverterPath;
+
+/*!
+ * Resolve the cheapest chain of converters between two formats,
+ * for format pairs without a direct converter.
+ * A registered direct converter is returned as a path with a single hop.
+ * \param sourceFormat the interned source format
+ * \param targetFormat the interned target format
+ * \return a pointer to the path or NULL if the formats are not connected
+ */
+SOAPY_SDR_API const SoapySDRConverterPath *SoapySDRConverter_resolvePath(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat);
+
+/*!
+ * Convert a buffer through a resolved path of converters.
+ * \param path a resolved converter path
+ * \param srcBuff the source buffer
+ * \param dstBuff the target buffer
+ * \param numElems the number of elements to convert
+ * \param scaler the scale factor, applied once
+ * \return 0 for success or error code on failure
+ */
+SOAPY_SDR_API int SoapySDRConverter_convertPath(const SoapySDRConverterPath *path, const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler);
+
+/*!
+ * Enable or disable auto-tuning of the converter priority.
+ * When enabled, SoapySDRConverter_getFunction() and SoapySDRConverter_resolve()
+ * select the fastest registered priority on this CPU and store it in the tuning cache file.
+ * SoapySDRConverter_getFunction() tunes a pair on first use, while
+ * SoapySDRConverter_resolve() returns the choice once SoapySDRConverter_tune() made it.
+ * \param enable true to enable auto-tuning
+ */
+SOAPY_SDR_API void SoapySDRConverter_setAutoTuning(const bool enable);
+
+//! Is auto-tuning of the converter priority enabled?
+SOAPY_SDR_API bool SoapySDRConverter_getAutoTuning(void);
+
+/*!
+ * Set the target buffer size at which streaming stores are used.
+ * SoapySDRConverter_convertChannels() calls the handle's streamingFunction
+ * when available for channel buffers of at least this many target bytes,
+ * so large buffers bypass the cache.
+ * \param numBytes the threshold in bytes of the target buffer
+ */
+SOAPY_SDR_API void SoapySDRConverter_setStreamingThreshold(const size_t numBytes);
+
+//! Get the target buffer size in bytes at which streaming stores are used
+SOAPY_SDR_API size_t SoapySDRConverter_getStreamingThreshold(void);
+
 #ifdef __cplusplus
 }
 #endif
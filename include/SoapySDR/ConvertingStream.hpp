@@ -0,0 +1,99 @@
+///
+/// \file SoapySDR/ConvertingStream.hpp
+///
+/// Stream any registered format from a device in its native format.
+///
+/// \copyright
+/// Copyright (c) 2021-2021 Josh Blum
+/// SPDX-License-Identifier: BSL-1.0
+///
+
+#pragma once
+#include <SoapySDR/Config.hpp>
+#include <SoapySDR/Device.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace SoapySDR
+{
+
+/*!
+ * ConvertingStream: a stream in any format with a registered converter.
+ *
+ * The device stream is set up in the native format of getNativeStreamFormat(),
+ * and each call converts between the native and the requested format
+ * with the best converter from the ConverterRegistry.
+ *
+ * When the device supports direct buffer access, the conversion reads
+ * straight from the acquired receive buffer into the caller's buffers,
+ * or writes straight from the caller's buffers into the acquired transmit buffer.
+ * The samples then cross memory once, without an intermediate copy.
+ * A receive buffer larger than the caller's request is consumed over
+ * several calls with the SOAPY_SDR_MORE_FRAGMENTS flag.
+ * Otherwise, the native samples go through a scratch buffer of one MTU.
+ *
+ * When the requested format is the native format, calls pass straight through.
+ * Like a stream handle, one instance must not be used from several threads at once.
+ */
+class SOAPY_SDR_API ConvertingStream
+{
+public:
+
+    /*!
+     * Set up a device stream in its native format.
+     * The arguments match Device::setupStream().
+     *
+     * The scale factor maps the full scale of the device to 1.0 for
+     * floating point formats, and is 1.0 between integer formats.
+     * The "scaler" key of the stream args overrides it,
+     * and is not passed to the device.
+     *
+     * \throws std::runtime_error when no converter is registered
+     * between the native and requested format, or the setup fails
+     * \param device a pointer to a device instance
+     * \param direction the channel direction (`SOAPY_SDR_RX` or `SOAPY_SDR_TX`)
+     * \param format the requested stream format markup string
+     * \param channels a list of channels or empty for automatic
+     * \param args stream args or empty for defaults
+     */
+    ConvertingStream(Device *device, const int direction, const std::string &format, const std::vector<size_t> &channels = std::vector<size_t>(), const Kwargs &args = Kwargs());
+
+    //! Close the device stream and release a held receive buffer
+    ~ConvertingStream(void);
+
+    //! Get the underlying device stream for activation and status calls
+    Stream *getStream(void) const;
+
+    //! Get the native format of the device stream
+    std::string getNativeFormat(void) const;
+
+    //! Get the requested stream format
+    std::string getFormat(void) const;
+
+    //! Get the scale factor passed to the converter
+    double getScaler(void) const;
+
+    //! True when the conversion uses direct buffer access
+    bool usesDirectAccess(void) const;
+
+    /*!
+     * Read elements from the device stream into the requested format.
+     * The arguments and return value match Device::readStream().
+     */
+    int readStream(void * const *buffs, const size_t numElems, int &flags, long long &timeNs, const long timeoutUs = 100000);
+
+    /*!
+     * Write elements in the requested format to the device stream.
+     * The arguments and return value match Device::writeStream().
+     */
+    int writeStream(const void * const *buffs, const size_t numElems, int &flags, const long long timeNs = 0, const long timeoutUs = 100000);
+
+private:
+    ConvertingStream(const ConvertingStream &);
+    ConvertingStream &operator=(const ConvertingStream &);
+    struct Impl;
+    Impl *_impl;
+};
+
+}
@@ -458,6 +458,75 @@ SOAPY_SDR_API int SoapySDRDevice_readStreamStatus(SoapySDRDevice *device,
     long long *timeNs,
     const long timeoutUs);
 
+//! Descriptor for one packet of readStreamMulti() and writeStreamMulti()
+typedef struct
+{
+    //! An array of void* buffers num chans in size
+    void * const *buffs;
+
+    //! The number of elements in each buffer
+    size_t numElems;
+
+    //! Optional input flags and output flags
+    int flags;
+
+    //! The packet's timestamp in nanoseconds
+    long long timeNs;
+
+    //! The number of elements read or written per buffer or error code
+    int ret;
+} SoapySDRStreamPacket;
+
+/*!
+ * Read multiple packets from a stream for reception in one call.
+ * Each packet descriptor is filled like a call to readStream(),
+ * and its ret field is set to the number of elements read per buffer.
+ * Only the first packet waits for the timeout, the following packets
+ * are filled for as long as data is ready without waiting.
+ * When the call returns n packets with n less than numPackets,
+ * packets[n].ret holds the code that stopped the call:
+ * SOAPY_SDR_TIMEOUT when no more data was ready, or an error
+ * such as SOAPY_SDR_OVERFLOW that is not reported otherwise.
+ *
+ * \param device a pointer to a device instance
+ * \param stream the opaque pointer to a stream handle
+ * \param packets an array of packet descriptors
+ * \param numPackets the number of packet descriptors
+ * \param timeoutUs the timeout in microseconds
+ * \return the number of packets filled or error code when none
+ */
+SOAPY_SDR_API int SoapySDRDevice_readStreamMulti(SoapySDRDevice *device,
+    SoapySDRStream *stream,
+    SoapySDRStreamPacket *packets,
+    const size_t numPackets,
+    const long timeoutUs);
+
+/*!
+ * Write multiple packets to a stream for transmission in one call.
+ * Each packet descriptor is written like a call to writeStream(),
+ * and its ret field is set to the number of elements written per buffer.
+ * Only the first packet waits for the timeout, the following packets
+ * are written for as long as space is available without waiting.
+ * The call stops after a packet that was only partially written,
+ * so the caller can resume with the remaining elements of that packet.
+ * Otherwise when the call returns n packets with n less than numPackets,
+ * packets[n].ret holds the code that stopped the call:
+ * SOAPY_SDR_TIMEOUT when no more space was available, or an error
+ * such as SOAPY_SDR_UNDERFLOW that is not reported otherwise.
+ *
+ * \param device a pointer to a device instance
+ * \param stream the opaque pointer to a stream handle
+ * \param packets an array of packet descriptors
+ * \param numPackets the number of packet descriptors
+ * \param timeoutUs the timeout in microseconds
+ * \return the number of packets written or error code when none
+ */
+SOAPY_SDR_API int SoapySDRDevice_writeStreamMulti(SoapySDRDevice *device,
+    SoapySDRStream *stream,
+    SoapySDRStreamPacket *packets,
+    const size_t numPackets,
+    const long timeoutUs);
+
 /*******************************************************************
  * Direct buffer access API
  ******************************************************************/
@@ -579,6 +648,68 @@ SOAPY_SDR_API void SoapySDRDevice_releaseWriteBuffer(SoapySDRDevice *device,
     int *flags,
     const long long timeNs);
 
+/*!
+ * Callback for asynchronous delivery of receive buffers.
+ * The arguments match a call to SoapySDRDevice_acquireReadBuffer(),
+ * followed by the user data pointer from SoapySDRDevice_setStreamCallback().
+ * When ret is an error code, the handle and buffers are not valid.
+ * Otherwise the callback owns the buffer until SoapySDRDevice_releaseReadBuffer()
+ * is called with the handle, which may happen after the callback returns.
+ */
+typedef void (*SoapySDRStreamCallback)(SoapySDRStream *stream, const size_t handle, const void * const *buffs, const int ret, const int flags, const long long timeNs, void *userData);
+
+/*!
+ * Deliver the buffers of a receive stream to a callback.
+ * This call is part of the direct buffer access API.
+ *
+ * Each filled buffer is passed to the callback as it becomes
+ * available, without a copy, and the application returns it
+ * to the stream with SoapySDRDevice_releaseReadBuffer().
+ * Timeouts are not delivered to the callback, other stream errors are,
+ * and repeated errors are delivered at a decreasing rate.
+ * Pass a NULL callback to stop the delivery. The call then
+ * waits until the callback is no longer running, unless it was
+ * made from the callback, which may stop its own delivery.
+ * Stop the delivery before closing the stream.
+ *
+ * \param device a pointer to a device instance
+ * \param stream the opaque pointer to a stream handle
+ * \param callback the buffer callback or NULL to stop
+ * \param userData an opaque pointer passed to the callback
+ * \return 0 for success or error code when not supported
+ */
+SOAPY_SDR_API int SoapySDRDevice_setStreamCallback(SoapySDRDevice *device,
+    SoapySDRStream *stream,
+    SoapySDRStreamCallback callback,
+    void *userData);
+
+/*!
+ * Allocate buffers for reading or writing a stream.
+ * Each buffer holds SoapySDRDevice_getStreamMTU() elements of the stream format,
+ * and starts on a boundary of at least 64 bytes, suitable for SIMD loads.
+ * The allocation args are "alignment", "hugePages", and "lock",
+ * see SoapySDR::allocStreamBuffers() for their meaning.
+ * \param device a pointer to a device instance
+ * \param stream the opaque pointer to a stream handle
+ * \param direction the stream direction RX or TX
+ * \param format the stream format markup string
+ * \param numBuffs the number of buffers to allocate
+ * \param args allocation args or NULL for defaults
+ * \return an array of numBuffs buffer pointers or NULL on error
+ */
+SOAPY_SDR_API void **SoapySDRDevice_allocStreamBuffers(SoapySDRDevice *device,
+    SoapySDRStream *stream,
+    const int direction,
+    const char *format,
+    const size_t numBuffs,
+    const SoapySDRKwargs *args);
+
+/*!
+ * Free buffers from SoapySDRDevice_allocStreamBuffers().
+ * \param buffs the array of buffers or NULL
+ */
+SOAPY_SDR_API void SoapySDRDevice_freeStreamBuffers(void **buffs);
+
 /*******************************************************************
  * Antenna API
  ******************************************************************/
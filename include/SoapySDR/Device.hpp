@@ -18,6 +18,7 @@
 #include <vector>
 #include <string>
 #include <complex>
+#include <functional>
 #include <cstddef> //size_t
 
 namespace SoapySDR
@@ -26,6 +27,39 @@ namespace SoapySDR
 //! Forward declaration of stream handle for type safety
 class Stream;
 
+/*!
+ * Descriptor for one packet of readStreamMulti() and writeStreamMulti().
+ * The layout matches SoapySDRStreamPacket of the C API.
+ */
+struct StreamPacket
+{
+    //! An array of void* buffers num chans in size
+    void * const *buffs;
+
+    //! The number of elements in each buffer
+    size_t numElems;
+
+    //! Optional input flags and output flags
+    int flags;
+
+    //! The packet's timestamp in nanoseconds
+    long long timeNs;
+
+    //! The number of elements read or written per buffer or error code
+    int ret;
+};
+
+/*!
+ * Callback for asynchronous delivery of receive buffers.
+ * The arguments match a call to Device::acquireReadBuffer():
+ * the stream, the buffer handle, the channel buffers,
+ * the number of elements per buffer or error code, the flags, and the time.
+ * When ret is an error code, the handle and buffers are not valid.
+ * Otherwise the callback owns the buffer until releaseReadBuffer()
+ * is called with the handle, which may happen after the callback returns.
+ */
+typedef std::function<void(Stream *stream, const size_t handle, const void * const *buffs, const int ret, const int flags, const long long timeNs)> StreamCallback;
+
 /*!
  * Abstraction for an SDR transceiver device - configuration and streaming.
  */
@@ -411,6 +445,63 @@ public:
         long long &timeNs,
         const long timeoutUs = 100000);
 
+    /*!
+     * Read multiple packets from a stream for reception in one call.
+     * Each packet descriptor is filled like a call to readStream(),
+     * and its ret field is set to the number of elements read per buffer.
+     * Only the first packet waits for the timeout, the following packets
+     * are filled for as long as data is ready without waiting.
+     * When the call returns n packets with n less than numPackets,
+     * packets[n].ret holds the code that stopped the call:
+     * SOAPY_SDR_TIMEOUT when no more data was ready, or an error
+     * such as SOAPY_SDR_OVERFLOW that is not reported otherwise.
+     *
+     * The default implementation loops over readStream().
+     * Implementations may override this call to move many packets
+     * per transaction with the underlying transport.
+     *
+     * \param stream the opaque pointer to a stream handle
+     * \param packets an array of packet descriptors
+     * \param numPackets the number of packet descriptors
+     * \param timeoutUs the timeout in microseconds
+     * \return the number of packets filled or error code when none
+     */
+    virtual int readStreamMulti(
+        Stream *stream,
+        StreamPacket *packets,
+        const size_t numPackets,
+        const long timeoutUs = 100000);
+
+    /*!
+     * Write multiple packets to a stream for transmission in one call.
+     * Each packet descriptor is written like a call to writeStream(),
+     * and its ret field is set to the number of elements written per buffer.
+     * Only the first packet waits for the timeout, the following packets
+     * are written for as long as space is available without waiting.
+     * The call stops after a packet that was only partially written,
+     * so the caller can resume with the remaining elements of that packet.
+     * Otherwise when the call returns n packets with n less than numPackets,
+     * packets[n].ret holds the code that stopped the call:
+     * SOAPY_SDR_TIMEOUT when no more space was available, or an error
+     * such as SOAPY_SDR_UNDERFLOW that is not reported otherwise.
+     *
+     * The default implementation loops over writeStream(),
+     * and the packet buffers are only read from.
+     * Implementations may override this call to move many packets
+     * per transaction with the underlying transport.
+     *
+     * \param stream the opaque pointer to a stream handle
+     * \param packets an array of packet descriptors
+     * \param numPackets the number of packet descriptors
+     * \param timeoutUs the timeout in microseconds
+     * \return the number of packets written or error code when none
+     */
+    virtual int writeStreamMulti(
+        Stream *stream,
+        StreamPacket *packets,
+        const size_t numPackets,
+        const long timeoutUs = 100000);
+
     /*******************************************************************
      * Direct buffer access API
      ******************************************************************/
@@ -526,6 +617,38 @@ public:
         int &flags,
         const long long timeNs = 0);
 
+    /*!
+     * Deliver the buffers of a receive stream to a callback.
+     * This call is part of the direct buffer access API.
+     *
+     * Each filled buffer is passed to the callback as it becomes
+     * available, without a copy, and the application returns it
+     * to the stream with releaseReadBuffer(). Timeouts are not
+     * delivered to the callback, other stream errors are,
+     * and repeated errors are delivered at a decreasing rate.
+     * Pass an empty callback to stop the delivery. The call then
+     * waits until the callback is no longer running, unless it was
+     * made from the callback, which may stop its own delivery.
+     * Stop the delivery before closing the stream.
+     * The default implementation also stops the delivery when the
+     * device is unmade, and in the default closeStream().
+     * A driver that overrides closeStream() or is destroyed without
+     * unmake() must stop the delivery itself, in closeStream() or
+     * its destructor, because the delivery thread calls into the driver.
+     *
+     * The default implementation calls acquireReadBuffer() from an
+     * internal thread, and requires direct buffer access support.
+     * Implementations may override this call to deliver buffers
+     * directly from the interrupt or transport completion context.
+     *
+     * \param stream the opaque pointer to a stream handle
+     * \param callback the buffer callback or empty to stop
+     * \return 0 for success or error code when not supported
+     */
+    virtual int setStreamCallback(
+        Stream *stream,
+        const StreamCallback &callback);
+
     /*******************************************************************
      * Antenna API
      ******************************************************************/
@@ -0,0 +1,57 @@
+///
+/// \file SoapySDR/StreamBuffers.hpp
+///
+/// Allocate aligned buffers for the stream API.
+///
+/// \copyright
+/// Copyright (c) 2021-2021 Josh Blum
+/// SPDX-License-Identifier: BSL-1.0
+///
+
+#pragma once
+#include <SoapySDR/Config.hpp>
+#include <SoapySDR/Device.hpp>
+#include <SoapySDR/Types.hpp>
+#include <cstddef>
+#include <string>
+
+namespace SoapySDR
+{
+
+/*!
+ * Allocate buffers for reading or writing a stream.
+ * Each buffer holds getStreamMTU() elements of the stream format,
+ * and starts on a boundary of at least 64 bytes, suitable for SIMD loads.
+ * The returned array can be passed directly as the buffs argument
+ * of readStream() and writeStream() when numBuffs is the number of channels.
+ *
+ * The allocation is configured with key/value args:
+ *  - alignment: the buffer alignment in bytes, a power of two (default 64).
+ *    When not specified, the default value of the "alignment" stream arg
+ *    in getStreamArgsInfo() is used, so drivers can hint their DMA alignment.
+ *    Alignments below 64 bytes are raised to 64.
+ *  - hugePages: back the buffers with huge pages (default false).
+ *    When explicit huge pages are not reserved, transparent huge pages are requested.
+ *    Ignored on systems without huge page support.
+ *  - lock: lock the buffers into physical memory (default false).
+ *    A failure to lock is logged, and the buffers remain usable.
+ *
+ * \throws std::invalid_argument for zero buffers or an invalid alignment
+ * \param device a pointer to a device instance
+ * \param stream the opaque pointer to a stream handle
+ * \param direction the stream direction (`SOAPY_SDR_RX` or `SOAPY_SDR_TX`)
+ * \param format the stream format markup string
+ * \param numBuffs the number of buffers to allocate
+ * \param args allocation args or empty for defaults
+ * \return an array of numBuffs buffer pointers for freeStreamBuffers()
+ */
+SOAPY_SDR_API void **allocStreamBuffers(Device *device, Stream *stream, const int direction, const std::string &format, const size_t numBuffs, const Kwargs &args = Kwargs());
+
+/*!
+ * Free buffers from allocStreamBuffers().
+ * The array and every buffer in it become invalid.
+ * \param buffs the array from allocStreamBuffers() or nullptr
+ */
+SOAPY_SDR_API void freeStreamBuffers(void **buffs);
+
+}
@@ -0,0 +1,338 @@
+///
+/// \file SoapySDR/StreamRing.hpp
+///
+/// Lock-free single-producer/single-consumer ring of stream buffers.
+///
+/// \copyright
+/// Copyright (c) 2021-2021 Josh Blum
+/// SPDX-License-Identifier: BSL-1.0
+///
+
+#pragma once
+#include <SoapySDR/Config.hpp>
+#include <SoapySDR/Errors.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace SoapySDR
+{
+
+/*!
+ * StreamRing: a ring of fixed-size stream buffers between one producer and one consumer.
+ *
+ * A driver typically produces buffers from a USB or DMA callback thread
+ * and consumes them in readStream(), or the reverse for transmit.
+ * The acquire and release calls mirror the direct buffer access API
+ * and count in elements, so the acquire and release calls of a Device
+ * can forward directly to the ring.
+ *
+ * Each buffer carries the element count, flags, and time of the producer.
+ * Buffers are 64-byte aligned, and the producer and consumer indexes
+ * live on separate cache lines. Passing a buffer costs one release store
+ * and one acquire load, plus one sequentially consistent fence on release
+ * to check for a blocked side without a lost wake-up; the mutex is only
+ * taken when a side has to block or wake the other side.
+ *
+ * Each side must release its buffers in the order that they were acquired.
+ */
+class StreamRing
+{
+public:
+
+    /*!
+     * Create a ring of buffers.
+     * \param numBuffs the number of buffers, rounded up to a power of two
+     * \param numElems the capacity in elements of each channel buffer
+     * \param elemSize the size in bytes of one element
+     * \param numChans the number of channel buffers per ring buffer
+     */
+    StreamRing(const size_t numBuffs, const size_t numElems, const size_t elemSize, const size_t numChans = 1);
+
+    //! Get the number of buffers in the ring
+    size_t getNumBuffs(void) const
+    {
+        return _mask+1;
+    }
+
+    //! Get the capacity in elements of each channel buffer
+    size_t getNumElems(void) const
+    {
+        return _numElems;
+    }
+
+    //! Get the size in bytes of one element
+    size_t getElemSize(void) const
+    {
+        return _elemSize;
+    }
+
+    //! Get the size in bytes of each channel buffer
+    size_t getBuffSize(void) const
+    {
+        return _numElems*_elemSize;
+    }
+
+    //! Get the number of channel buffers per ring buffer
+    size_t getNumChans(void) const
+    {
+        return _numChans;
+    }
+
+    /*!
+     * Get the channel buffers of a ring buffer by handle.
+     * This can implement getDirectAccessBufferAddrs() of a Device.
+     * \param handle a buffer handle in [0, getNumBuffs())
+     * \param [out] buffs an array of getNumChans() pointers
+     */
+    void getBuffers(const size_t handle, void **buffs) const
+    {
+        char *buff = _base + handle*_slotStride + SLOT_HEADER;
+        for (size_t i = 0; i < _numChans; i++) buffs[i] = buff + i*_chanStride;
+    }
+
+    /*******************************************************************
+     * Producer API
+     ******************************************************************/
+
+    /*!
+     * Acquire an empty buffer to fill.
+     * \param [out] handle the buffer handle for releaseWriteBuffer()
+     * \param [out] buffs an array of getNumChans() pointers
+     * \param timeoutUs the timeout in microseconds, or 0 to poll
+     * \return the buffer capacity in elements or SOAPY_SDR_TIMEOUT when the ring is full
+     */
+    int acquireWriteBuffer(size_t &handle, void **buffs, const long timeoutUs = 100000);
+
+    /*!
+     * Release a filled buffer to the consumer.
+     * \param handle the handle from acquireWriteBuffer()
+     * \param numElems the number of elements in the buffer
+     * \param flags the stream flags for the consumer
+     * \param timeNs the time of the first element in nanoseconds
+     */
+    void releaseWriteBuffer(const size_t handle, const size_t numElems, const int flags = 0, const long long timeNs = 0);
+
+    /*!
+     * Report that the producer dropped data because the ring was full.
+     * The consumer receives SOAPY_SDR_OVERFLOW once after the buffers
+     * that were released before the data was dropped.
+     */
+    void reportOverflow(void)
+    {
+        _producer.overflowPending = true;
+    }
+
+    /*******************************************************************
+     * Consumer API
+     ******************************************************************/
+
+    /*!
+     * Acquire the next filled buffer.
+     * \param [out] handle the buffer handle for releaseReadBuffer()
+     * \param [out] buffs an array of getNumChans() pointers
+     * \param [out] flags the stream flags from the producer
+     * \param [out] timeNs the time of the first element in nanoseconds
+     * \param timeoutUs the timeout in microseconds, or 0 to poll
+     * \return the number of elements, SOAPY_SDR_OVERFLOW, or SOAPY_SDR_TIMEOUT
+     */
+    int acquireReadBuffer(size_t &handle, const void **buffs, int &flags, long long &timeNs, const long timeoutUs = 100000);
+
+    /*!
+     * Release a consumed buffer back to the producer.
+     * \param handle the handle from acquireReadBuffer()
+     */
+    void releaseReadBuffer(const size_t handle);
+
+private:
+    //! The metadata stored on the cache line before each buffer
+    struct Slot
+    {
+        size_t numElems;
+        long long timeNs;
+        int flags;
+        bool overflow;
+    };
+    static const size_t CACHE_LINE = 64;
+    static const size_t SLOT_HEADER = CACHE_LINE;
+    static const size_t SPIN_COUNT = 256;
+
+    //! A side blocks on the waiter when the other side has not caught up
+    struct Waiter
+    {
+        Waiter(void): waiting(false){}
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::atomic<bool> waiting;
+    };
+
+    Slot &slot(const size_t handle)
+    {
+        return *reinterpret_cast<Slot *>(_base + handle*_slotStride);
+    }
+
+    template <typename Ready>
+    static bool wait(Waiter &waiter, const long timeoutUs, Ready ready);
+    static void notify(Waiter &waiter);
+
+    //configuration and storage, read only after construction
+    size_t _mask;
+    size_t _numElems;
+    size_t _elemSize;
+    size_t _numChans;
+    size_t _chanStride;
+    size_t _slotStride;
+    std::vector<char> _storage;
+    char *_base;
+
+    //the producer and consumer indexes are padded onto separate cache lines
+    struct Producer
+    {
+        char padding[CACHE_LINE];
+        size_t acquired;
+        size_t readReleased; //cached copy of the consumer index
+        bool overflowPending;
+        std::atomic<size_t> released;
+    } _producer;
+
+    struct Consumer
+    {
+        char padding[CACHE_LINE];
+        size_t acquired;
+        size_t writeReleased; //cached copy of the producer index
+        std::atomic<size_t> released;
+        char padding1[CACHE_LINE];
+    } _consumer;
+
+    Waiter _readWaiter;
+    Waiter _writeWaiter;
+};
+
+}
+
+inline SoapySDR::StreamRing::StreamRing(const size_t numBuffs, const size_t numElems, const size_t elemSize, const size_t numChans):
+    _mask(0),
+    _numElems(numElems),
+    _elemSize(elemSize),
+    _numChans(numChans),
+    _chanStride((numElems*elemSize + CACHE_LINE - 1) & ~(CACHE_LINE - 1)),
+    _slotStride(SLOT_HEADER + _chanStride*numChans),
+    _base(nullptr)
+{
+    _producer.acquired = 0;
+    _producer.readReleased = 0;
+    _producer.overflowPending = false;
+    _producer.released = 0;
+    _consumer.acquired = 0;
+    _consumer.writeReleased = 0;
+    _consumer.released = 0;
+
+    if (numBuffs == 0 || numElems == 0 || elemSize == 0 || numChans == 0)
+    {
+        throw std::invalid_argument("StreamRing() requires non-zero numBuffs, numElems, elemSize, and numChans");
+    }
+    while (_mask+1 < numBuffs) _mask = (_mask << 1) | 1;
+
+    //the storage is zeroed, which also faults in the pages up front
+    _storage.resize(_slotStride*(_mask+1) + CACHE_LINE);
+    const auto addr = reinterpret_cast<uintptr_t>(_storage.data());
+    _base = _storage.data() + ((CACHE_LINE - (addr & (CACHE_LINE - 1))) & (CACHE_LINE - 1));
+}
+
+template <typename Ready>
+bool SoapySDR::StreamRing::wait(Waiter &waiter, const long timeoutUs, Ready ready)
+{
+    //the other side usually catches up within a few hundred cycles
+    if (timeoutUs <= 0) return ready();
+    for (size_t i = 0; i < SPIN_COUNT; i++)
+    {
+        if (ready()) return true;
+    }
+
+    //publish the waiting flag before the final check, notify() pairs with this fence
+    const auto exitTime = std::chrono::steady_clock::now() + std::chrono::microseconds(timeoutUs);
+    std::unique_lock<std::mutex> lock(waiter.mutex);
+    waiter.waiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool ok = ready();
+    while (!ok && waiter.cond.wait_until(lock, exitTime) == std::cv_status::no_timeout) ok = ready();
+    if (!ok) ok = ready();
+    waiter.waiting.store(false, std::memory_order_relaxed);
+    return ok;
+}
+
+inline void SoapySDR::StreamRing::notify(Waiter &waiter)
+{
+    //either this sees the waiting flag, or the waiter sees the released index
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!waiter.waiting.load(std::memory_order_relaxed)) return;
+    std::lock_guard<std::mutex> lock(waiter.mutex);
+    waiter.cond.notify_one();
+}
+
+inline int SoapySDR::StreamRing::acquireWriteBuffer(size_t &handle, void **buffs, const long timeoutUs)
+{
+    if (_producer.acquired - _producer.readReleased > _mask)
+    {
+        const bool ok = wait(_writeWaiter, timeoutUs, [this]()
+        {
+            _producer.readReleased = _consumer.released.load(std::memory_order_acquire);
+            return _producer.acquired - _producer.readReleased <= _mask;
+        });
+        if (!ok) return SOAPY_SDR_TIMEOUT;
+    }
+    handle = (_producer.acquired++) & _mask;
+    this->getBuffers(handle, buffs);
+    return int(_numElems);
+}
+
+inline void SoapySDR::StreamRing::releaseWriteBuffer(const size_t handle, const size_t numElems, const int flags, const long long timeNs)
+{
+    Slot &s = this->slot(handle);
+    s.numElems = numElems;
+    s.timeNs = timeNs;
+    s.flags = flags;
+    s.overflow = _producer.overflowPending;
+    _producer.overflowPending = false;
+    _producer.released.store(_producer.released.load(std::memory_order_relaxed)+1, std::memory_order_release);
+    notify(_readWaiter);
+}
+
+inline int SoapySDR::StreamRing::acquireReadBuffer(size_t &handle, const void **buffs, int &flags, long long &timeNs, const long timeoutUs)
+{
+    if (_consumer.acquired == _consumer.writeReleased)
+    {
+        const bool ok = wait(_readWaiter, timeoutUs, [this]()
+        {
+            _consumer.writeReleased = _producer.released.load(std::memory_order_acquire);
+            return _consumer.acquired != _consumer.writeReleased;
+        });
+        if (!ok) return SOAPY_SDR_TIMEOUT;
+    }
+
+    //report the overflow before the first buffer after the dropped data
+    handle = _consumer.acquired & _mask;
+    Slot &s = this->slot(handle);
+    if (s.overflow)
+    {
+        s.overflow = false;
+        return SOAPY_SDR_OVERFLOW;
+    }
+
+    _consumer.acquired++;
+    this->getBuffers(handle, const_cast<void **>(buffs));
+    flags = s.flags;
+    timeNs = s.timeNs;
+    return int(s.numElems);
+}
+
+inline void SoapySDR::StreamRing::releaseReadBuffer(const size_t)
+{
+    _consumer.released.store(_consumer.released.load(std::memory_order_relaxed)+1, std::memory_order_release);
+    notify(_writeWaiter);
+}
@@ -36,7 +36,7 @@
  * And <i>extra</i> is empty for releases but set on development branches.
  * The ABI should remain constant across patch releases of the library.
  */
-#define SOAPY_SDR_ABI_VERSION "0.8-2"
+#define SOAPY_SDR_ABI_VERSION "0.8-3"
 
 /*!
  * Compatibility define for GPIO access API with masks
@@ -168,6 +168,86 @@
  */
 #define SOAPY_SDR_API_HAS_GET_SPECIFIC_SETTING_INFO
 
+/*!
+ * Compatibility define for interned formats and resolved converter handles
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_HANDLES
+
+/*!
+ * Compatibility define for batched multi-channel conversion
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_BATCH
+
+/*!
+ * Compatibility define for interleave/deinterleave channel converters
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_CHANNEL_LAYOUT
+
+/*!
+ * Compatibility define for saturating clip-counting converters
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_CLIP_COUNT
+
+/*!
+ * Compatibility define for converter auto-tuning
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_AUTO_TUNING
+
+/*!
+ * Compatibility define for multi-hop converter paths
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_PATHS
+
+/*!
+ * Compatibility define for fused DC offset and IQ balance correction converters
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_IQ_CORRECTION
+
+/*!
+ * Compatibility define for converters with power, peak, and clip statistics
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_STATS
+
+/*!
+ * Compatibility define for converters with non-temporal streaming stores
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_STREAMING_STORES
+
+/*!
+ * Compatibility define for converter handles that declare in-place safety
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_IN_PLACE
+
+/*!
+ * Compatibility define for the lock-free StreamRing for driver streams
+ */
+#define SOAPY_SDR_API_HAS_STREAM_RING
+
+/*!
+ * Compatibility define for readStreamMulti() and writeStreamMulti()
+ */
+#define SOAPY_SDR_API_HAS_STREAM_MULTI
+
+/*!
+ * Compatibility define for setStreamCallback() asynchronous delivery
+ */
+#define SOAPY_SDR_API_HAS_STREAM_CALLBACK
+
+/*!
+ * Compatibility define for the ConvertingStream format adapter
+ */
+#define SOAPY_SDR_API_HAS_CONVERTING_STREAM
+
+/*!
+ * Compatibility define for allocStreamBuffers() aligned buffers
+ */
+#define SOAPY_SDR_API_HAS_STREAM_BUFFERS
+
+/*!
+ * Compatibility define for registering converters with a ConverterDescriptor
+ */
+#define SOAPY_SDR_API_HAS_CONVERTER_DESCRIPTOR
+
 #ifdef __cplusplus
 extern "C" {
 #endif
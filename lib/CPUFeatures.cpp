@@ -0,0 +1,123 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "CPUFeatures.hpp"
+#include <fstream>
+#include <cstring>
+
+#if defined(SOAPY_SDR_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(SOAPY_SDR_X86)
+#include <cpuid.h>
+#endif
+
+static CPUFeatures detectCPUFeatures(void)
+{
+    CPUFeatures features = CPUFeatures();
+
+#if defined(SOAPY_SDR_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    features.sse2 = (info[3] & (1 << 26)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+
+    //the OS must save the extended register state for AVX
+    const unsigned long long xcr0 = osxsave?_xgetbv(0):0;
+    const bool ymmState = (xcr0 & 0x6) == 0x6;
+    const bool zmmState = (xcr0 & 0xe6) == 0xe6;
+
+    if (maxLeaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        features.avx2 = ymmState and (info[1] & (1 << 5)) != 0;
+        features.avx512f = zmmState and (info[1] & (1 << 16)) != 0;
+    }
+#elif defined(SOAPY_SDR_X86)
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2");
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+
+#ifdef SOAPY_SDR_NEON
+    //the compiler was told to target neon, so its always present
+    features.neon = true;
+#endif
+
+    return features;
+}
+
+const CPUFeatures &getCPUFeatures(void)
+{
+    static const CPUFeatures features = detectCPUFeatures();
+    return features;
+}
+
+static std::string detectCPUModel(void)
+{
+#ifdef SOAPY_SDR_X86
+    //the brand string is stored in the extended leaves 0x80000002-4
+    unsigned int regs[12];
+    std::memset(regs, 0, sizeof(regs));
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0x80000000);
+    const bool hasBrand = unsigned(info[0]) >= 0x80000004u;
+    for (int i = 0; hasBrand and i < 3; i++) __cpuid((int *)(regs+4*i), 0x80000002+i);
+#else
+    const bool hasBrand = __get_cpuid_max(0x80000000, nullptr) >= 0x80000004u;
+    for (unsigned i = 0; hasBrand and i < 3; i++) __get_cpuid(0x80000002+i, regs+4*i, regs+4*i+1, regs+4*i+2, regs+4*i+3);
+#endif
+    std::string brand((const char *)regs, strnlen((const char *)regs, sizeof(regs)));
+    const auto first = brand.find_first_not_of(' ');
+    if (first != std::string::npos) return brand.substr(first, brand.find_last_not_of(' ')-first+1);
+#endif
+
+    //other architectures report the model through the kernel
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+    {
+        if (line.compare(0, 10, "model name") != 0 and line.compare(0, 8, "Hardware") != 0) continue;
+        const auto pos = line.find(':');
+        if (pos != std::string::npos and pos+2 < line.size()) return line.substr(pos+2);
+    }
+    return "unknown";
+}
+
+const std::string &getCPUModel(void)
+{
+    static const std::string model = detectCPUModel();
+    return model;
+}
+
+static size_t detectLastLevelCacheSize(void)
+{
+    //the kernel lists each cache level of the first CPU, sizes are like "32K"
+    size_t size(0), level(0);
+    for (size_t index = 0; index < 16; index++)
+    {
+        const std::string dir("/sys/devices/system/cpu/cpu0/cache/index"+std::to_string(index)+"/");
+        std::ifstream levelFile(dir+"level"), typeFile(dir+"type"), sizeFile(dir+"size");
+        size_t thisLevel(0), thisSize(0);
+        std::string type, units;
+        if (not (levelFile >> thisLevel) or not (typeFile >> type) or not (sizeFile >> thisSize)) break;
+        if (type == "Instruction" or thisLevel < level) continue;
+        sizeFile >> units;
+        if (units == "K") thisSize <<= 10;
+        if (units == "M") thisSize <<= 20;
+        level = thisLevel;
+        size = thisSize;
+    }
+    return size;
+}
+
+size_t getLastLevelCacheSize(void)
+{
+    static const size_t size = detectLastLevelCacheSize();
+    return size;
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <string>
+#include <cstddef>
+
+/*******************************************************************
+ * Function attribute to compile a single function for a target ISA
+ * without enabling the ISA for the entire translation unit.
+ * The caller is responsible for checking getCPUFeatures() first.
+ ******************************************************************/
+#if defined(__GNUC__) || defined(__clang__)
+#define SOAPY_SDR_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SOAPY_SDR_TARGET(isa)
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SOAPY_SDR_X86
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SOAPY_SDR_NEON
+#endif
+
+/*******************************************************************
+ * Instruction set extensions available on the running CPU
+ ******************************************************************/
+struct CPUFeatures
+{
+    bool sse2;
+    bool avx2;
+    bool avx512f;
+    bool neon;
+};
+
+//! Query the running CPU once and return the cached result
+const CPUFeatures &getCPUFeatures(void);
+
+//! Get the CPU model name or "unknown" (queried once and cached)
+const std::string &getCPUModel(void);
+
+//! Get the size in bytes of the last level data cache or 0 when unknown (queried once and cached)
+size_t getLastLevelCacheSize(void);
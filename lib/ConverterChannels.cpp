@@ -0,0 +1,175 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************************
+ * A small pool of worker threads for multi-channel conversion.
+ *
+ * One job runs at a time: the submitting thread publishes the job,
+ * wakes up to the requested number of workers, and takes part in the
+ * work itself. Tasks are claimed through an atomic counter. A second
+ * caller that finds the pool busy converts on its own thread rather
+ * than waiting for the pool.
+ **********************************************************************/
+class ConverterWorkers
+{
+public:
+    ConverterWorkers(const size_t numWorkers):
+        _stop(false),
+        _generation(0),
+        _task(nullptr),
+        _numTasks(0),
+        _nextTask(0),
+        _wanted(0),
+        _joined(0),
+        _active(0)
+    {
+        for (size_t i = 0; i < numWorkers; i++)
+        {
+            _threads.emplace_back(&ConverterWorkers::workerLoop, this);
+        }
+    }
+
+    ~ConverterWorkers(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cond.notify_all();
+        for (auto &t : _threads) t.join();
+    }
+
+    size_t size(void) const
+    {
+        return _threads.size();
+    }
+
+    //! Run task(i) for every i in [0, numTasks) on up to numThreads threads
+    void run(const size_t numTasks, const size_t numThreads, const std::function<void(size_t)> &task)
+    {
+        std::unique_lock<std::mutex> jobLock(_jobMutex, std::try_to_lock);
+        if (not jobLock.owns_lock() or numThreads <= 1 or _threads.empty())
+        {
+            for (size_t i = 0; i < numTasks; i++) task(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = &task;
+            _numTasks = numTasks;
+            _nextTask = 0;
+            _wanted = std::min(numThreads-1, _threads.size());
+            _joined = 0;
+            _generation++;
+        }
+        _cond.notify_all();
+
+        this->runTasks();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this]{return _active == 0;});
+        _task = nullptr;
+        _wanted = 0;
+    }
+
+private:
+    void runTasks(void)
+    {
+        size_t i;
+        while ((i = _nextTask.fetch_add(1)) < _numTasks) (*_task)(i);
+    }
+
+    void workerLoop(void)
+    {
+        size_t seen(0);
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _cond.wait(lock, [&]{return _stop or _generation != seen;});
+            if (_stop) return;
+            seen = _generation;
+            if (_joined >= _wanted) continue;
+            _joined++;
+            _active++;
+
+            lock.unlock();
+            this->runTasks();
+            lock.lock();
+
+            if (--_active == 0) _done.notify_all();
+        }
+    }
+
+    std::mutex _jobMutex;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::condition_variable _done;
+    std::vector<std::thread> _threads;
+    bool _stop;
+    size_t _generation;
+    const std::function<void(size_t)> *_task;
+    size_t _numTasks;
+    std::atomic<size_t> _nextTask;
+    size_t _wanted;
+    size_t _joined;
+    size_t _active;
+};
+
+//! The pool is created on first multi-threaded use
+static ConverterWorkers &getConverterWorkers(void)
+{
+    //a handful of workers is enough to saturate memory bandwidth
+    static const size_t maxWorkers(7);
+    static ConverterWorkers workers(std::min<size_t>(
+        maxWorkers, std::max<unsigned>(std::thread::hardware_concurrency(), 1)-1));
+    return workers;
+}
+
+/***********************************************************************
+ * Multi-channel conversion
+ **********************************************************************/
+static void convertChannelRange(
+    const SoapySDR::ConverterRegistry::ConverterHandle &handle,
+    const void * const *srcBuffs, void * const *dstBuffs,
+    const size_t numChans, const size_t numElems, const double scaler)
+{
+    if (handle.batchFunction != nullptr)
+    {
+        handle.batchFunction(srcBuffs, dstBuffs, numChans, numElems, scaler);
+        return;
+    }
+    for (size_t ch = 0; ch < numChans; ch++)
+    {
+        handle(srcBuffs[ch], dstBuffs[ch], numElems, scaler);
+    }
+}
+
+void SoapySDR::ConverterRegistry::convertChannels(const ConverterHandle &handle, const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler, const size_t numThreads)
+{
+    const size_t numGroups = std::min(numChans, numThreads);
+    if (numGroups <= 1)
+    {
+        convertChannelRange(handle, srcBuffs, dstBuffs, numChans, numElems, scaler);
+        return;
+    }
+
+    //split the channels into contiguous groups, one task per group
+    auto &workers = getConverterWorkers();
+    const size_t numTasks = std::min(numGroups, workers.size()+1);
+    workers.run(numTasks, numTasks, [&](const size_t task)
+    {
+        const size_t first = (numChans*task)/numTasks;
+        const size_t last = (numChans*(task+1))/numTasks;
+        convertChannelRange(handle, srcBuffs+first, dstBuffs+first, last-first, numElems, scaler);
+    });
+}
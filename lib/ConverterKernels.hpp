@@ -0,0 +1,96 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "CPUFeatures.hpp"
+#include <SoapySDR/ConverterPrimitives.hpp>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+
+/***********************************************************************
+ * Sample conversions shared by the fused converters
+ *
+ * Each op converts one scalar component of a complex element with the
+ * scaler folded into a single float constant by scale(). The fused
+ * loops in the channel, correction, and stats converters are templated
+ * on these ops, so every file sees one definition of each.
+ **********************************************************************/
+
+struct CS16toCF32
+{
+  typedef int16_t SrcType; typedef float DstType;
+  static float scale(const double scaler) { return float(scaler/SoapySDR::S16_FULL_SCALE); }
+  static float convert(const int16_t in, const float scale) { return float(in)*scale; }
+};
+
+struct CS8toCF32
+{
+  typedef int8_t SrcType; typedef float DstType;
+  static float scale(const double scaler) { return float(scaler/SoapySDR::S8_FULL_SCALE); }
+  static float convert(const int8_t in, const float scale) { return float(in)*scale; }
+};
+
+struct CU8toCF32
+{
+  typedef uint8_t SrcType; typedef float DstType;
+  static float scale(const double scaler) { return float(scaler/SoapySDR::S8_FULL_SCALE); }
+  static float convert(const uint8_t in, const float scale) { return float(SoapySDR::U8toS8(in))*scale; }
+};
+
+struct CF32toCS16
+{
+  typedef float SrcType; typedef int16_t DstType;
+  static float scale(const double scaler) { return float(scaler*SoapySDR::S16_FULL_SCALE); }
+  static int16_t convert(const float in, const float scale) { return SoapySDR::SaturateInt<int16_t>(in*scale); }
+};
+
+struct CF32toCS8
+{
+  typedef float SrcType; typedef int8_t DstType;
+  static float scale(const double scaler) { return float(scaler*SoapySDR::S8_FULL_SCALE); }
+  static int8_t convert(const float in, const float scale) { return SoapySDR::SaturateInt<int8_t>(in*scale); }
+};
+
+struct CF32toCU8
+{
+  typedef float SrcType; typedef uint8_t DstType;
+  static float scale(const double scaler) { return float(scaler*SoapySDR::S8_FULL_SCALE); }
+  static uint8_t convert(const float in, const float scale) { return SoapySDR::S8toU8(SoapySDR::SaturateInt<int8_t>(in*scale)); }
+};
+
+struct CF32toCF32
+{
+  typedef float SrcType; typedef float DstType;
+  static float scale(const double scaler) { return float(scaler); }
+  static float convert(const float in, const float scale) { return in*scale; }
+};
+
+/***********************************************************************
+ * Kernel tables
+ *
+ * A kernel table lists the SIMD kernels of a converter family in order
+ * of preference for each source/target pair, and ends with an entry
+ * whose function is nullptr. Each entry has the members sourceFormat,
+ * targetFormat, isa (a CPUFeatures member), and function.
+ **********************************************************************/
+
+/*!
+ * Register the first kernel for each source/target pair whose
+ * instruction set is supported by the running CPU.
+ * \param kernels the kernel table
+ * \param reg called with each selected entry to register it
+ */
+template <typename Kernel, typename Register>
+void registerKernelTable(const Kernel *kernels, const Register &reg)
+{
+  const CPUFeatures &cpu = getCPUFeatures();
+  std::set<std::pair<std::string, std::string>> registered;
+  for (const auto *k = kernels; k->function != nullptr; k++)
+    {
+      if (not (cpu.*(k->isa))) continue;
+      if (not registered.insert(std::make_pair(k->sourceFormat, k->targetFormat)).second) continue;
+      reg(*k);
+    }
+}
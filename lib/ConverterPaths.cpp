@@ -0,0 +1,62 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <algorithm>
+#include <vector>
+#include <stdint.h>
+
+/***********************************************************************
+ * Per-thread scratch for multi-hop conversion.
+ *
+ * Each block of elements is converted hop by hop through two ping-pong
+ * buffers, so an intermediate format is written and read back while it
+ * is still in the cache. The buffers belong to the calling thread and
+ * are reused across calls and paths, so conversion does not allocate
+ * once the scratch has grown to the largest block.
+ **********************************************************************/
+struct PathScratch
+{
+    //! Get a 64-byte aligned pointer to ping-pong buffer i of at least numBytes
+    void *get(const size_t i, const size_t numBytes)
+    {
+        auto &storage = buffs[i];
+        if (storage.size() < numBytes+64) storage.resize(numBytes+64);
+        return (void *)((uintptr_t(storage.data())+63) & ~uintptr_t(63));
+    }
+
+    std::vector<char> buffs[2];
+};
+
+void SoapySDR::ConverterRegistry::convertPath(const ConverterPath &path, const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+    const auto &hops = path.hops;
+    if (hops.size() == 1)
+    {
+        hops.front()->function(srcBuff, dstBuff, numElems, scaler);
+        return;
+    }
+
+    static thread_local PathScratch scratch;
+    void *scratchBuffs[2];
+    for (size_t i = 0; i < 2; i++)
+    {
+        size_t maxElemSize(0);
+        for (size_t h = i; h+1 < hops.size(); h += 2) maxElemSize = std::max(maxElemSize, hops[h]->targetElemSize);
+        scratchBuffs[i] = scratch.get(i, path.blockElems*maxElemSize);
+    }
+
+    const size_t srcElemSize = hops.front()->sourceElemSize;
+    const size_t dstElemSize = hops.back()->targetElemSize;
+    for (size_t offset = 0; offset < numElems; offset += path.blockElems)
+    {
+        const size_t n = std::min(path.blockElems, numElems-offset);
+        const void *in = (const char *)srcBuff + offset*srcElemSize;
+        for (size_t h = 0; h < hops.size(); h++)
+        {
+            void *out = (h+1 == hops.size())?((char *)dstBuff + offset*dstElemSize):scratchBuffs[h%2];
+            hops[h]->function(in, out, n, (h == path.scalerHop)?scaler:1.0);
+            in = out;
+        }
+    }
+}
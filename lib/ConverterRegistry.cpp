@@ -2,154 +2,1189 @@
 // Copyright (c) 2018-2018 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
+#include "ConverterTuning.hpp"
+#include "CPUFeatures.hpp"
+#include "DefaultConverters.hpp"
 #include <SoapySDR/ConverterRegistry.hpp>
+#include <SoapySDR/Types.hpp>
+#include <new>
 #include <algorithm>
 #include <stdexcept>
+#include <cstdlib>
+#include <cctype>
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 void lateLoadDefaultConverters(void);
+std::string getEnvImpl(const char *name);
 
-static SoapySDR::ConverterRegistry::FormatConverters formatConverters;
+typedef SoapySDR::ConverterRegistry::FormatId FormatId;
+const FormatId SoapySDR::ConverterRegistry::INVALID_FORMAT_ID;
+typedef SoapySDR::ConverterRegistry::ConverterHandle ConverterHandle;
+typedef SoapySDR::ConverterRegistry::ConverterPath ConverterPath;
 
-SoapySDR::ConverterRegistry::ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority, ConverterFunction converterFunction)
+/***********************************************************************
+ * Registry snapshots
+ *
+ * Readers load the current snapshot with a single atomic load and
+ * never lock or modify it. Registration copies the latest snapshot
+ * under the registry mutex, modifies the copy, and publishes it
+ * atomically. Published snapshots are immutable, apart from the tables
+ * of auto-tuned choices and resolved paths that are filled in place,
+ * and are kept for the lifetime of the library, so a reader may safely
+ * finish a query on a snapshot that was replaced in the meantime.
+ *
+ * A snapshot is a set of shared sub-tables: the format names, one row
+ * of handles per source format, and the channel, correction, and stats
+ * converters. Copying a snapshot copies the references, and a
+ * registration copies only the sub-tables that it modifies, so a
+ * retained snapshot costs one reference per format plus the rows that
+ * it changed. Path tables are allocated on first use by resolvePath().
+ *
+ * Only registration publishes, and batches of registrations publish
+ * once: the default converters load as one batch, and so does each
+ * call to loadModule() and loadModules(). Interning a new format leaves
+ * it in the pending snapshot until the next registration, and tuning
+ * and path resolution do not copy the snapshot.
+ *
+ * The built-in generic converters are not stored in the snapshot.
+ * Every snapshot starts with the built-in formats at their fixed ids,
+ * and lookups consult the built-in table alongside the registered
+ * handles, which form an overlay for modules and other converters.
+ **********************************************************************/
+typedef std::map<SoapySDR::ConverterRegistry::FunctionPriority, SoapySDR::ConverterRegistry::BatchConverterFunction> ChannelConverterPriority;
+typedef std::map<std::string, std::map<std::string, ChannelConverterPriority>> ChannelConverters;
+typedef std::map<SoapySDR::ConverterRegistry::FunctionPriority, SoapySDR::ConverterRegistry::CorrectionConverterFunction> CorrectionConverterPriority;
+typedef std::map<std::string, std::map<std::string, CorrectionConverterPriority>> CorrectionConverters;
+typedef std::map<SoapySDR::ConverterRegistry::FunctionPriority, SoapySDR::ConverterRegistry::StatsConverterFunction> StatsConverterPriority;
+typedef std::map<std::string, std::map<std::string, StatsConverterPriority>> StatsConverters;
+
+//! A square table of results per source/target pair that readers load and lookups store in place
+template <typename T>
+struct AtomicTable
+{
+  AtomicTable(const size_t size):
+    size(size),
+    table(new std::atomic<T>[size*size])
+  {
+    for (size_t i = 0; i < size*size; i++) table[i].store(T(), std::memory_order_relaxed);
+  }
+
+  AtomicTable(const AtomicTable &) = delete;
+  AtomicTable &operator=(const AtomicTable &) = delete;
+
+  std::atomic<T> &at(const FormatId sourceFormat, const FormatId targetFormat) const
+  {
+    return table[sourceFormat*size+targetFormat];
+  }
+
+  const size_t size;
+  const std::unique_ptr<std::atomic<T>[]> table;
+};
+
+//! The interned format names and their ids
+struct FormatTable
+{
+  std::map<std::string, FormatId> formatIds;
+  std::vector<std::string> formatNames;
+};
+
+//! The registered converters from one source format, indexed by target format
+struct SourceConverters
+{
+  SourceConverters(void)
+  {
+    return;
+  }
+
+  SourceConverters(const SourceConverters &other):
+    handles(other.handles),
+    bestHandles(other.bestHandles),
+    tunedHandles(new std::atomic<const ConverterHandle *>[other.size()])
+  {
+    for (size_t i = 0; i < size(); i++) tunedHandles[i].store(other.tunedHandles[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+  SourceConverters &operator=(const SourceConverters &) = delete;
+
+  //! The number of target formats in the row, later formats have no converters from this source
+  size_t size(void) const
+  {
+    return bestHandles.size();
+  }
+
+  //! Grow the row to a number of target formats, keeping the entries (unshared only)
+  void resize(const size_t numTargets)
+  {
+    if (numTargets <= size()) return;
+    std::unique_ptr<std::atomic<const ConverterHandle *>[]> newTuned(new std::atomic<const ConverterHandle *>[numTargets]);
+    for (size_t i = 0; i < numTargets; i++)
+      {
+        newTuned[i].store((i < size())?tunedHandles[i].load(std::memory_order_relaxed):nullptr, std::memory_order_relaxed);
+      }
+    tunedHandles = std::move(newTuned);
+    handles.resize(numTargets);
+    bestHandles.resize(numTargets, nullptr);
+  }
+
+  //registered handles for each target in ascending priority order,
+  //the built-in converter for the pair is not included
+  std::vector<std::vector<const ConverterHandle *>> handles;
+
+  //the highest priority handle for each target or nullptr,
+  //including the built-in converter for the pair
+  std::vector<const ConverterHandle *> bestHandles;
+
+  //the auto-tuned handle for each target or nullptr when not tuned
+  std::unique_ptr<std::atomic<const ConverterHandle *>[]> tunedHandles;
+};
+
+struct ConverterSnapshot
+{
+  ConverterSnapshot(void):
+    formats(new FormatTable()),
+    correctionConverters(new CorrectionConverters()),
+    statsConverters(new StatsConverters())
+  {
+    for (auto &converters : channelConverters) converters.reset(new ChannelConverters());
+    for (auto &table : paths) table.store(nullptr, std::memory_order_relaxed);
+  }
+
+  //! Share every sub-table of another snapshot, without its resolved paths
+  ConverterSnapshot(const ConverterSnapshot &other):
+    formats(other.formats),
+    sources(other.sources),
+    correctionConverters(other.correctionConverters),
+    statsConverters(other.statsConverters)
+  {
+    for (size_t i = 0; i < 2; i++) channelConverters[i] = other.channelConverters[i];
+    for (auto &table : paths) table.store(nullptr, std::memory_order_relaxed);
+  }
+
+  ConverterSnapshot &operator=(const ConverterSnapshot &) = delete;
+
+  ~ConverterSnapshot(void)
+  {
+    for (auto &table : paths) delete table.load(std::memory_order_relaxed);
+  }
+
+  //the interned formats
+  std::shared_ptr<FormatTable> formats;
+
+  //the registered converters of each interned source format
+  std::vector<std::shared_ptr<SourceConverters>> sources;
+
+  //the resolved path for a source/target pair or nullptr when not resolved,
+  //indexed by whether the path costs were measured, allocated on first use
+  mutable std::atomic<AtomicTable<const ConverterPath *> *> paths[2];
+
+  //channel converters indexed by ChannelLayout
+  std::shared_ptr<ChannelConverters> channelConverters[2];
+
+  //fused conversion and IQ correction converters
+  std::shared_ptr<CorrectionConverters> correctionConverters;
+
+  //fused conversion and level statistics converters
+  std::shared_ptr<StatsConverters> statsConverters;
+};
+
+//! Get a sub-table of the pending snapshot to modify, copying it when a published snapshot shares it (mutex held)
+template <typename T>
+static T &modifyTable(std::shared_ptr<T> &table)
+{
+  if (table.use_count() > 1) table.reset(new T(*table));
+  return *table;
+}
+
+static std::atomic<const ConverterSnapshot *> currentSnapshot(nullptr);
+
+static std::recursive_mutex &getRegistryMutex(void)
+{
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
+//! Storage for every published snapshot, guarded by the registry mutex
+static std::vector<std::unique_ptr<const ConverterSnapshot>> &getPublishedSnapshots(void)
+{
+  static std::vector<std::unique_ptr<const ConverterSnapshot>> snapshots;
+  return snapshots;
+}
+
+//! Modifications not yet published, guarded by the registry mutex
+static std::unique_ptr<ConverterSnapshot> pendingSnapshot;
+
+//! Publication is deferred while a batch is open, guarded by the registry mutex
+static size_t batchDepth(0);
+
+static ConverterSnapshot *makeInitialSnapshot(void);
+
+//! Get the latest snapshot including pending modifications (mutex held)
+static const ConverterSnapshot *latestSnapshot(void)
+{
+  if (pendingSnapshot) return pendingSnapshot.get();
+  return currentSnapshot.load(std::memory_order_relaxed);
+}
+
+//! Get a writable copy of the latest snapshot (mutex held)
+static ConverterSnapshot &beginUpdate(void)
+{
+  if (not pendingSnapshot)
+    {
+      //the copy shares the sub-tables and starts without paths,
+      //because any registration may change the cheapest paths
+      const auto *current = currentSnapshot.load(std::memory_order_relaxed);
+      pendingSnapshot.reset((current == nullptr)?makeInitialSnapshot():new ConverterSnapshot(*current));
+    }
+  return *pendingSnapshot;
+}
+
+//! Publish pending modifications unless a batch is open (mutex held)
+static void publishUpdate(void)
+{
+  if (batchDepth != 0 or not pendingSnapshot) return;
+  const ConverterSnapshot *snapshot = pendingSnapshot.get();
+  getPublishedSnapshots().emplace_back(pendingSnapshot.release());
+  currentSnapshot.store(snapshot, std::memory_order_release);
+}
+
+//! Group registrations into a single published snapshot
+struct ConverterBatch
+{
+  ConverterBatch(void):
+    lock(getRegistryMutex())
+  {
+    batchDepth++;
+  }
+
+  ~ConverterBatch(void)
+  {
+    batchDepth--;
+    publishUpdate();
+  }
+
+  std::lock_guard<std::recursive_mutex> lock;
+};
+
+static bool loadDefaultConverters(void)
+{
+  ConverterBatch batch;
+  beginUpdate();
+  lateLoadDefaultConverters();
+  return true;
+}
+
+//! Get the current snapshot after the default converters are loaded
+static const ConverterSnapshot &getSnapshot(void)
+{
+  static const bool loaded = loadDefaultConverters();
+  (void)loaded;
+  return *currentSnapshot.load(std::memory_order_acquire);
+}
+
+/*!
+ * beginConverterBatch() and endConverterBatch() are called by loadModule()
+ * so the converters of a module publish as one snapshot. The mutex is
+ * not held in between, registrations by other threads join the batch.
+ */
+void beginConverterBatch(void)
+{
+  getSnapshot();
+  std::lock_guard<std::recursive_mutex> lock(getRegistryMutex());
+  batchDepth++;
+}
+
+void endConverterBatch(void)
+{
+  std::lock_guard<std::recursive_mutex> lock(getRegistryMutex());
+  batchDepth--;
+  publishUpdate();
+}
+
+/***********************************************************************
+ * Interned formats and resolved handles
+ **********************************************************************/
+static FormatId internFormatId(ConverterSnapshot &snapshot, const std::string &format)
+{
+  const auto it = snapshot.formats->formatIds.find(format);
+  if (it != snapshot.formats->formatIds.end()) return it->second;
+
+  auto &formats = modifyTable(snapshot.formats);
+  const FormatId formatId = FormatId(formats.formatNames.size());
+  formats.formatIds[format] = formatId;
+  formats.formatNames.push_back(format);
+
+  //the rows of other sources grow when a converter to the new format is registered
+  snapshot.sources.emplace_back(new SourceConverters());
+  return formatId;
+}
+
+//! The first snapshot holds only the built-in formats and converters
+static ConverterSnapshot *makeInitialSnapshot(void)
+{
+  std::unique_ptr<ConverterSnapshot> snapshot(new ConverterSnapshot());
+  const FormatId numFormats = FormatId(getNumBuiltinFormats());
+  for (FormatId i = 0; i < numFormats; i++)
+    {
+      internFormatId(*snapshot, getBuiltinFormatName(i));
+    }
+  for (FormatId i = 0; i < numFormats; i++)
+    {
+      auto &row = *snapshot->sources[i];
+      row.resize(numFormats);
+      for (FormatId j = 0; j < numFormats; j++)
+        {
+          row.bestHandles[j] = getBuiltinConverter(i, j);
+        }
+    }
+  return snapshot.release();
+}
+
+//! Find a format id without interning it, or INVALID_FORMAT_ID
+static FormatId findFormatId(const ConverterSnapshot &snapshot, const std::string &format)
+{
+  const auto it = snapshot.formats->formatIds.find(format);
+  if (it == snapshot.formats->formatIds.end()) return SoapySDR::ConverterRegistry::INVALID_FORMAT_ID;
+  return it->second;
+}
+
+//! The highest priority handle for a source/target pair or nullptr
+static const ConverterHandle *bestHandle(const ConverterSnapshot &snapshot, const FormatId sourceFormat, const FormatId targetFormat)
+{
+  const auto &row = *snapshot.sources[sourceFormat];
+  return (targetFormat < row.size())?row.bestHandles[targetFormat]:nullptr;
+}
+
+//! The registered handles for a source/target pair in ascending priority order
+static const std::vector<const ConverterHandle *> &registeredHandles(const ConverterSnapshot &snapshot, const FormatId sourceFormat, const FormatId targetFormat)
+{
+  static const std::vector<const ConverterHandle *> none;
+  const auto &row = *snapshot.sources[sourceFormat];
+  return (targetFormat < row.size())?row.handles[targetFormat]:none;
+}
+
+//! All handles for a source/target pair in ascending priority order, including the built-in converter
+static std::vector<const ConverterHandle *> pairHandles(const ConverterSnapshot &snapshot, const FormatId sourceFormat, const FormatId targetFormat)
+{
+  auto handles = registeredHandles(snapshot, sourceFormat, targetFormat);
+  const auto *builtin = getBuiltinConverter(sourceFormat, targetFormat);
+  if (builtin != nullptr)
+    {
+      auto it = handles.begin();
+      while (it != handles.end() and (*it)->priority < builtin->priority) ++it;
+      handles.insert(it, builtin);
+    }
+  return handles;
+}
+
+//! Find the handle with the given priority for a source/target pair, or nullptr
+static const ConverterHandle *findHandle(const ConverterSnapshot &snapshot, const FormatId sourceFormat, const FormatId targetFormat, const SoapySDR::ConverterRegistry::FunctionPriority priority)
+{
+  for (const auto *handle : registeredHandles(snapshot, sourceFormat, targetFormat))
+    {
+      if (handle->priority == priority) return handle;
+    }
+  const auto *builtin = getBuiltinConverter(sourceFormat, targetFormat);
+  if (builtin != nullptr and builtin->priority == priority) return builtin;
+  return nullptr;
+}
+
+//! True when the source format has a converter to any target format
+static bool hasTargets(const ConverterSnapshot &snapshot, const FormatId sourceFormat)
+{
+  for (const auto *best : snapshot.sources[sourceFormat]->bestHandles)
+    {
+      if (best != nullptr) return true;
+    }
+  return false;
+}
+
+static const ConverterHandle *makeConverterHandle(const ConverterHandle &handle)
+{
+  //C++11 operator new does not honor extended alignment, so align the storage here.
+  //Handles are referenced by clients for the lifetime of the process and never freed.
+  const size_t alignment = alignof(ConverterHandle);
+  void *mem = std::malloc(sizeof(ConverterHandle)+alignment);
+  if (mem == nullptr) throw std::bad_alloc();
+  void *aligned = (void *)((uintptr_t(mem)+alignment) & ~uintptr_t(alignment-1));
+  return new (aligned) ConverterHandle(handle);
+}
+
+static void registerConverterHandle(ConverterSnapshot &snapshot, const std::string &sourceFormat, const std::string &targetFormat, const SoapySDR::ConverterRegistry::FunctionPriority priority, const SoapySDR::ConverterRegistry::ConverterDescriptor &descriptor)
+{
+  ConverterHandle handle;
+  handle.function = descriptor.function;
+  handle.batchFunction = descriptor.batchFunction;
+  handle.sourceElemSize = SoapySDR::formatToSize(sourceFormat);
+  handle.targetElemSize = SoapySDR::formatToSize(targetFormat);
+  handle.priority = priority;
+  handle.sourceFormat = internFormatId(snapshot, sourceFormat);
+  handle.targetFormat = internFormatId(snapshot, targetFormat);
+  handle.inPlaceSafe = descriptor.inPlaceSafe;
+  handle.clipFunction = descriptor.clipFunction;
+  handle.streamingFunction = descriptor.streamingFunction;
+
+  //inherit the clip converter from the highest lower priority handle,
+  //an in-place safe handle only inherits from other in-place safe handles
+  for (const auto *other : pairHandles(snapshot, handle.sourceFormat, handle.targetFormat))
+    {
+      if (other->priority >= priority) break;
+      if (handle.inPlaceSafe and not other->inPlaceSafe) continue;
+      if (descriptor.clipFunction == nullptr and other->clipFunction != nullptr) handle.clipFunction = other->clipFunction;
+    }
+
+  auto &row = modifyTable(snapshot.sources[handle.sourceFormat]);
+  row.resize(handle.targetFormat+1);
+  auto &handles = row.handles[handle.targetFormat];
+  auto it = handles.begin();
+  while (it != handles.end() and (*it)->priority < priority) ++it;
+  handles.insert(it, makeConverterHandle(handle));
+  row.bestHandles[handle.targetFormat] = pairHandles(snapshot, handle.sourceFormat, handle.targetFormat).back();
+
+  //a new candidate invalidates the tuned choice
+  row.tunedHandles[handle.targetFormat].store(nullptr, std::memory_order_relaxed);
+}
+
+/***********************************************************************
+ * Streaming stores: handles switch to the non-temporal converter for
+ * target buffers that would not fit in the cache alongside other data.
+ **********************************************************************/
+static size_t defaultStreamingThreshold(void)
+{
+  const auto value = getEnvImpl("SOAPY_SDR_CONVERTER_STREAMING_THRESHOLD");
+  if (not value.empty()) return size_t(std::strtoull(value.c_str(), nullptr, 10));
+  const size_t cacheSize = getLastLevelCacheSize();
+  return (cacheSize == 0)?(size_t(8) << 20):(cacheSize/4*3);
+}
+
+static std::atomic<size_t> streamingThreshold(defaultStreamingThreshold());
+
+/***********************************************************************
+ * Auto-tuning: the tuned choice for a pair is selected by tune()
+ * and stored in the snapshot, so resolutions stay lock-free lookups.
+ * Selection runs without the registry mutex, because module loading
+ * holds the module mutex while registering converters.
+ **********************************************************************/
+static std::atomic<bool> autoTuning(SoapySDR::StringToSetting<bool>(getEnvImpl("SOAPY_SDR_CONVERTER_TUNING")));
+
+static const ConverterHandle *tuneConverter(const ConverterSnapshot &snapshot, const FormatId sourceFormat, const FormatId targetFormat)
+{
+  const auto handles = pairHandles(snapshot, sourceFormat, targetFormat);
+  const auto *tuned = selectTunedConverter(snapshot.formats->formatNames[sourceFormat], snapshot.formats->formatNames[targetFormat], handles);
+
+  //store in the current and pending snapshots unless the candidates changed during selection
+  std::lock_guard<std::recursive_mutex> lock(getRegistryMutex());
+  const ConverterSnapshot *snapshots[2] = {currentSnapshot.load(std::memory_order_relaxed), pendingSnapshot.get()};
+  for (const auto *latest : snapshots)
+    {
+      if (latest == nullptr or pairHandles(*latest, sourceFormat, targetFormat) != handles) continue;
+      const auto &row = *latest->sources[sourceFormat];
+      if (targetFormat < row.size()) row.tunedHandles[targetFormat].store(tuned, std::memory_order_release);
+    }
+  return tuned;
+}
+
+/***********************************************************************
+ * Multi-hop paths: formats are the nodes of a graph and the converter
+ * of each source/target pair is an edge. The cheapest path is found
+ * with Dijkstra's algorithm over the immutable snapshot. Intermediate
+ * formats must keep the precision of the source and target, so that
+ * CS16 -> CS8 -> CF32 is never chosen over a wider intermediate.
+ **********************************************************************/
+//! Paths longer than this are not considered
+static const size_t MAX_PATH_HOPS = 4;
+
+//! Bytes of each ping-pong scratch buffer, sized for the L1 cache
+static const size_t PATH_SCRATCH_BYTES = 16*1024;
+
+//! Significant bits of a format component, or 0 when unknown
+static size_t formatPrecision(const std::string &format)
+{
+  size_t bits(0);
+  for (const char ch : format)
+    {
+      if (std::isdigit(ch)) bits = (bits*10) + size_t(ch-'0');
+    }
+  if (format.find('F') == std::string::npos) return bits;
+  if (bits == 16) return 11;
+  if (bits == 32) return 24;
+  if (bits == 64) return 53;
+  return bits;
+}
+
+//! Select the converter and its cost for an edge, or nullptr when none is registered
+static const ConverterHandle *pathEdge(const ConverterSnapshot &snapshot, const FormatId sourceFormat, const FormatId targetFormat, const bool measured, double &cost)
+{
+  const auto *best = bestHandle(snapshot, sourceFormat, targetFormat);
+  if (best == nullptr) return nullptr;
+
+  //declared cost: bytes moved per element, discounted by priority
+  cost = double(best->sourceElemSize + best->targetElemSize)/(1 + std::max(int(best->priority), 0));
+  if (not measured) return best;
+
+  //measured cost: the fastest of the priorities for cache-resident blocks
+  const auto handles = pairHandles(snapshot, sourceFormat, targetFormat);
+  for (auto it = handles.rbegin(); it != handles.rend(); ++it)
+    {
+      const double ns = measureConverterCost(snapshot.formats->formatNames[sourceFormat], *it);
+      if (ns < 0.0) return best;
+      if (it == handles.rbegin() or ns < cost)
+        {
+          cost = ns;
+          best = *it;
+        }
+    }
+  return best;
+}
+
+//! Marks a pair without a path in the path tables
+static const ConverterPath unconnectedPath = ConverterPath();
+
+//! Storage for every resolved path by whether its cost was measured, guarded by the registry mutex
+static std::vector<std::unique_ptr<const ConverterPath>> &getResolvedPaths(const bool measured)
+{
+  static std::vector<std::unique_ptr<const ConverterPath>> paths[2];
+  return paths[measured?1:0];
+}
+
+//! Keep a path for the lifetime of the library, reusing a path with the same hops (mutex held)
+static const ConverterPath *keepConverterPath(std::unique_ptr<ConverterPath> path, const bool measured)
+{
+  if (not path) return &unconnectedPath;
+  auto &paths = getResolvedPaths(measured);
+  for (const auto &other : paths)
+    {
+      if (other->hops == path->hops) return other.get();
+    }
+  paths.emplace_back(path.release());
+  return paths.back().get();
+}
+
+static std::unique_ptr<ConverterPath> findConverterPath(const ConverterSnapshot &snapshot, const FormatId sourceFormat, const FormatId targetFormat, const bool measured)
+{
+  const auto &formatNames = snapshot.formats->formatNames;
+  const size_t numFormats = formatNames.size();
+  if (sourceFormat >= numFormats or targetFormat >= numFormats) return nullptr;
+
+  const size_t minPrecision = std::min(formatPrecision(formatNames[sourceFormat]), formatPrecision(formatNames[targetFormat]));
+  std::vector<double> costs(numFormats, std::numeric_limits<double>::infinity());
+  std::vector<const ConverterHandle *> via(numFormats, nullptr);
+  std::vector<size_t> numHops(numFormats, 0);
+  std::vector<bool> visited(numFormats, false);
+  costs[sourceFormat] = 0.0;
+
+  if (sourceFormat == targetFormat)
+    {
+      //only a registered direct converter can connect a format to itself
+      double cost(0.0);
+      via[targetFormat] = pathEdge(snapshot, sourceFormat, targetFormat, measured, cost);
+      costs[targetFormat] = cost;
+      numHops[targetFormat] = 1;
+    }
+
+  while (sourceFormat != targetFormat)
+    {
+      FormatId u = FormatId(numFormats);
+      for (FormatId i = 0; i < numFormats; i++)
+        {
+          if (visited[i] or costs[i] == std::numeric_limits<double>::infinity()) continue;
+          if (u == numFormats or costs[i] < costs[u]) u = i;
+        }
+      if (u == numFormats or u == targetFormat) break;
+      visited[u] = true;
+      if (numHops[u] == MAX_PATH_HOPS) continue;
+
+      for (FormatId v = 0; v < numFormats; v++)
+        {
+          if (visited[v] or v == sourceFormat) continue;
+          const auto &name = formatNames[v];
+          if (v != targetFormat and (SoapySDR::formatToSize(name) == 0 or formatPrecision(name) < minPrecision)) continue;
+
+          double cost(0.0);
+          const auto *edge = pathEdge(snapshot, u, v, measured, cost);
+          if (edge == nullptr or costs[u]+cost >= costs[v]) continue;
+          costs[v] = costs[u]+cost;
+          via[v] = edge;
+          numHops[v] = numHops[u]+1;
+        }
+    }
+
+  if (via[targetFormat] == nullptr) return nullptr;
+
+  std::unique_ptr<ConverterPath> path(new ConverterPath());
+  path->cost = costs[targetFormat];
+  for (const auto *edge = via[targetFormat]; ; edge = via[edge->sourceFormat])
+    {
+      path->hops.insert(path->hops.begin(), edge);
+      if (edge->sourceFormat == sourceFormat) break;
+    }
+
+  //scale once, on the first hop into floating point where no range is lost
+  path->scalerHop = path->hops.size()-1;
+  size_t maxElemSize(1);
+  for (size_t i = 0; i < path->hops.size(); i++)
+    {
+      const auto &target = formatNames[path->hops[i]->targetFormat];
+      if (target.find('F') != std::string::npos and path->scalerHop == path->hops.size()-1) path->scalerHop = i;
+      if (i+1 < path->hops.size()) maxElemSize = std::max(maxElemSize, path->hops[i]->targetElemSize);
+    }
+
+  //blocks are a multiple of 16 elements for the vectorized kernels
+  path->blockElems = std::max<size_t>((PATH_SCRATCH_BYTES/maxElemSize) & ~size_t(15), 16);
+  return path;
+}
+
+/***********************************************************************
+ * String lookup helpers that never modify the snapshot
+ **********************************************************************/
+static const ChannelConverterPriority *findChannelPriorities(const ConverterSnapshot &snapshot, const std::string &sourceFormat, const std::string &targetFormat, const SoapySDR::ConverterRegistry::ChannelLayout layout)
+{
+  const auto &converters = *snapshot.channelConverters[layout];
+  const auto it = converters.find(sourceFormat);
+  if (it == converters.end()) return nullptr;
+  const auto jt = it->second.find(targetFormat);
+  if (jt == it->second.end()) return nullptr;
+  return &jt->second;
+}
+
+//! Find the priorities in a source/target/priority map of correction or stats converters
+template <typename Converters>
+static const typename Converters::mapped_type::mapped_type *findTypedPriorities(const Converters &converters, const std::string &sourceFormat, const std::string &targetFormat)
+{
+  const auto it = converters.find(sourceFormat);
+  if (it == converters.end()) return nullptr;
+  const auto jt = it->second.find(targetFormat);
+  if (jt == it->second.end()) return nullptr;
+  return &jt->second;
+}
+
+static std::string channelLayoutName(const SoapySDR::ConverterRegistry::ChannelLayout layout)
+{
+  return (layout == SoapySDR::ConverterRegistry::DEINTERLEAVE)?"DEINTERLEAVE":"INTERLEAVE";
+}
+
+static SoapySDR::ConverterRegistry::ConverterDescriptor functionDescriptor(const SoapySDR::ConverterRegistry::ConverterFunction function)
+{
+  SoapySDR::ConverterRegistry::ConverterDescriptor descriptor;
+  descriptor.function = function;
+  return descriptor;
+}
+
+/***********************************************************************
+ * ConverterRegistry API
+ **********************************************************************/
+SoapySDR::ConverterRegistry::ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority, ConverterFunction converterFunction):
+  ConverterRegistry(sourceFormat, targetFormat, priority, functionDescriptor(converterFunction))
+{
+  return;
+}
+
+SoapySDR::ConverterRegistry::ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority, const ConverterDescriptor &descriptor)
 {
-  if (formatConverters.count(sourceFormat) == 0)
-    ;
-  else if (formatConverters[sourceFormat].count(targetFormat) == 0)
-    ;
-  else if (formatConverters[sourceFormat][targetFormat].count(priority) != 0)
+  if (descriptor.function == nullptr)
+    {
+      SoapySDR::logf(SOAPY_SDR_ERROR, "SoapySDR::ConverterRegistry(%s, %s, %s) missing converter function", sourceFormat.c_str(), targetFormat.c_str(), std::to_string(priority).c_str());
+      return;
+    }
+
+  std::lock_guard<std::recursive_mutex> lock(getRegistryMutex());
+
+  //the latest snapshot includes the built-in converters
+  auto &snapshot = beginUpdate();
+  const auto sourceId = findFormatId(snapshot, sourceFormat);
+  const auto targetId = findFormatId(snapshot, targetFormat);
+  if (sourceId != INVALID_FORMAT_ID and targetId != INVALID_FORMAT_ID and findHandle(snapshot, sourceId, targetId, priority) != nullptr)
     {
       SoapySDR::logf(SOAPY_SDR_ERROR, "SoapySDR::ConverterRegistry(%s, %s, %s) duplicate registration", sourceFormat.c_str(), targetFormat.c_str(), std::to_string(priority).c_str());
       return;
     }
-  
-  formatConverters[sourceFormat][targetFormat][priority] = converterFunction;
+
+  registerConverterHandle(snapshot, sourceFormat, targetFormat, priority, descriptor);
+  publishUpdate();
+
+  return;
+}
+
+SoapySDR::ConverterRegistry::ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const ChannelLayout &layout, const FunctionPriority &priority, BatchConverterFunction converterFunction)
+{
+  if (layout != DEINTERLEAVE and layout != INTERLEAVE)
+    {
+      SoapySDR::logf(SOAPY_SDR_ERROR, "SoapySDR::ConverterRegistry(%s, %s, layout=%d) unknown channel layout", sourceFormat.c_str(), targetFormat.c_str(), int(layout));
+      return;
+    }
+
+  std::lock_guard<std::recursive_mutex> lock(getRegistryMutex());
+
+  const auto *latest = latestSnapshot();
+  if (latest != nullptr)
+    {
+      const auto *priorities = findChannelPriorities(*latest, sourceFormat, targetFormat, layout);
+      if (priorities != nullptr and priorities->count(priority) != 0)
+        {
+          SoapySDR::logf(SOAPY_SDR_ERROR, "SoapySDR::ConverterRegistry(%s, %s, %s, %s) duplicate registration", sourceFormat.c_str(), targetFormat.c_str(), channelLayoutName(layout).c_str(), std::to_string(priority).c_str());
+          return;
+        }
+    }
+
+  auto &snapshot = beginUpdate();
+  modifyTable(snapshot.channelConverters[layout])[sourceFormat][targetFormat][priority] = converterFunction;
+  publishUpdate();
+
+  return;
+}
+
+SoapySDR::ConverterRegistry::ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority, CorrectionConverterFunction converterFunction)
+{
+  std::lock_guard<std::recursive_mutex> lock(getRegistryMutex());
+
+  const auto *latest = latestSnapshot();
+  if (latest != nullptr)
+    {
+      const auto *priorities = findTypedPriorities(*latest->correctionConverters, sourceFormat, targetFormat);
+      if (priorities != nullptr and priorities->count(priority) != 0)
+        {
+          SoapySDR::logf(SOAPY_SDR_ERROR, "SoapySDR::ConverterRegistry(%s, %s, %s) duplicate correction registration", sourceFormat.c_str(), targetFormat.c_str(), std::to_string(priority).c_str());
+          return;
+        }
+    }
+
+  auto &snapshot = beginUpdate();
+  modifyTable(snapshot.correctionConverters)[sourceFormat][targetFormat][priority] = converterFunction;
+  publishUpdate();
+
+  return;
+}
+
+SoapySDR::ConverterRegistry::ConverterRegistry(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority, StatsConverterFunction converterFunction)
+{
+  std::lock_guard<std::recursive_mutex> lock(getRegistryMutex());
+
+  const auto *latest = latestSnapshot();
+  if (latest != nullptr)
+    {
+      const auto *priorities = findTypedPriorities(*latest->statsConverters, sourceFormat, targetFormat);
+      if (priorities != nullptr and priorities->count(priority) != 0)
+        {
+          SoapySDR::logf(SOAPY_SDR_ERROR, "SoapySDR::ConverterRegistry(%s, %s, %s) duplicate stats registration", sourceFormat.c_str(), targetFormat.c_str(), std::to_string(priority).c_str());
+          return;
+        }
+    }
+
+  auto &snapshot = beginUpdate();
+  modifyTable(snapshot.statsConverters)[sourceFormat][targetFormat][priority] = converterFunction;
+  publishUpdate();
 
   return;
 }
 
 std::vector<std::string> SoapySDR::ConverterRegistry::listTargetFormats(const std::string &sourceFormat)
 {
-  lateLoadDefaultConverters();
+  const auto &snapshot = getSnapshot();
 
   std::vector<std::string> targets;
 
-  if (formatConverters.count(sourceFormat) == 0)
+  const auto sourceId = findFormatId(snapshot, sourceFormat);
+  if (sourceId == INVALID_FORMAT_ID)
     return targets;
 
-  for(const auto &it:formatConverters[sourceFormat])
+  const auto &formatNames = snapshot.formats->formatNames;
+  for (FormatId targetId = 0; targetId < formatNames.size(); targetId++)
     {
-      std::string targetFormat = it.first;
-      targets.push_back(targetFormat);
+      if (bestHandle(snapshot, sourceId, targetId) != nullptr)
+        targets.push_back(formatNames[targetId]);
     }
-  
+
   std::sort(targets.begin(), targets.end());
   return targets;
 }
 
 std::vector<std::string> SoapySDR::ConverterRegistry::listSourceFormats(const std::string &targetFormat)
 {
-  lateLoadDefaultConverters();
+  const auto &snapshot = getSnapshot();
 
   std::vector<std::string> sources;
 
-  for(const auto &it:formatConverters)
+  const auto targetId = findFormatId(snapshot, targetFormat);
+  if (targetId == INVALID_FORMAT_ID)
+    return sources;
+
+  const auto &formatNames = snapshot.formats->formatNames;
+  for (FormatId sourceId = 0; sourceId < formatNames.size(); sourceId++)
     {
-      std::string sourceFormat = it.first;
-      if (formatConverters[sourceFormat].count(targetFormat) > 0)
-        sources.push_back(sourceFormat);
+      if (bestHandle(snapshot, sourceId, targetId) != nullptr)
+        sources.push_back(formatNames[sourceId]);
     }
-  
+
   std::sort(sources.begin(), sources.end());
   return sources;
 }
 
 std::vector<SoapySDR::ConverterRegistry::FunctionPriority> SoapySDR::ConverterRegistry::listPriorities(const std::string &sourceFormat, const std::string &targetFormat)
 {
-  lateLoadDefaultConverters();
+  const auto &snapshot = getSnapshot();
 
   std::vector<FunctionPriority> priorities;
-  
-  if (formatConverters.count(sourceFormat) == 0)
-    ;
-  else if (formatConverters[sourceFormat].count(targetFormat) == 0)
-    ;
-  else if (formatConverters[sourceFormat][targetFormat].size() == 0)
-    ;
-  else
-    {
-      for(const auto &it:formatConverters[sourceFormat][targetFormat])
-        {
-          FunctionPriority priority = it.first;
-          priorities.push_back(priority);
-        }
+
+  const auto sourceId = findFormatId(snapshot, sourceFormat);
+  const auto targetId = findFormatId(snapshot, targetFormat);
+  if (sourceId == INVALID_FORMAT_ID or targetId == INVALID_FORMAT_ID)
+    return priorities;
+
+  for (const auto *handle : pairHandles(snapshot, sourceId, targetId))
+    {
+      priorities.push_back(handle->priority);
     }
-  
+
   return priorities;
-  
 }
 
 SoapySDR::ConverterRegistry::ConverterFunction SoapySDR::ConverterRegistry::getFunction(const std::string &sourceFormat, const std::string &targetFormat)
 {
-  lateLoadDefaultConverters();
+  const auto &snapshot = getSnapshot();
 
-  if (formatConverters.count(sourceFormat) == 0)
+  const auto sourceId = findFormatId(snapshot, sourceFormat);
+  if (sourceId == INVALID_FORMAT_ID or not hasTargets(snapshot, sourceId))
     {
       throw std::runtime_error("ConverterRegistry::getFunction() conversion source not registered; "
                                "sourceFormat="+sourceFormat+", targetFormat="+targetFormat);
     }
-  
-  if (formatConverters[sourceFormat].count(targetFormat) == 0)
+
+  const auto targetId = findFormatId(snapshot, targetFormat);
+  const auto *best = (targetId == INVALID_FORMAT_ID)?nullptr:bestHandle(snapshot, sourceId, targetId);
+  if (best == nullptr)
     {
       throw std::runtime_error("ConverterRegistry::getFunction() conversion target not registered; "
                                "sourceFormat="+sourceFormat+", targetFormat="+targetFormat);
     }
 
-  if (formatConverters[sourceFormat][targetFormat].size() == 0)
+  if (autoTuning.load(std::memory_order_relaxed))
     {
-      throw std::runtime_error("ConverterRegistry::getFunction() no functions found for registered conversion; "
-                               "sourceFormat="+sourceFormat+", targetFormat="+targetFormat);
+      const auto *handle = tune(sourceId, targetId);
+      if (handle != nullptr) return handle->function;
     }
 
-  return formatConverters[sourceFormat][targetFormat].rbegin()->second;
+  return best->function;
 }
 
 SoapySDR::ConverterRegistry::ConverterFunction SoapySDR::ConverterRegistry::getFunction(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority)
 {
-  lateLoadDefaultConverters();
+  const auto &snapshot = getSnapshot();
 
-  if (formatConverters.count(sourceFormat) == 0)
+  const auto sourceId = findFormatId(snapshot, sourceFormat);
+  if (sourceId == INVALID_FORMAT_ID or not hasTargets(snapshot, sourceId))
     {
       throw std::runtime_error("ConverterRegistry::getFunction() conversion source not registered; "
                                "sourceFormat="+sourceFormat+", targetFormat="+targetFormat+", priority="+std::to_string(priority));
     }
 
-  if (formatConverters[sourceFormat].count(targetFormat) == 0)
+  const auto targetId = findFormatId(snapshot, targetFormat);
+  if (targetId == INVALID_FORMAT_ID or bestHandle(snapshot, sourceId, targetId) == nullptr)
     {
       throw std::runtime_error("ConverterRegistry::getFunction() conversion target not registered; "
                                "sourceFormat="+sourceFormat+", targetFormat="+targetFormat+", priority="+std::to_string(priority));
     }
 
-  if (formatConverters[sourceFormat][targetFormat].count(priority) == 0)
+  const auto *handle = findHandle(snapshot, sourceId, targetId, priority);
+  if (handle == nullptr)
     {
       throw std::runtime_error("ConverterRegistry::getFunction() conversion priority not registered; "
                                "sourceFormat="+sourceFormat+", targetFormat="+targetFormat+", priority="+std::to_string(priority));
     }
 
-  return formatConverters[sourceFormat][targetFormat][priority];
+  return handle->function;
 }
 
 std::vector<std::string> SoapySDR::ConverterRegistry::listAvailableSourceFormats(void)
 {
-    lateLoadDefaultConverters();
+    const auto &snapshot = getSnapshot();
 
     std::vector<std::string> sources;
-    for (const auto &it : formatConverters)
+    const auto &formatNames = snapshot.formats->formatNames;
+    for (FormatId sourceId = 0; sourceId < formatNames.size(); sourceId++)
     {
-        if (std::find(sources.begin(), sources.end(), it.first) == sources.end())
+        if (hasTargets(snapshot, sourceId))
         {
-            sources.push_back(it.first);
+            sources.push_back(formatNames[sourceId]);
         }
     }
     std::sort(sources.begin(), sources.end());
     return sources;
 }
+
+std::vector<SoapySDR::ConverterRegistry::FunctionPriority> SoapySDR::ConverterRegistry::listPriorities(const std::string &sourceFormat, const std::string &targetFormat, const ChannelLayout &layout)
+{
+  const auto &snapshot = getSnapshot();
+
+  std::vector<FunctionPriority> priorities;
+
+  const auto *targetPriorities = findChannelPriorities(snapshot, sourceFormat, targetFormat, layout);
+  if (targetPriorities == nullptr)
+    return priorities;
+
+  for(const auto &it:*targetPriorities)
+    {
+      priorities.push_back(it.first);
+    }
+
+  return priorities;
+}
+
+SoapySDR::ConverterRegistry::BatchConverterFunction SoapySDR::ConverterRegistry::getFunction(const std::string &sourceFormat, const std::string &targetFormat, const ChannelLayout &layout)
+{
+  const auto &snapshot = getSnapshot();
+
+  const auto *targetPriorities = findChannelPriorities(snapshot, sourceFormat, targetFormat, layout);
+  if (targetPriorities == nullptr or targetPriorities->empty())
+    {
+      throw std::runtime_error("ConverterRegistry::getFunction() channel conversion not registered; "
+                               "sourceFormat="+sourceFormat+", targetFormat="+targetFormat+", layout="+channelLayoutName(layout));
+    }
+
+  return targetPriorities->rbegin()->second;
+}
+
+SoapySDR::ConverterRegistry::BatchConverterFunction SoapySDR::ConverterRegistry::getFunction(const std::string &sourceFormat, const std::string &targetFormat, const ChannelLayout &layout, const FunctionPriority &priority)
+{
+  const auto &snapshot = getSnapshot();
+
+  const auto *targetPriorities = findChannelPriorities(snapshot, sourceFormat, targetFormat, layout);
+  if (targetPriorities == nullptr)
+    {
+      throw std::runtime_error("ConverterRegistry::getFunction() channel conversion not registered; "
+                               "sourceFormat="+sourceFormat+", targetFormat="+targetFormat+", layout="+channelLayoutName(layout));
+    }
+
+  const auto it = targetPriorities->find(priority);
+  if (it == targetPriorities->end())
+    {
+      throw std::runtime_error("ConverterRegistry::getFunction() channel conversion priority not registered; "
+                               "sourceFormat="+sourceFormat+", targetFormat="+targetFormat+", layout="+channelLayoutName(layout)+", priority="+std::to_string(priority));
+    }
+
+  return it->second;
+}
+
+std::vector<SoapySDR::ConverterRegistry::FunctionPriority> SoapySDR::ConverterRegistry::listCorrectionPriorities(const std::string &sourceFormat, const std::string &targetFormat)
+{
+  const auto &snapshot = getSnapshot();
+
+  std::vector<FunctionPriority> priorities;
+
+  const auto *targetPriorities = findTypedPriorities(*snapshot.correctionConverters, sourceFormat, targetFormat);
+  if (targetPriorities == nullptr)
+    return priorities;
+
+  for(const auto &it:*targetPriorities)
+    {
+      priorities.push_back(it.first);
+    }
+
+  return priorities;
+}
+
+SoapySDR::ConverterRegistry::CorrectionConverterFunction SoapySDR::ConverterRegistry::getCorrectionFunction(const std::string &sourceFormat, const std::string &targetFormat)
+{
+  const auto &snapshot = getSnapshot();
+
+  const auto *targetPriorities = findTypedPriorities(*snapshot.correctionConverters, sourceFormat, targetFormat);
+  if (targetPriorities == nullptr or targetPriorities->empty())
+    {
+      throw std::runtime_error("ConverterRegistry::getCorrectionFunction() correction conversion not registered; "
+                               "sourceFormat="+sourceFormat+", targetFormat="+targetFormat);
+    }
+
+  return targetPriorities->rbegin()->second;
+}
+
+SoapySDR::ConverterRegistry::CorrectionConverterFunction SoapySDR::ConverterRegistry::getCorrectionFunction(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority)
+{
+  const auto &snapshot = getSnapshot();
+
+  const auto *targetPriorities = findTypedPriorities(*snapshot.correctionConverters, sourceFormat, targetFormat);
+  if (targetPriorities == nullptr)
+    {
+      throw std::runtime_error("ConverterRegistry::getCorrectionFunction() correction conversion not registered; "
+                               "sourceFormat="+sourceFormat+", targetFormat="+targetFormat);
+    }
+
+  const auto it = targetPriorities->find(priority);
+  if (it == targetPriorities->end())
+    {
+      throw std::runtime_error("ConverterRegistry::getCorrectionFunction() correction conversion priority not registered; "
+                               "sourceFormat="+sourceFormat+", targetFormat="+targetFormat+", priority="+std::to_string(priority));
+    }
+
+  return it->second;
+}
+
+std::vector<SoapySDR::ConverterRegistry::FunctionPriority> SoapySDR::ConverterRegistry::listStatsPriorities(const std::string &sourceFormat, const std::string &targetFormat)
+{
+  const auto &snapshot = getSnapshot();
+
+  std::vector<FunctionPriority> priorities;
+
+  const auto *targetPriorities = findTypedPriorities(*snapshot.statsConverters, sourceFormat, targetFormat);
+  if (targetPriorities == nullptr)
+    return priorities;
+
+  for(const auto &it:*targetPriorities)
+    {
+      priorities.push_back(it.first);
+    }
+
+  return priorities;
+}
+
+SoapySDR::ConverterRegistry::StatsConverterFunction SoapySDR::ConverterRegistry::getStatsFunction(const std::string &sourceFormat, const std::string &targetFormat)
+{
+  const auto &snapshot = getSnapshot();
+
+  const auto *targetPriorities = findTypedPriorities(*snapshot.statsConverters, sourceFormat, targetFormat);
+  if (targetPriorities == nullptr or targetPriorities->empty())
+    {
+      throw std::runtime_error("ConverterRegistry::getStatsFunction() stats conversion not registered; "
+                               "sourceFormat="+sourceFormat+", targetFormat="+targetFormat);
+    }
+
+  return targetPriorities->rbegin()->second;
+}
+
+SoapySDR::ConverterRegistry::StatsConverterFunction SoapySDR::ConverterRegistry::getStatsFunction(const std::string &sourceFormat, const std::string &targetFormat, const FunctionPriority &priority)
+{
+  const auto &snapshot = getSnapshot();
+
+  const auto *targetPriorities = findTypedPriorities(*snapshot.statsConverters, sourceFormat, targetFormat);
+  if (targetPriorities == nullptr)
+    {
+      throw std::runtime_error("ConverterRegistry::getStatsFunction() stats conversion not registered; "
+                               "sourceFormat="+sourceFormat+", targetFormat="+targetFormat);
+    }
+
+  const auto it = targetPriorities->find(priority);
+  if (it == targetPriorities->end())
+    {
+      throw std::runtime_error("ConverterRegistry::getStatsFunction() stats conversion priority not registered; "
+                               "sourceFormat="+sourceFormat+", targetFormat="+targetFormat+", priority="+std::to_string(priority));
+    }
+
+  return it->second;
+}
+
+SoapySDR::ConverterRegistry::FormatId SoapySDR::ConverterRegistry::internFormat(const std::string &format)
+{
+  const auto &snapshot = getSnapshot();
+
+  const auto formatId = findFormatId(snapshot, format);
+  if (formatId != INVALID_FORMAT_ID) return formatId;
+
+  //a format without converters resolves to nothing, so it waits
+  //in the pending snapshot until the next registration publishes
+  std::lock_guard<std::recursive_mutex> lock(getRegistryMutex());
+  return internFormatId(beginUpdate(), format);
+}
+
+std::string SoapySDR::ConverterRegistry::getFormatString(const FormatId formatId)
+{
+  const auto &snapshot = getSnapshot();
+  if (formatId < snapshot.formats->formatNames.size()) return snapshot.formats->formatNames[formatId];
+
+  //the format may be interned but not yet published
+  std::lock_guard<std::recursive_mutex> lock(getRegistryMutex());
+  const auto *latest = latestSnapshot();
+  if (formatId >= latest->formats->formatNames.size()) return "";
+  return latest->formats->formatNames[formatId];
+}
+
+const SoapySDR::ConverterRegistry::ConverterHandle *SoapySDR::ConverterRegistry::resolve(const FormatId sourceFormat, const FormatId targetFormat) noexcept
+{
+  const auto *snapshot = currentSnapshot.load(std::memory_order_acquire);
+  if (snapshot == nullptr) return nullptr;
+  if (sourceFormat >= snapshot->sources.size()) return nullptr;
+  const auto &row = *snapshot->sources[sourceFormat];
+  if (targetFormat >= row.size()) return nullptr;
+  const auto *best = row.bestHandles[targetFormat];
+  if (best == nullptr or not autoTuning.load(std::memory_order_relaxed)) return best;
+
+  const auto *tuned = row.tunedHandles[targetFormat].load(std::memory_order_acquire);
+  return (tuned == nullptr)?best:tuned;
+}
+
+const SoapySDR::ConverterRegistry::ConverterHandle *SoapySDR::ConverterRegistry::resolve(const FormatId sourceFormat, const FormatId targetFormat, const FunctionPriority &priority) noexcept
+{
+  const auto *snapshot = currentSnapshot.load(std::memory_order_acquire);
+  if (snapshot == nullptr) return nullptr;
+  const size_t numFormats = snapshot->sources.size();
+  if (sourceFormat >= numFormats or targetFormat >= numFormats) return nullptr;
+  return findHandle(*snapshot, sourceFormat, targetFormat, priority);
+}
+
+const SoapySDR::ConverterRegistry::ConverterHandle *SoapySDR::ConverterRegistry::tune(const FormatId sourceFormat, const FormatId targetFormat)
+{
+  const auto &snapshot = getSnapshot();
+  if (sourceFormat >= snapshot.sources.size()) return nullptr;
+  const auto &row = *snapshot.sources[sourceFormat];
+  if (targetFormat >= row.size() or row.bestHandles[targetFormat] == nullptr) return nullptr;
+
+  const auto *tuned = row.tunedHandles[targetFormat].load(std::memory_order_acquire);
+  if (tuned != nullptr) return tuned;
+  return tuneConverter(snapshot, sourceFormat, targetFormat);
+}
+
+void SoapySDR::ConverterRegistry::setAutoTuning(const bool enable)
+{
+  autoTuning.store(enable);
+}
+
+bool SoapySDR::ConverterRegistry::getAutoTuning(void)
+{
+  return autoTuning.load();
+}
+
+std::string SoapySDR::ConverterRegistry::getTuningCachePath(void)
+{
+  return getConverterTuningCachePath();
+}
+
+void SoapySDR::ConverterRegistry::setStreamingThreshold(const size_t numBytes)
+{
+  streamingThreshold.store(numBytes, std::memory_order_relaxed);
+}
+
+size_t SoapySDR::ConverterRegistry::getStreamingThreshold(void)
+{
+  return streamingThreshold.load(std::memory_order_relaxed);
+}
+
+const SoapySDR::ConverterRegistry::ConverterPath *SoapySDR::ConverterRegistry::resolvePath(const FormatId sourceFormat, const FormatId targetFormat)
+{
+  const auto &snapshot = getSnapshot();
+  const bool measured = autoTuning.load(std::memory_order_relaxed);
+  const size_t numFormats = snapshot.sources.size();
+  if (sourceFormat >= numFormats or targetFormat >= numFormats) return nullptr;
+
+  //paths are cached in the snapshot, so later resolutions stay lock-free
+  auto &paths = snapshot.paths[measured?1:0];
+  auto *table = paths.load(std::memory_order_acquire);
+  const auto *path = (table == nullptr)?nullptr:table->at(sourceFormat, targetFormat).load(std::memory_order_acquire);
+  if (path != nullptr) return (path == &unconnectedPath)?nullptr:path;
+
+  //the search runs without the registry mutex, because measuring costs may take a while
+  auto found = findConverterPath(snapshot, sourceFormat, targetFormat, measured);
+  std::lock_guard<std::recursive_mutex> lock(getRegistryMutex());
+  if (table == nullptr) table = paths.load(std::memory_order_relaxed);
+  if (table == nullptr)
+    {
+      table = new AtomicTable<const ConverterPath *>(numFormats);
+      paths.store(table, std::memory_order_release);
+    }
+  auto &cached = table->at(sourceFormat, targetFormat);
+  path = cached.load(std::memory_order_relaxed);
+  if (path == nullptr)
+    {
+      path = keepConverterPath(std::move(found), measured);
+      cached.store(path, std::memory_order_release);
+    }
+  return (path == &unconnectedPath)?nullptr:path;
+}
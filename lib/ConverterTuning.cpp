@@ -0,0 +1,367 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConverterTuning.hpp"
+#include "CPUFeatures.hpp"
+#include <SoapySDR/Modules.hpp>
+#include <SoapySDR/Version.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+std::string getEnvImpl(const char *name);
+
+typedef SoapySDR::ConverterRegistry::ConverterHandle ConverterHandle;
+
+/***********************************************************************
+ * Measurement parameters
+ **********************************************************************/
+//! Representative buffer sizes: a cache-resident and a typical stream MTU
+static const size_t TUNING_NUM_ELEMS[] = {1024, 65536};
+
+//! Elements converted per timed trial, so small buffers are repeated
+static const size_t TUNING_ELEMS_PER_TRIAL = 1 << 18;
+
+//! The best of several trials rejects preemption and frequency ramps
+static const size_t TUNING_NUM_TRIALS = 5;
+
+//! A lower priority must be this much faster to be selected over a higher one
+static const double TUNING_MIN_SPEEDUP = 1.05;
+
+/***********************************************************************
+ * Cache key and location
+ **********************************************************************/
+static std::string getTuningCacheKey(void)
+{
+    //choices depend on the CPU, this library, and the converters that modules provide
+    std::string key = "cpu=" + getCPUModel();
+    key += ";lib=" + SoapySDR::getLibVersion();
+    key += ";abi=" + SoapySDR::getABIVersion();
+    key += ";modules=";
+    auto modules = SoapySDR::listModules();
+    std::sort(modules.begin(), modules.end());
+    for (const auto &path : modules)
+    {
+        key += path + "@" + SoapySDR::getModuleVersion(path) + ",";
+    }
+    return key;
+}
+
+//! FNV-1a hash, stable across builds and platforms unlike std::hash
+static uint64_t hashKey(const std::string &key)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const char ch : key)
+    {
+        hash ^= uint8_t(ch);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static std::string getTuningCacheDirectory(void)
+{
+    const std::string dir = getEnvImpl("SOAPY_SDR_CONVERTER_TUNING_CACHE");
+    if (not dir.empty()) return dir;
+
+#ifdef _WIN32
+    const std::string localAppData = getEnvImpl("LOCALAPPDATA");
+    if (not localAppData.empty()) return localAppData + "\\SoapySDR";
+#else
+    const std::string xdgCache = getEnvImpl("XDG_CACHE_HOME");
+    if (not xdgCache.empty()) return xdgCache + "/SoapySDR";
+    const std::string home = getEnvImpl("HOME");
+    if (not home.empty()) return home + "/.cache/SoapySDR";
+#endif
+    return "";
+}
+
+static void makeDirectories(const std::string &dir)
+{
+    for (size_t pos = 1; pos <= dir.size(); pos++)
+    {
+        if (pos != dir.size() and dir[pos] != '/' and dir[pos] != '\\') continue;
+        const std::string path = dir.substr(0, pos);
+#ifdef _WIN32
+        _mkdir(path.c_str());
+#else
+        mkdir(path.c_str(), 0755);
+#endif
+    }
+}
+
+std::string getConverterTuningCachePath(void)
+{
+    const std::string dir = getTuningCacheDirectory();
+    if (dir.empty()) return "";
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "converter_tuning_%016llx.txt", (unsigned long long)hashKey(getTuningCacheKey()));
+    return dir + "/" + name;
+}
+
+/***********************************************************************
+ * Cache file format, one line per source/target pair:
+ * "source target selectedPriority candidate,candidate,..."
+ * The first lines are comments, including the full cache key,
+ * which is checked on load to reject hash collisions.
+ **********************************************************************/
+struct TunedEntry
+{
+    int priority;
+    std::vector<int> candidates;
+};
+
+typedef std::map<std::pair<std::string, std::string>, TunedEntry> TunedEntries;
+
+struct TuningCache
+{
+    TuningCache(void):
+        loaded(false)
+    {
+        return;
+    }
+
+    bool loaded;
+    std::string key;
+    std::string path;
+    TunedEntries entries;
+};
+
+static std::string candidatesToString(const std::vector<int> &candidates)
+{
+    std::string out;
+    for (const int p : candidates) out += (out.empty()?"":",") + std::to_string(p);
+    return out;
+}
+
+static bool validFormat(const std::string &format)
+{
+    return not format.empty() and format.find_first_of(" \t\r\n") == std::string::npos;
+}
+
+static TunedEntries readCacheFile(const std::string &path, const std::string &key)
+{
+    TunedEntries entries;
+    std::ifstream file(path);
+    std::string line;
+    bool keyMatches(false);
+    while (std::getline(file, line))
+    {
+        if (line.compare(0, 7, "# key: ") == 0) keyMatches = (line.substr(7) == key);
+        if (line.empty() or line[0] == '#') continue;
+        if (not keyMatches) break;
+
+        std::stringstream ss(line);
+        std::string source, target, candidates;
+        TunedEntry entry;
+        if (not (ss >> source >> target >> entry.priority >> candidates)) continue;
+        std::stringstream cs(candidates);
+        std::string candidate;
+        while (std::getline(cs, candidate, ','))
+        {
+            try {entry.candidates.push_back(std::stoi(candidate));}
+            catch (const std::exception &) {entry.candidates.clear(); break;}
+        }
+        if (not entry.candidates.empty()) entries[std::make_pair(source, target)] = entry;
+    }
+    return entries;
+}
+
+static void writeCacheFile(const std::string &path, const std::string &key, const TunedEntries &entries)
+{
+    //write a temporary file and rename it so readers never see a partial file
+    const std::string tmpPath = path + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream file(tmpPath);
+        if (not file) return;
+        file << "# SoapySDR converter tuning cache" << std::endl;
+        file << "# key: " << key << std::endl;
+        for (const auto &pair : entries)
+        {
+            file << pair.first.first << " " << pair.first.second << " "
+                 << pair.second.priority << " " << candidatesToString(pair.second.candidates) << std::endl;
+        }
+        if (not file) {file.close(); std::remove(tmpPath.c_str()); return;}
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) std::remove(tmpPath.c_str());
+}
+
+/***********************************************************************
+ * Measurement
+ **********************************************************************/
+static void fillSourceBuffer(std::vector<char> &buff, const std::string &format)
+{
+    uint32_t state(0x12345678);
+    auto next = [&state](void){state = state*1664525u + 1013904223u; return state;};
+    for (auto &b : buff) b = char(next() >> 24);
+    if (format.find('F') == std::string::npos) return;
+
+    //floating point formats: keep the narrowing conversions in range
+    const size_t width = SoapySDR::formatToSize(format)/((format[0] == 'C')?2:1);
+    if (width == sizeof(float))
+    {
+        auto *p = (float *)buff.data();
+        for (size_t i = 0; i < buff.size()/sizeof(float); i++) p[i] = float(next() >> 8)/(1 << 24) - 0.5f;
+    }
+    if (width == sizeof(double))
+    {
+        auto *p = (double *)buff.data();
+        for (size_t i = 0; i < buff.size()/sizeof(double); i++) p[i] = double(next() >> 8)/(1 << 24) - 0.5;
+    }
+}
+
+//! The best nanoseconds per element over several trials for one buffer size
+static double measureNsPerElem(const ConverterHandle &handle, const void *srcBuff, void *dstBuff, const size_t numElems)
+{
+    const size_t numIters = std::max<size_t>(TUNING_ELEMS_PER_TRIAL/numElems, 1);
+    handle(srcBuff, dstBuff, numElems);
+    double best = std::numeric_limits<double>::max();
+    for (size_t trial = 0; trial < TUNING_NUM_TRIALS; trial++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numIters; i++) handle(srcBuff, dstBuff, numElems);
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count()/(numIters*numElems));
+    }
+    return best;
+}
+
+//! Sum over the representative sizes of the best nanoseconds per element
+static double measureConverter(const ConverterHandle &handle, const void *srcBuff, void *dstBuff)
+{
+    double total(0.0);
+    for (const size_t numElems : TUNING_NUM_ELEMS)
+    {
+        total += measureNsPerElem(handle, srcBuff, dstBuff, numElems);
+    }
+    return total;
+}
+
+static const ConverterHandle *measureFastestConverter(const std::string &sourceFormat, const std::vector<const ConverterHandle *> &handles)
+{
+    const auto *fastest = handles.back();
+    if (fastest->sourceElemSize == 0 or fastest->targetElemSize == 0) return fastest;
+
+    const size_t maxElems = *std::max_element(std::begin(TUNING_NUM_ELEMS), std::end(TUNING_NUM_ELEMS));
+    std::vector<char> srcBuff(maxElems*fastest->sourceElemSize);
+    std::vector<char> dstBuff(maxElems*fastest->targetElemSize);
+    fillSourceBuffer(srcBuff, sourceFormat);
+
+    //prefer the higher priority unless a lower one is clearly faster
+    double fastestTime = measureConverter(*fastest, srcBuff.data(), dstBuff.data());
+    for (auto it = handles.rbegin()+1; it != handles.rend(); ++it)
+    {
+        const double time = measureConverter(**it, srcBuff.data(), dstBuff.data());
+        if (time*TUNING_MIN_SPEEDUP >= fastestTime) continue;
+        fastest = *it;
+        fastestTime = time;
+    }
+    return fastest;
+}
+
+/***********************************************************************
+ * Selection
+ **********************************************************************/
+static std::mutex &getTuningMutex(void)
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+static TuningCache &getTuningCache(void)
+{
+    static TuningCache cache;
+    if (cache.loaded) return cache;
+
+    //the key is computed on first use so it includes the modules loaded by then
+    cache.loaded = true;
+    cache.key = getTuningCacheKey();
+    cache.path = getConverterTuningCachePath();
+    if (not cache.path.empty()) cache.entries = readCacheFile(cache.path, cache.key);
+    return cache;
+}
+
+static const ConverterHandle *findPriority(const std::vector<const ConverterHandle *> &handles, const int priority)
+{
+    for (const auto *handle : handles)
+    {
+        if (int(handle->priority) == priority) return handle;
+    }
+    return nullptr;
+}
+
+const ConverterHandle *selectTunedConverter(
+    const std::string &sourceFormat, const std::string &targetFormat,
+    const std::vector<const ConverterHandle *> &handles)
+{
+    if (handles.size() < 2) return handles.empty()?nullptr:handles.back();
+
+    std::vector<int> candidates;
+    for (const auto *handle : handles) candidates.push_back(int(handle->priority));
+
+    std::lock_guard<std::mutex> lock(getTuningMutex());
+    auto &cache = getTuningCache();
+    const auto pair = std::make_pair(sourceFormat, targetFormat);
+
+    //a cached choice is only valid for the same set of candidates
+    const auto it = cache.entries.find(pair);
+    if (it != cache.entries.end() and it->second.candidates == candidates)
+    {
+        const auto *handle = findPriority(handles, it->second.priority);
+        if (handle != nullptr) return handle;
+    }
+
+    const auto *fastest = measureFastestConverter(sourceFormat, handles);
+    SoapySDR::logf(SOAPY_SDR_DEBUG, "Converter tuning %s -> %s: selected priority %d of [%s]",
+        sourceFormat.c_str(), targetFormat.c_str(), int(fastest->priority), candidatesToString(candidates).c_str());
+
+    TunedEntry entry;
+    entry.priority = int(fastest->priority);
+    entry.candidates = candidates;
+    cache.entries[pair] = entry;
+
+    //merge with choices stored by other processes since the cache was loaded
+    if (not cache.path.empty() and validFormat(sourceFormat) and validFormat(targetFormat))
+    {
+        makeDirectories(cache.path.substr(0, cache.path.find_last_of("/\\")));
+        auto entries = readCacheFile(cache.path, cache.key);
+        entries[pair] = entry;
+        writeCacheFile(cache.path, cache.key, entries);
+    }
+    return fastest;
+}
+
+double measureConverterCost(const std::string &sourceFormat, const ConverterHandle *handle)
+{
+    if (handle->sourceElemSize == 0 or handle->targetElemSize == 0) return -1.0;
+
+    static std::mutex mutex;
+    static std::map<const ConverterHandle *, double> costs;
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = costs.find(handle);
+    if (it != costs.end()) return it->second;
+
+    //the smallest representative size, as paths convert in cache-resident blocks
+    const size_t numElems = TUNING_NUM_ELEMS[0];
+    std::vector<char> srcBuff(numElems*handle->sourceElemSize);
+    std::vector<char> dstBuff(numElems*handle->targetElemSize);
+    fillSourceBuffer(srcBuff, sourceFormat);
+    return costs[handle] = measureNsPerElem(*handle, srcBuff.data(), dstBuff.data(), numElems);
+}
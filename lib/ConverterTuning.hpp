@@ -0,0 +1,42 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <string>
+#include <vector>
+
+/*******************************************************************
+ * Converter auto-tuning
+ *
+ * Each priority registered for a source/target pair is timed on
+ * representative buffer sizes and the fastest one is selected.
+ * Choices are persisted in a cache file for this host, so that
+ * later processes start tuned without measuring again.
+ ******************************************************************/
+
+//! Get the tuning cache file path, or empty when there is no cache directory
+std::string getConverterTuningCachePath(void);
+
+/*!
+ * Select the fastest of the handles for a source/target pair.
+ * The choice is taken from the tuning cache when it was measured
+ * with the same set of priorities, otherwise the handles are timed
+ * and the result is stored in the cache. Thread-safe.
+ * \param sourceFormat the source format markup string
+ * \param targetFormat the target format markup string
+ * \param handles all handles for the pair in ascending priority order
+ * \return the selected handle from the list
+ */
+const SoapySDR::ConverterRegistry::ConverterHandle *selectTunedConverter(
+    const std::string &sourceFormat, const std::string &targetFormat,
+    const std::vector<const SoapySDR::ConverterRegistry::ConverterHandle *> &handles);
+
+/*!
+ * Measure the cost of a converter in nanoseconds per element
+ * on a cache-resident buffer, memoized for each handle. Thread-safe.
+ * \param sourceFormat the source format markup string
+ * \param handle the converter to measure
+ * \return the cost or -1.0 when the element sizes are unknown
+ */
+double measureConverterCost(const std::string &sourceFormat, const SoapySDR::ConverterRegistry::ConverterHandle *handle);
@@ -8,6 +8,7 @@
 #include <SoapySDR/ConverterRegistry.hpp>
 
 #include <type_traits>
+#include <cstddef> //offsetof
 
 extern "C" {
 
@@ -15,6 +16,40 @@ static_assert(int(SoapySDR::ConverterRegistry::GENERIC) == int(SOAPY_SDR_CONVERT
 static_assert(int(SoapySDR::ConverterRegistry::VECTORIZED) == int(SOAPY_SDR_CONVERTER_VECTORIZED), "VECTORIZED");
 static_assert(int(SoapySDR::ConverterRegistry::CUSTOM) == int(SOAPY_SDR_CONVERTER_CUSTOM), "CUSTOM");
 static_assert(std::is_same<SoapySDR::ConverterRegistry::ConverterFunction, SoapySDRConverterFunction>::value, "ConverterFunction");
+static_assert(int(SoapySDR::ConverterRegistry::DEINTERLEAVE) == int(SOAPY_SDR_CONVERTER_DEINTERLEAVE), "DEINTERLEAVE");
+static_assert(int(SoapySDR::ConverterRegistry::INTERLEAVE) == int(SOAPY_SDR_CONVERTER_INTERLEAVE), "INTERLEAVE");
+static_assert(std::is_same<SoapySDR::ConverterRegistry::BatchConverterFunction, SoapySDRBatchConverterFunction>::value, "BatchConverterFunction");
+static_assert(std::is_same<SoapySDR::ConverterRegistry::ClipConverterFunction, SoapySDRClipConverterFunction>::value, "ClipConverterFunction");
+static_assert(std::is_same<SoapySDR::ConverterRegistry::FormatId, SoapySDRConverterFormatId>::value, "FormatId");
+static_assert(SoapySDR::ConverterRegistry::INVALID_FORMAT_ID == SOAPY_SDR_CONVERTER_INVALID_FORMAT_ID, "INVALID_FORMAT_ID");
+
+//the C handle is a view of the leading members of the C++ handle
+typedef SoapySDR::ConverterRegistry::ConverterHandle ConverterHandle;
+static_assert(sizeof(SoapySDR::ConverterRegistry::FunctionPriority) == sizeof(SoapySDRConverterFunctionPriority), "FunctionPriority");
+static_assert(offsetof(ConverterHandle, function) == offsetof(SoapySDRConverterHandle, function), "ConverterHandle::function");
+static_assert(offsetof(ConverterHandle, batchFunction) == offsetof(SoapySDRConverterHandle, batchFunction), "ConverterHandle::batchFunction");
+static_assert(offsetof(ConverterHandle, sourceElemSize) == offsetof(SoapySDRConverterHandle, sourceElemSize), "ConverterHandle::sourceElemSize");
+static_assert(offsetof(ConverterHandle, targetElemSize) == offsetof(SoapySDRConverterHandle, targetElemSize), "ConverterHandle::targetElemSize");
+static_assert(offsetof(ConverterHandle, priority) == offsetof(SoapySDRConverterHandle, priority), "ConverterHandle::priority");
+static_assert(offsetof(ConverterHandle, sourceFormat) == offsetof(SoapySDRConverterHandle, sourceFormat), "ConverterHandle::sourceFormat");
+static_assert(offsetof(ConverterHandle, targetFormat) == offsetof(SoapySDRConverterHandle, targetFormat), "ConverterHandle::targetFormat");
+static_assert(offsetof(ConverterHandle, inPlaceSafe) == offsetof(SoapySDRConverterHandle, inPlaceSafe), "ConverterHandle::inPlaceSafe");
+static_assert(offsetof(ConverterHandle, clipFunction) == offsetof(SoapySDRConverterHandle, clipFunction), "ConverterHandle::clipFunction");
+static_assert(offsetof(ConverterHandle, streamingFunction) == offsetof(SoapySDRConverterHandle, streamingFunction), "ConverterHandle::streamingFunction");
+
+//C++ sees SoapySDRIQCorrection as the C++ struct, which has the C layout since std::complex is an array of two doubles
+typedef SoapySDR::ConverterRegistry::IQCorrection IQCorrection;
+static_assert(std::is_same<IQCorrection, SoapySDRIQCorrection>::value, "SoapySDRIQCorrection");
+static_assert(sizeof(IQCorrection) == 5*sizeof(double), "IQCorrection");
+static_assert(offsetof(IQCorrection, dcOffset) == 0*sizeof(double), "IQCorrection::dcOffset");
+static_assert(offsetof(IQCorrection, iqBalance) == 2*sizeof(double), "IQCorrection::iqBalance");
+static_assert(offsetof(IQCorrection, dcTracking) == 4*sizeof(double), "IQCorrection::dcTracking");
+static_assert(std::is_same<SoapySDR::ConverterRegistry::CorrectionConverterFunction, SoapySDRCorrectionConverterFunction>::value, "CorrectionConverterFunction");
+
+//C++ sees SoapySDRConverterStats as the C++ struct, whose members are declared in the C order
+typedef SoapySDR::ConverterRegistry::ConverterStats ConverterStats;
+static_assert(std::is_same<ConverterStats, SoapySDRConverterStats>::value, "SoapySDRConverterStats");
+static_assert(std::is_same<SoapySDR::ConverterRegistry::StatsConverterFunction, SoapySDRStatsConverterFunction>::value, "StatsConverterFunction");
 
 char **SoapySDRConverter_listTargetFormats(const char *sourceFormat, size_t *length)
 {
@@ -78,4 +113,99 @@ char **SoapySDRConverter_listAvailableSourceFormats(size_t *length)
     __SOAPY_SDR_C_CATCH_RET(nullptr);
 }
 
+SoapySDRBatchConverterFunction SoapySDRConverter_getChannelFunction(const char *sourceFormat, const char *targetFormat, const SoapySDRConverterChannelLayout layout)
+{
+    __SOAPY_SDR_C_TRY
+    return SoapySDR::ConverterRegistry::getFunction(sourceFormat, targetFormat, static_cast<SoapySDR::ConverterRegistry::ChannelLayout>(layout));
+    __SOAPY_SDR_C_CATCH_RET(nullptr);
+}
+
+SoapySDRBatchConverterFunction SoapySDRConverter_getChannelFunctionWithPriority(const char *sourceFormat, const char *targetFormat, const SoapySDRConverterChannelLayout layout, const SoapySDRConverterFunctionPriority priority)
+{
+    __SOAPY_SDR_C_TRY
+    return SoapySDR::ConverterRegistry::getFunction(sourceFormat, targetFormat, static_cast<SoapySDR::ConverterRegistry::ChannelLayout>(layout), static_cast<SoapySDR::ConverterRegistry::FunctionPriority>(priority));
+    __SOAPY_SDR_C_CATCH_RET(nullptr);
+}
+
+SoapySDRCorrectionConverterFunction SoapySDRConverter_getCorrectionFunction(const char *sourceFormat, const char *targetFormat)
+{
+    __SOAPY_SDR_C_TRY
+    return SoapySDR::ConverterRegistry::getCorrectionFunction(sourceFormat, targetFormat);
+    __SOAPY_SDR_C_CATCH_RET(nullptr);
+}
+
+SoapySDRStatsConverterFunction SoapySDRConverter_getStatsFunction(const char *sourceFormat, const char *targetFormat)
+{
+    __SOAPY_SDR_C_TRY
+    return SoapySDR::ConverterRegistry::getStatsFunction(sourceFormat, targetFormat);
+    __SOAPY_SDR_C_CATCH_RET(nullptr);
+}
+
+SoapySDRConverterFormatId SoapySDRConverter_internFormat(const char *format)
+{
+    __SOAPY_SDR_C_TRY
+    return SoapySDR::ConverterRegistry::internFormat(format);
+    __SOAPY_SDR_C_CATCH_RET(SOAPY_SDR_CONVERTER_INVALID_FORMAT_ID);
+}
+
+const SoapySDRConverterHandle *SoapySDRConverter_resolve(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat)
+{
+    return reinterpret_cast<const SoapySDRConverterHandle *>(SoapySDR::ConverterRegistry::resolve(sourceFormat, targetFormat));
+}
+
+const SoapySDRConverterHandle *SoapySDRConverter_tune(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat)
+{
+    __SOAPY_SDR_C_TRY
+    return reinterpret_cast<const SoapySDRConverterHandle *>(SoapySDR::ConverterRegistry::tune(sourceFormat, targetFormat));
+    __SOAPY_SDR_C_CATCH_RET(nullptr);
+}
+
+const SoapySDRConverterHandle *SoapySDRConverter_resolveWithPriority(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat, const SoapySDRConverterFunctionPriority priority)
+{
+    return reinterpret_cast<const SoapySDRConverterHandle *>(SoapySDR::ConverterRegistry::resolve(sourceFormat, targetFormat, static_cast<SoapySDR::ConverterRegistry::FunctionPriority>(priority)));
+}
+
+int SoapySDRConverter_convertChannels(const SoapySDRConverterHandle *handle, const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler, const size_t numThreads)
+{
+    __SOAPY_SDR_C_TRY
+    if (handle == nullptr) throw std::invalid_argument("SoapySDRConverter_convertChannels() null handle");
+    SoapySDR::ConverterRegistry::convertChannels(*reinterpret_cast<const ConverterHandle *>(handle), srcBuffs, dstBuffs, numChans, numElems, scaler, numThreads);
+    __SOAPY_SDR_C_CATCH
+}
+
+const SoapySDRConverterPath *SoapySDRConverter_resolvePath(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat)
+{
+    __SOAPY_SDR_C_TRY
+    return reinterpret_cast<const SoapySDRConverterPath *>(SoapySDR::ConverterRegistry::resolvePath(sourceFormat, targetFormat));
+    __SOAPY_SDR_C_CATCH_RET(nullptr);
+}
+
+int SoapySDRConverter_convertPath(const SoapySDRConverterPath *path, const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+    __SOAPY_SDR_C_TRY
+    if (path == nullptr) throw std::invalid_argument("SoapySDRConverter_convertPath() null path");
+    SoapySDR::ConverterRegistry::convertPath(*reinterpret_cast<const SoapySDR::ConverterRegistry::ConverterPath *>(path), srcBuff, dstBuff, numElems, scaler);
+    __SOAPY_SDR_C_CATCH
+}
+
+void SoapySDRConverter_setAutoTuning(const bool enable)
+{
+    SoapySDR::ConverterRegistry::setAutoTuning(enable);
+}
+
+bool SoapySDRConverter_getAutoTuning(void)
+{
+    return SoapySDR::ConverterRegistry::getAutoTuning();
+}
+
+void SoapySDRConverter_setStreamingThreshold(const size_t numBytes)
+{
+    SoapySDR::ConverterRegistry::setStreamingThreshold(numBytes);
+}
+
+size_t SoapySDRConverter_getStreamingThreshold(void)
+{
+    return SoapySDR::ConverterRegistry::getStreamingThreshold();
+}
+
 }
@@ -0,0 +1,296 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/ConvertingStream.hpp>
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <SoapySDR/Formats.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <SoapySDR/Time.hpp>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+struct SoapySDR::ConvertingStream::Impl
+{
+    Device *device;
+    int direction;
+    size_t channel;
+    std::string format;
+    std::string nativeFormat;
+    Stream *stream;
+    size_t numChans;
+    size_t nativeElemSize;
+    double scaler;
+    const ConverterRegistry::ConverterHandle *handle;
+    const ConverterRegistry::ConverterPath *path;
+    bool directAccess;
+
+    //a receive buffer that is larger than the caller's request is held across calls
+    bool holding;
+    size_t heldHandle;
+    size_t heldOffset;
+    size_t heldRemaining;
+    int heldFlags;
+    long long heldTimeNs;
+    std::vector<const void *> readBuffs;
+    std::vector<void *> writeBuffs;
+
+    //native samples without direct access go through the scratch buffer
+    size_t scratchElems;
+    std::vector<char> scratch;
+
+    bool passThrough(void) const
+    {
+        return handle == nullptr and path == nullptr;
+    }
+
+    void convert(const void *src, void *dst, const size_t numElems) const
+    {
+        if (handle != nullptr) (*handle)(src, dst, numElems, scaler);
+        else (*path)(src, dst, numElems, scaler);
+    }
+
+    void *scratchBuff(const size_t ch)
+    {
+        return scratch.data() + ch*scratchElems*nativeElemSize;
+    }
+};
+
+/*******************************************************************
+ * The converters normalize integers by the full scale of the type,
+ * the default scaler maps the full scale of the device instead.
+ ******************************************************************/
+static double typeFullScale(const std::string &format)
+{
+    const bool complex = not format.empty() and format.front() == 'C';
+    const size_t bits = SoapySDR::formatToSize(format)*8/(complex?2:1);
+    return double(1ull << (bits-1));
+}
+
+static bool isFloatFormat(const std::string &format)
+{
+    return format.find('F') != std::string::npos;
+}
+
+static double defaultScaler(const int direction, const std::string &format, const std::string &nativeFormat, const double fullScale)
+{
+    if (fullScale <= 0.0 or isFloatFormat(nativeFormat) or not isFloatFormat(format)) return 1.0;
+    const double ratio = typeFullScale(nativeFormat)/fullScale;
+    return (direction == SOAPY_SDR_RX)?ratio:1.0/ratio;
+}
+
+/*******************************************************************
+ * Setup and teardown
+ ******************************************************************/
+SoapySDR::ConvertingStream::ConvertingStream(Device *device, const int direction, const std::string &format, const std::vector<size_t> &channels, const Kwargs &args):
+    _impl(nullptr)
+{
+    std::unique_ptr<Impl> impl(new Impl());
+    impl->device = device;
+    impl->direction = direction;
+    impl->channel = channels.empty()?0:channels.front();
+    impl->format = format;
+    impl->numChans = std::max<size_t>(channels.size(), 1);
+    impl->handle = nullptr;
+    impl->path = nullptr;
+    impl->directAccess = false;
+    impl->holding = false;
+    impl->heldHandle = 0;
+    impl->heldOffset = 0;
+    impl->heldRemaining = 0;
+    impl->heldFlags = 0;
+    impl->heldTimeNs = 0;
+    impl->scratchElems = 0;
+
+    double fullScale(0.0);
+    impl->nativeFormat = device->getNativeStreamFormat(direction, impl->channel, fullScale);
+    impl->nativeElemSize = SoapySDR::formatToSize(impl->nativeFormat);
+    impl->scaler = defaultScaler(direction, format, impl->nativeFormat, fullScale);
+
+    //the scaler is an option of the conversion, not of the device
+    Kwargs deviceArgs(args);
+    const auto it = deviceArgs.find("scaler");
+    if (it != deviceArgs.end())
+    {
+        impl->scaler = std::stod(it->second);
+        deviceArgs.erase(it);
+    }
+
+    //prefer a single registered converter, then the cheapest chain
+    if (format != impl->nativeFormat)
+    {
+        const bool rx = direction == SOAPY_SDR_RX;
+        const auto nativeId = ConverterRegistry::internFormat(impl->nativeFormat);
+        const auto formatId = ConverterRegistry::internFormat(format);
+        const auto sourceId = rx?nativeId:formatId;
+        const auto targetId = rx?formatId:nativeId;
+        if (ConverterRegistry::getAutoTuning()) ConverterRegistry::tune(sourceId, targetId);
+        impl->handle = ConverterRegistry::resolve(sourceId, targetId);
+        if (impl->handle == nullptr) impl->path = ConverterRegistry::resolvePath(sourceId, targetId);
+        if (impl->handle == nullptr and impl->path == nullptr)
+        {
+            throw std::runtime_error("ConvertingStream() no converter between " +
+                (rx?impl->nativeFormat:format) + " and " + (rx?format:impl->nativeFormat));
+        }
+    }
+
+    impl->stream = device->setupStream(direction, impl->nativeFormat, channels, deviceArgs);
+    if (not impl->passThrough()) try
+    {
+        impl->directAccess = device->getNumDirectAccessBuffers(impl->stream) != 0;
+        impl->readBuffs.resize(impl->numChans);
+        impl->writeBuffs.resize(impl->numChans);
+        if (not impl->directAccess)
+        {
+            impl->scratchElems = device->getStreamMTU(impl->stream);
+            impl->scratch.resize(impl->numChans*impl->scratchElems*impl->nativeElemSize);
+        }
+    }
+    catch (...)
+    {
+        device->closeStream(impl->stream);
+        throw;
+    }
+
+    _impl = impl.release();
+}
+
+SoapySDR::ConvertingStream::~ConvertingStream(void)
+{
+    try
+    {
+        if (_impl->holding) _impl->device->releaseReadBuffer(_impl->stream, _impl->heldHandle);
+        _impl->device->closeStream(_impl->stream);
+    }
+    catch (const std::exception &ex)
+    {
+        SoapySDR::logf(SOAPY_SDR_ERROR, "ConvertingStream::~ConvertingStream() closeStream threw %s", ex.what());
+    }
+    delete _impl;
+}
+
+/*******************************************************************
+ * Accessors
+ ******************************************************************/
+SoapySDR::Stream *SoapySDR::ConvertingStream::getStream(void) const
+{
+    return _impl->stream;
+}
+
+std::string SoapySDR::ConvertingStream::getNativeFormat(void) const
+{
+    return _impl->nativeFormat;
+}
+
+std::string SoapySDR::ConvertingStream::getFormat(void) const
+{
+    return _impl->format;
+}
+
+double SoapySDR::ConvertingStream::getScaler(void) const
+{
+    return _impl->scaler;
+}
+
+bool SoapySDR::ConvertingStream::usesDirectAccess(void) const
+{
+    return _impl->directAccess;
+}
+
+/*******************************************************************
+ * Streaming
+ ******************************************************************/
+int SoapySDR::ConvertingStream::readStream(void * const *buffs, const size_t numElems, int &flags, long long &timeNs, const long timeoutUs)
+{
+    Impl &impl = *_impl;
+    if (impl.passThrough()) return impl.device->readStream(impl.stream, buffs, numElems, flags, timeNs, timeoutUs);
+
+    if (not impl.directAccess)
+    {
+        const size_t n = std::min(numElems, impl.scratchElems);
+        for (size_t ch = 0; ch < impl.numChans; ch++) impl.writeBuffs[ch] = impl.scratchBuff(ch);
+        const int ret = impl.device->readStream(impl.stream, impl.writeBuffs.data(), n, flags, timeNs, timeoutUs);
+        if (ret <= 0) return ret;
+        for (size_t ch = 0; ch < impl.numChans; ch++) impl.convert(impl.writeBuffs[ch], buffs[ch], size_t(ret));
+        return ret;
+    }
+
+    if (not impl.holding)
+    {
+        const int ret = impl.device->acquireReadBuffer(impl.stream, impl.heldHandle, impl.readBuffs.data(), impl.heldFlags, impl.heldTimeNs, timeoutUs);
+        if (ret < 0) return ret;
+        if (ret == 0)
+        {
+            impl.device->releaseReadBuffer(impl.stream, impl.heldHandle);
+            flags = impl.heldFlags;
+            timeNs = impl.heldTimeNs;
+            return 0;
+        }
+        impl.holding = true;
+        impl.heldOffset = 0;
+        impl.heldRemaining = size_t(ret);
+    }
+
+    //convert straight from the device buffer into the caller's buffers
+    const size_t n = std::min(numElems, impl.heldRemaining);
+    const size_t offsetBytes = impl.heldOffset*impl.nativeElemSize;
+    for (size_t ch = 0; ch < impl.numChans; ch++)
+    {
+        impl.convert(static_cast<const char *>(impl.readBuffs[ch]) + offsetBytes, buffs[ch], n);
+    }
+
+    //the time of a later fragment advances by the elements already read
+    flags = impl.heldFlags;
+    timeNs = impl.heldTimeNs;
+    if (impl.heldOffset != 0 and (flags & SOAPY_SDR_HAS_TIME) != 0)
+    {
+        const double rate = impl.device->getSampleRate(impl.direction, impl.channel);
+        if (rate > 0.0) timeNs += SoapySDR::ticksToTimeNs((long long)(impl.heldOffset), rate);
+        else flags &= ~SOAPY_SDR_HAS_TIME;
+    }
+
+    impl.heldOffset += n;
+    impl.heldRemaining -= n;
+    if (impl.heldRemaining != 0)
+    {
+        flags = (flags & ~SOAPY_SDR_END_BURST) | SOAPY_SDR_MORE_FRAGMENTS;
+    }
+    else
+    {
+        impl.holding = false;
+        impl.device->releaseReadBuffer(impl.stream, impl.heldHandle);
+    }
+    return int(n);
+}
+
+int SoapySDR::ConvertingStream::writeStream(const void * const *buffs, const size_t numElems, int &flags, const long long timeNs, const long timeoutUs)
+{
+    Impl &impl = *_impl;
+    if (impl.passThrough()) return impl.device->writeStream(impl.stream, buffs, numElems, flags, timeNs, timeoutUs);
+
+    size_t handle(0);
+    size_t n(0);
+    if (impl.directAccess)
+    {
+        const int ret = impl.device->acquireWriteBuffer(impl.stream, handle, impl.writeBuffs.data(), timeoutUs);
+        if (ret < 0) return ret;
+        n = std::min(numElems, size_t(ret));
+    }
+    else
+    {
+        n = std::min(numElems, impl.scratchElems);
+        for (size_t ch = 0; ch < impl.numChans; ch++) impl.writeBuffs[ch] = impl.scratchBuff(ch);
+    }
+
+    //the end of burst only accompanies the last element
+    if (n < numElems) flags &= ~SOAPY_SDR_END_BURST;
+
+    for (size_t ch = 0; ch < impl.numChans; ch++) impl.convert(buffs[ch], impl.writeBuffs[ch], n);
+
+    if (not impl.directAccess)
+    {
+        return impl.device->writeStream(impl.stream, impl.writeBuffs.data(), n, flags, timeNs, timeoutUs);
+    }
+    impl.device->releaseWriteBuffer(impl.stream, handle, n, flags, timeNs);
+    return int(n);
+}
@@ -0,0 +1,259 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "CPUFeatures.hpp"
+#include "ConverterKernels.hpp"
+#include <SoapySDR/ConverterPrimitives.hpp>
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <SoapySDR/Formats.hpp>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#ifdef SOAPY_SDR_X86
+#include <immintrin.h>
+#endif
+
+/***********************************************************************
+ * Correction converters for front ends without hardware DC offset
+ * and IQ balance correction.
+ *
+ * The conversion to CF32, DC offset removal, and IQ balance correction
+ * are fused into one loop, so each sample is read and written once.
+ * The IQ balance y = x' + b*conj(x') is the 2x2 real matrix
+ * [1+re(b), im(b); im(b), 1-re(b)] applied to x' = x - dcOffset,
+ * which vectorizes as x'*A + swap(x')*B on interleaved I/Q lanes.
+ *
+ * The DC tracker needs the mean of the uncorrected samples, which the
+ * kernels accumulate in the same pass. The estimate is updated once per
+ * block of DC_TRACKING_BLOCK samples, so the kernels stay branch-free.
+ **********************************************************************/
+
+typedef SoapySDR::ConverterRegistry::IQCorrection IQCorrection;
+typedef SoapySDR::ConverterRegistry::CorrectionConverterFunction CorrectionConverterFunction;
+
+static const size_t DC_TRACKING_BLOCK = 64;
+
+//! The correction in single precision for the inner loops
+struct CorrectionCoeffs
+{
+  float scale;
+  float dcI, dcQ;
+  float a0, a1, b;
+};
+
+// ********************************
+// Generic loop and block driver
+
+//! A SIMD kernel for elements [first, last), adds to sums and returns the next element
+typedef size_t (*CorrectionKernel)(const void *, void *, const size_t, const size_t, const CorrectionCoeffs &, double *);
+
+static size_t noKernel(const void *, void *, const size_t first, const size_t, const CorrectionCoeffs &, double *)
+{
+  return first;
+}
+
+template <typename Op>
+static void correctRange(const void *srcBuff, void *dstBuff, const size_t first, const size_t last, const CorrectionCoeffs &c, double *sums)
+{
+  auto *src = (const typename Op::SrcType*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  for (size_t i = first; i < last; i++)
+    {
+      const float xi = Op::convert(src[i*2+0], c.scale);
+      const float xq = Op::convert(src[i*2+1], c.scale);
+      sums[0] += xi;
+      sums[1] += xq;
+      const float pi = xi - c.dcI;
+      const float pq = xq - c.dcQ;
+      dst[i*2+0] = pi*c.a0 + pq*c.b;
+      dst[i*2+1] = pq*c.a1 + pi*c.b;
+    }
+}
+
+template <typename Op, CorrectionKernel kernel>
+static void correctConvert(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler, IQCorrection *corr)
+{
+  CorrectionCoeffs c;
+  c.scale = Op::scale(scaler);
+  c.a0 = float(1.0 + corr->iqBalance.real());
+  c.a1 = float(1.0 - corr->iqBalance.real());
+  c.b = float(corr->iqBalance.imag());
+
+  //without tracking the whole buffer is one block
+  const bool tracking = corr->dcTracking > 0.0;
+  const size_t blockElems = tracking?DC_TRACKING_BLOCK:std::max<size_t>(numElems, 1);
+  const double blockAlpha = tracking?(1.0 - std::pow(1.0 - corr->dcTracking, double(DC_TRACKING_BLOCK))):0.0;
+
+  for (size_t first = 0; first < numElems; first += blockElems)
+    {
+      const size_t last = std::min(first+blockElems, numElems);
+      c.dcI = float(corr->dcOffset.real());
+      c.dcQ = float(corr->dcOffset.imag());
+      double sums[2] = {0.0, 0.0};
+      const size_t i = kernel(srcBuff, dstBuff, first, last, c, sums);
+      correctRange<Op>(srcBuff, dstBuff, i, last, c, sums);
+      if (not tracking) continue;
+
+      //the IIR applied n times to a constant input is one update with 1-(1-alpha)^n
+      const size_t n = last-first;
+      const double alpha = (n == DC_TRACKING_BLOCK)?blockAlpha:(1.0 - std::pow(1.0 - corr->dcTracking, double(n)));
+      corr->dcOffset += alpha*(std::complex<double>(sums[0], sums[1])/double(n) - corr->dcOffset);
+    }
+}
+
+#ifdef SOAPY_SDR_X86
+
+// ********************************
+// SSE2 kernels
+
+SOAPY_SDR_TARGET("sse2")
+static inline __m128 sse2LoadCS16(const void *srcBuff, const size_t i)
+{
+  const __m128i in = _mm_loadl_epi64((const __m128i*)((const int16_t*)srcBuff+i*2));
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16));
+}
+
+SOAPY_SDR_TARGET("sse2")
+static inline __m128 sse2LoadCF32(const void *srcBuff, const size_t i)
+{
+  return _mm_loadu_ps((const float*)srcBuff+i*2);
+}
+
+//! 2 complex elements per iteration from a loader of 4 unscaled floats
+template <__m128 (*load)(const void *, const size_t)>
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Correct(const void *srcBuff, void *dstBuff, const size_t first, const size_t last, const CorrectionCoeffs &c, double *sums)
+{
+  auto *dst = (float*)dstBuff;
+  const __m128 scale = _mm_set1_ps(c.scale);
+  const __m128 dc = _mm_setr_ps(c.dcI, c.dcQ, c.dcI, c.dcQ);
+  const __m128 a = _mm_setr_ps(c.a0, c.a1, c.a0, c.a1);
+  const __m128 b = _mm_set1_ps(c.b);
+  __m128 acc = _mm_setzero_ps();
+
+  size_t i = first;
+  for (; i+2 <= last; i += 2)
+    {
+      const __m128 x = _mm_mul_ps(load(srcBuff, i), scale);
+      acc = _mm_add_ps(acc, x);
+      const __m128 p = _mm_sub_ps(x, dc);
+      const __m128 swapped = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 0, 1));
+      _mm_storeu_ps(dst+i*2, _mm_add_ps(_mm_mul_ps(p, a), _mm_mul_ps(swapped, b)));
+    }
+
+  float lanes[4];
+  _mm_storeu_ps(lanes, acc);
+  sums[0] += double(lanes[0]) + double(lanes[2]);
+  sums[1] += double(lanes[1]) + double(lanes[3]);
+  return i;
+}
+
+// ********************************
+// AVX2 kernels
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m256 avx2LoadCS16(const void *srcBuff, const size_t i)
+{
+  return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)((const int16_t*)srcBuff+i*2))));
+}
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m256 avx2LoadCS8(const void *srcBuff, const size_t i)
+{
+  return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)((const int8_t*)srcBuff+i*2))));
+}
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m256 avx2LoadCU8(const void *srcBuff, const size_t i)
+{
+  const __m128i in = _mm_xor_si128(_mm_loadl_epi64((const __m128i*)((const uint8_t*)srcBuff+i*2)), _mm_set1_epi8(char(0x80)));
+  return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(in));
+}
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m256 avx2LoadCF32(const void *srcBuff, const size_t i)
+{
+  return _mm256_loadu_ps((const float*)srcBuff+i*2);
+}
+
+//! 4 complex elements per iteration from a loader of 8 unscaled floats
+template <__m256 (*load)(const void *, const size_t)>
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2Correct(const void *srcBuff, void *dstBuff, const size_t first, const size_t last, const CorrectionCoeffs &c, double *sums)
+{
+  auto *dst = (float*)dstBuff;
+  const __m256 scale = _mm256_set1_ps(c.scale);
+  const __m256 dc = _mm256_setr_ps(c.dcI, c.dcQ, c.dcI, c.dcQ, c.dcI, c.dcQ, c.dcI, c.dcQ);
+  const __m256 a = _mm256_setr_ps(c.a0, c.a1, c.a0, c.a1, c.a0, c.a1, c.a0, c.a1);
+  const __m256 b = _mm256_set1_ps(c.b);
+  __m256 acc = _mm256_setzero_ps();
+
+  size_t i = first;
+  for (; i+4 <= last; i += 4)
+    {
+      const __m256 x = _mm256_mul_ps(load(srcBuff, i), scale);
+      acc = _mm256_add_ps(acc, x);
+      const __m256 p = _mm256_sub_ps(x, dc);
+      const __m256 swapped = _mm256_permute_ps(p, _MM_SHUFFLE(2, 3, 0, 1));
+      _mm256_storeu_ps(dst+i*2, _mm256_add_ps(_mm256_mul_ps(p, a), _mm256_mul_ps(swapped, b)));
+    }
+
+  float lanes[8];
+  _mm256_storeu_ps(lanes, acc);
+  sums[0] += double(lanes[0]) + double(lanes[2]) + double(lanes[4]) + double(lanes[6]);
+  sums[1] += double(lanes[1]) + double(lanes[3]) + double(lanes[5]) + double(lanes[7]);
+  return i;
+}
+
+#endif //SOAPY_SDR_X86
+
+/***********************************************************************
+ * Kernel table in order of preference for each source/target.
+ * Registered by registerKernelTable() with VECTORIZED priority.
+ **********************************************************************/
+struct CorrectionKernelEntry
+{
+  const char *sourceFormat;
+  const char *targetFormat;
+  bool CPUFeatures::*isa;
+  CorrectionConverterFunction function;
+};
+
+static const CorrectionKernelEntry correctionKernels[] = {
+#ifdef SOAPY_SDR_X86
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF32, &CPUFeatures::avx2, &correctConvert<CS16toCF32, &avx2Correct<&avx2LoadCS16>>},
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF32, &CPUFeatures::sse2, &correctConvert<CS16toCF32, &sse2Correct<&sse2LoadCS16>>},
+  {SOAPY_SDR_CS8, SOAPY_SDR_CF32, &CPUFeatures::avx2, &correctConvert<CS8toCF32, &avx2Correct<&avx2LoadCS8>>},
+  {SOAPY_SDR_CU8, SOAPY_SDR_CF32, &CPUFeatures::avx2, &correctConvert<CU8toCF32, &avx2Correct<&avx2LoadCU8>>},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CF32, &CPUFeatures::avx2, &correctConvert<CF32toCF32, &avx2Correct<&avx2LoadCF32>>},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CF32, &CPUFeatures::sse2, &correctConvert<CF32toCF32, &sse2Correct<&sse2LoadCF32>>},
+#endif //SOAPY_SDR_X86
+  {nullptr, nullptr, nullptr, nullptr}
+};
+
+static bool registerCorrectionConverters(void)
+{
+  typedef SoapySDR::ConverterRegistry Registry;
+
+  Registry(SOAPY_SDR_CS16, SOAPY_SDR_CF32, Registry::GENERIC, &correctConvert<CS16toCF32, &noKernel>);
+  Registry(SOAPY_SDR_CS8, SOAPY_SDR_CF32, Registry::GENERIC, &correctConvert<CS8toCF32, &noKernel>);
+  Registry(SOAPY_SDR_CU8, SOAPY_SDR_CF32, Registry::GENERIC, &correctConvert<CU8toCF32, &noKernel>);
+  Registry(SOAPY_SDR_CF32, SOAPY_SDR_CF32, Registry::GENERIC, &correctConvert<CF32toCF32, &noKernel>);
+
+  registerKernelTable(correctionKernels, [](const CorrectionKernelEntry &k)
+    {
+      Registry(k.sourceFormat, k.targetFormat, Registry::VECTORIZED, k.function);
+    });
+  return true;
+}
+
+/*!
+ * lateLoadCorrectionConverters() is called by lateLoadDefaultConverters()
+ * so the correction converters load with the rest of the default set.
+ */
+void lateLoadCorrectionConverters(void)
+{
+  static const bool registered = registerCorrectionConverters();
+  (void)registered;
+}
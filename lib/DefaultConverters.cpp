@@ -4,641 +4,480 @@
 // Copyright (c) 2015-2018 Josh Blum
 // SPDX-License-Identifier: BSL-1.0
 
+#include "DefaultConverters.hpp"
 #include <SoapySDR/ConverterPrimitives.hpp>
 #include <SoapySDR/ConverterRegistry.hpp>
 #include <SoapySDR/Formats.hpp>
 #include <cstring> //memcpy
+#include <limits>
+#include <type_traits>
+
+/***********************************************************************
+ * Generic converter matrix.
+ *
+ * Every real format converts to every other real format,
+ * and every complex format to every other complex format.
+ * The converters are generated from a description of each format
+ * (sample type, samples per element, packing) and of each sample type
+ * (signed domain and full scale) built on the ConverterPrimitives.
+ *
+ * Samples are rescaled in their signed domain:
+ *  - float <> float multiplies by the scaler
+ *  - integer <> float folds the full scale into the scaler
+ *  - integer <> integer shifts by the difference in width when the
+ *    scaler is unity, otherwise multiplies and saturates
+ *  - float > integer saturates at full scale and can count clips
+ *
+ * The scale is a single constant outside of each loop. Computations
+ * use float, or double when either side is F64 or a 32-bit integer.
+ * Unity scaling has its own loop with a constant scale or shift,
+ * and identical formats are copied with memcpy.
+ *
+ * Each element is read before it is written and the loops run forward,
+ * so the converters are in-place safe whenever the target element
+ * is not larger than the source element.
+ *
+ * The converters are constant handles in a table for each matrix,
+ * which the registry consults directly instead of registering them.
+ **********************************************************************/
+
+void lateLoadVectorizedConverters(void);
+void lateLoadInterleaveConverters(void);
+void lateLoadCorrectionConverters(void);
+void lateLoadStatsConverters(void);
+
+typedef SoapySDR::ConverterRegistry::ConverterFunction ConverterFunction;
+typedef SoapySDR::ConverterRegistry::ClipConverterFunction ClipConverterFunction;
+typedef SoapySDR::ConverterRegistry::ConverterHandle ConverterHandle;
+typedef SoapySDR::ConverterRegistry::FormatId FormatId;
 
 // ********************************
-// Real Soapy Formats
+// Sample types
 
-// Copy Converters
+template <typename T>
+struct SampleTraits;
 
-// F32 <> F32
-static void genericF32toF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <>
+struct SampleTraits<double>
 {
-  const size_t elemDepth = 1;
+  typedef double Signed; static const bool isFloat = true; static const int bits = 53;
+  static double toSigned(const double in) { return in; }
+  static double fromSigned(const double in) { return in; }
+};
 
-  if (scaler == 1.0)
-    {
-      const size_t sampleSize = sizeof(float);
-      std::memcpy(dstBuff, srcBuff, numElems*elemDepth*sampleSize);
-    }
-  else
-    {
-      auto *src = (float*)srcBuff;
-      auto *dst = (float*)dstBuff;
-      for (size_t i = 0; i < numElems*elemDepth; i++)
-        {
-          dst[i] = float(src[i]) * scaler;
-        }
-    }
-}
-
-// S32 <> S32
-static void genericS32toS32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  if (scaler == 1.0)
-    {
-      const size_t sampleSize = sizeof(int32_t);
-      std::memcpy(dstBuff, srcBuff, numElems*elemDepth*sampleSize);
-    }
-  else
-    {
-      auto *src = (int32_t*)srcBuff;
-      auto *dst = (int32_t*)dstBuff;
-      for (size_t i = 0; i < numElems*elemDepth; i++)
-        {
-          dst[i] = int32_t(src[i]) * scaler;
-        }
-    }
-}
-
-// S16 <> S16
-static void genericS16toS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  if (scaler == 1.0)
-    {
-      const size_t sampleSize = sizeof(int16_t);
-      std::memcpy(dstBuff, srcBuff, numElems*elemDepth*sampleSize);
-    }
-  else
-    {
-      auto *src = (int16_t*)srcBuff;
-      auto *dst = (int16_t*)dstBuff;
-      for (size_t i = 0; i < numElems*elemDepth; i++)
-        {
-          dst[i] = int16_t(src[i]) * scaler;
-        }
-    }
-}
-
-// S8 <> S8
-static void genericS8toS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  if (scaler == 1.0)
-    {
-      const size_t sampleSize = sizeof(int8_t);
-      std::memcpy(dstBuff, srcBuff, numElems*elemDepth*sampleSize);
-    }
-  else
-    {
-      auto *src = (int8_t*)srcBuff;
-      auto *dst = (int8_t*)dstBuff;
-      for (size_t i = 0; i < numElems*elemDepth; i++)
-        {
-          dst[i] = int8_t(src[i]) * scaler;
-        }
-    }
-}
-
-// Type Converters
-
-// F32 <> S16
-static void genericF32toS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  auto *src = (float*)srcBuff;
-  auto *dst = (int16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::F32toS16(src[i] * scaler);
-    }
-}
-
-static void genericS16toF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  auto *src = (int16_t*)srcBuff;
-  auto *dst = (float*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S16toF32(src[i]) * scaler;
-    }
-}
-
-// F32 <> U16
-static void genericF32toU16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  auto *src = (float*)srcBuff;
-  auto *dst = (uint16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::F32toU16(src[i] * scaler);
-    }
-}
-
-static void genericU16toF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <>
+struct SampleTraits<float>
 {
-  const size_t elemDepth = 1;
-
-  auto *src = (uint16_t*)srcBuff;
-  auto *dst = (float*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::U16toF32(src[i]) * scaler;
-    }
-}
+  typedef float Signed; static const bool isFloat = true; static const int bits = 24;
+  static float toSigned(const float in) { return in; }
+  static float fromSigned(const float in) { return in; }
+};
 
-// F32 <> S8
-static void genericF32toS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <>
+struct SampleTraits<int32_t>
 {
-  const size_t elemDepth = 1;
+  typedef int32_t Signed; static const bool isFloat = false; static const int bits = 32;
+  static int32_t toSigned(const int32_t in) { return in; }
+  static int32_t fromSigned(const int32_t in) { return in; }
+};
 
-  auto *src = (float*)srcBuff;
-  auto *dst = (int8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::F32toS8(src[i] * scaler);
-    }
-}
-
-static void genericS8toF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <>
+struct SampleTraits<uint32_t>
 {
-  const size_t elemDepth = 1;
-
-  auto *src = (int8_t*)srcBuff;
-  auto *dst = (float*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S8toF32(src[i]) * scaler;
-    }
-}
+  typedef int32_t Signed; static const bool isFloat = false; static const int bits = 32;
+  static int32_t toSigned(const uint32_t in) { return SoapySDR::U32toS32(in); }
+  static uint32_t fromSigned(const int32_t in) { return SoapySDR::S32toU32(in); }
+};
 
-// F32 <> U8
-static void genericF32toU8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <>
+struct SampleTraits<int16_t>
 {
-  const size_t elemDepth = 1;
+  typedef int16_t Signed; static const bool isFloat = false; static const int bits = 16;
+  static int16_t toSigned(const int16_t in) { return in; }
+  static int16_t fromSigned(const int16_t in) { return in; }
+};
 
-  auto *src = (float*)srcBuff;
-  auto *dst = (uint8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::F32toU8(src[i] * scaler);
-    }
-}
-
-static void genericU8toF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <>
+struct SampleTraits<uint16_t>
 {
-  const size_t elemDepth = 1;
-
-  auto *src = (uint8_t*)srcBuff;
-  auto *dst = (float*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::U8toF32(src[i]) * scaler;
-    }
-}
+  typedef int16_t Signed; static const bool isFloat = false; static const int bits = 16;
+  static int16_t toSigned(const uint16_t in) { return SoapySDR::U16toS16(in); }
+  static uint16_t fromSigned(const int16_t in) { return SoapySDR::S16toU16(in); }
+};
 
-// S16 <> U16
-static void genericS16toU16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <>
+struct SampleTraits<int8_t>
 {
-  const size_t elemDepth = 1;
-
-  auto *src = (int16_t*)srcBuff;
-  auto *dst = (uint16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S16toU16(src[i] * scaler);
-    }
-}
-
-static void genericU16toS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  auto *src = (uint16_t*)srcBuff;
-  auto *dst = (int16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::U16toS16(src[i]) * scaler;
-    }
-}
-
-// S16 <> S8
-static void genericS16toS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  auto *src = (int16_t*)srcBuff;
-  auto *dst = (int8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S16toS8(src[i] * scaler);
-    }
-}
-
-static void genericS8toS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  auto *src = (int8_t*)srcBuff;
-  auto *dst = (int16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S8toS16(src[i]) * scaler;
-    }
-}
-
-// S16 <> U8
-static void genericS16toU8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  auto *src = (int16_t*)srcBuff;
-  auto *dst = (uint8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S16toU8(src[i] * scaler);
-    }
-}
-
-static void genericU8toS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  auto *src = (uint8_t*)srcBuff;
-  auto *dst = (int16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::U8toS16(src[i]) * scaler;
-    }
-}
-
-// U16 <> S8
-static void genericU16toS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  auto *src = (uint16_t*)srcBuff;
-  auto *dst = (int8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::U16toS8(src[i] * scaler);
-    }
-}
+  typedef int8_t Signed; static const bool isFloat = false; static const int bits = 8;
+  static int8_t toSigned(const int8_t in) { return in; }
+  static int8_t fromSigned(const int8_t in) { return in; }
+};
 
-static void genericS8toU16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <>
+struct SampleTraits<uint8_t>
 {
-  const size_t elemDepth = 1;
-
-  auto *src = (int8_t*)srcBuff;
-  auto *dst = (uint16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S8toU16(src[i]) * scaler;
-    }
-}
+  typedef int8_t Signed; static const bool isFloat = false; static const int bits = 8;
+  static int8_t toSigned(const uint8_t in) { return SoapySDR::U8toS8(in); }
+  static uint8_t fromSigned(const int8_t in) { return SoapySDR::S8toU8(in); }
+};
 
-// S8 <> U8
-static void genericS8toU8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <typename T, typename R>
+static inline bool clipped(const R from)
 {
-  const size_t elemDepth = 1;
-
-  auto *src = (int8_t*)srcBuff;
-  auto *dst = (uint8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S8toU8(src[i] * scaler);
-    }
+  return from < R(std::numeric_limits<T>::min()) or from > R(std::numeric_limits<T>::max());
 }
 
-static void genericU8toS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 1;
-
-  auto *src = (uint8_t*)srcBuff;
-  auto *dst = (int8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::U8toS8(src[i]) * scaler;
-    }
-}
+// ********************************
+// Sample conversions
+
+template <typename SrcType, typename DstType>
+struct ComputeType
+{
+  typedef typename std::conditional<(SampleTraits<SrcType>::bits > 24 or SampleTraits<DstType>::bits > 24), double, float>::type type;
+};
+
+template <typename SrcType, typename DstType,
+  bool srcFloat = SampleTraits<SrcType>::isFloat,
+  bool dstFloat = SampleTraits<DstType>::isFloat>
+struct SampleOp;
+
+//float <> float
+template <typename SrcType, typename DstType>
+struct SampleOp<SrcType, DstType, true, true>
+{
+  typedef typename ComputeType<SrcType, DstType>::type R;
+  static const bool clips = false;
+  static R scale(const double scaler) { return R(scaler); }
+  static R unityScale(void) { return R(1); }
+  template <bool unity>
+  static DstType convert(const SrcType in, const R scale)
+  {
+    return unity?DstType(in):DstType(R(in)*scale);
+  }
+};
+
+//integer > float
+template <typename SrcType, typename DstType>
+struct SampleOp<SrcType, DstType, false, true>
+{
+  typedef typename ComputeType<SrcType, DstType>::type R;
+  static const bool clips = false;
+  static double fullScale(void) { return double(uint64_t(1) << (SampleTraits<SrcType>::bits-1)); }
+  static R scale(const double scaler) { return R(scaler/fullScale()); }
+  static R unityScale(void) { return R(1.0/fullScale()); }
+  template <bool>
+  static DstType convert(const SrcType in, const R scale)
+  {
+    return DstType(R(SampleTraits<SrcType>::toSigned(in))*scale);
+  }
+};
+
+//float > integer
+template <typename SrcType, typename DstType>
+struct SampleOp<SrcType, DstType, true, false>
+{
+  typedef typename ComputeType<SrcType, DstType>::type R;
+  typedef typename SampleTraits<DstType>::Signed Signed;
+  static const bool clips = true;
+  static double fullScale(void) { return double(uint64_t(1) << (SampleTraits<DstType>::bits-1)); }
+  static R scale(const double scaler) { return R(scaler*fullScale()); }
+  static R unityScale(void) { return R(fullScale()); }
+  template <bool>
+  static DstType convert(const SrcType in, const R scale)
+  {
+    return SampleTraits<DstType>::fromSigned(SoapySDR::SaturateInt<Signed>(R(in)*scale));
+  }
+  static bool clip(const SrcType in, const R scale)
+  {
+    return clipped<Signed>(R(in)*scale);
+  }
+};
+
+//widen or narrow a signed integer by a constant shift
+template <typename DstSigned, int shift, bool widen = (shift >= 0)>
+struct ShiftSample
+{
+  template <typename T>
+  static DstSigned apply(const T in) { return DstSigned(int64_t(in) * (int64_t(1) << shift)); }
+};
+
+template <typename DstSigned, int shift>
+struct ShiftSample<DstSigned, shift, false>
+{
+  template <typename T>
+  static DstSigned apply(const T in) { return DstSigned(in >> -shift); }
+};
+
+//integer <> integer
+template <typename SrcType, typename DstType>
+struct SampleOp<SrcType, DstType, false, false>
+{
+  typedef typename ComputeType<SrcType, DstType>::type R;
+  typedef typename SampleTraits<DstType>::Signed Signed;
+  static const bool clips = false;
+  static const int shift = SampleTraits<DstType>::bits - SampleTraits<SrcType>::bits;
+  static R scale(const double scaler) { return R(scaler*((shift < 0)?1.0/double(uint64_t(1) << -shift):double(uint64_t(1) << shift))); }
+  static R unityScale(void) { return R(1); }
+  template <bool unity>
+  static DstType convert(const SrcType in, const R scale)
+  {
+    const auto s = SampleTraits<SrcType>::toSigned(in);
+    return SampleTraits<DstType>::fromSigned(unity?
+      ShiftSample<Signed, shift>::apply(s):
+      SoapySDR::SaturateInt<Signed>(R(s)*scale));
+  }
+};
 
 // ********************************
-// Complex Data Types
+// Formats
+
+template <typename T, size_t depth>
+struct InterleavedFormat
+{
+  typedef T Sample; typedef T Packed;
+  static const size_t elemDepth = depth;
+  static const size_t elemSize = sizeof(T)*depth;
+  static const bool packed = false;
+  static void load(const T *src, const size_t i, T *out) { for (size_t k = 0; k < depth; k++) out[k] = src[i*depth+k]; }
+  static void store(const T *in, T *dst, const size_t i) { for (size_t k = 0; k < depth; k++) dst[i*depth+k] = in[k]; }
+};
+
+//12-bit pairs in 3 bytes, held in the most significant bits of 16-bit samples
+template <typename T>
+struct Packed12Format
+{
+  typedef T Sample; typedef uint8_t Packed;
+  static const size_t elemDepth = 2;
+  static const size_t elemSize = 3;
+  static const bool packed = true;
+  static void load(const uint8_t *src, const size_t i, T *out)
+  {
+    int16_t tmp[2];
+    SoapySDR::CS12toCS16(src+i*3, tmp);
+    out[0] = T(tmp[0]); out[1] = T(tmp[1]);
+  }
+  static void store(const T *in, uint8_t *dst, const size_t i)
+  {
+    const int16_t tmp[2] = {int16_t(in[0]), int16_t(in[1])};
+    SoapySDR::CS16toCS12(tmp, dst+i*3);
+  }
+};
+
+//4-bit pairs in 1 byte, held in the most significant bits of 8-bit samples
+template <typename T>
+struct Packed4Format
+{
+  typedef T Sample; typedef uint8_t Packed;
+  static const size_t elemDepth = 2;
+  static const size_t elemSize = 1;
+  static const bool packed = true;
+  static void load(const uint8_t *src, const size_t i, T *out)
+  {
+    int8_t tmp[2];
+    SoapySDR::CS4toCS8(src[i], tmp);
+    out[0] = T(tmp[0]); out[1] = T(tmp[1]);
+  }
+  static void store(const T *in, uint8_t *dst, const size_t i)
+  {
+    const int8_t tmp[2] = {int8_t(in[0]), int8_t(in[1])};
+    dst[i] = SoapySDR::CS8toCS4(tmp);
+  }
+};
+
+//built-in formats take the first format ids in this order
+#define SOAPY_SDR_GENERIC_FORMAT(format, formatId, ...) \
+  struct Format ## format : __VA_ARGS__ \
+  { \
+    static constexpr const char *name(void) { return SOAPY_SDR_ ## format; } \
+    static constexpr FormatId id(void) { return formatId; } \
+  }
+
+SOAPY_SDR_GENERIC_FORMAT(F64, 0, InterleavedFormat<double, 1>);
+SOAPY_SDR_GENERIC_FORMAT(F32, 1, InterleavedFormat<float, 1>);
+SOAPY_SDR_GENERIC_FORMAT(S32, 2, InterleavedFormat<int32_t, 1>);
+SOAPY_SDR_GENERIC_FORMAT(U32, 3, InterleavedFormat<uint32_t, 1>);
+SOAPY_SDR_GENERIC_FORMAT(S16, 4, InterleavedFormat<int16_t, 1>);
+SOAPY_SDR_GENERIC_FORMAT(U16, 5, InterleavedFormat<uint16_t, 1>);
+SOAPY_SDR_GENERIC_FORMAT(S8, 6, InterleavedFormat<int8_t, 1>);
+SOAPY_SDR_GENERIC_FORMAT(U8, 7, InterleavedFormat<uint8_t, 1>);
+
+SOAPY_SDR_GENERIC_FORMAT(CF64, 8, InterleavedFormat<double, 2>);
+SOAPY_SDR_GENERIC_FORMAT(CF32, 9, InterleavedFormat<float, 2>);
+SOAPY_SDR_GENERIC_FORMAT(CS32, 10, InterleavedFormat<int32_t, 2>);
+SOAPY_SDR_GENERIC_FORMAT(CU32, 11, InterleavedFormat<uint32_t, 2>);
+SOAPY_SDR_GENERIC_FORMAT(CS16, 12, InterleavedFormat<int16_t, 2>);
+SOAPY_SDR_GENERIC_FORMAT(CU16, 13, InterleavedFormat<uint16_t, 2>);
+SOAPY_SDR_GENERIC_FORMAT(CS12, 14, Packed12Format<int16_t>);
+SOAPY_SDR_GENERIC_FORMAT(CU12, 15, Packed12Format<uint16_t>);
+SOAPY_SDR_GENERIC_FORMAT(CS8, 16, InterleavedFormat<int8_t, 2>);
+SOAPY_SDR_GENERIC_FORMAT(CU8, 17, InterleavedFormat<uint8_t, 2>);
+SOAPY_SDR_GENERIC_FORMAT(CS4, 18, Packed4Format<int8_t>);
+SOAPY_SDR_GENERIC_FORMAT(CU4, 19, Packed4Format<uint8_t>);
 
-// Copy Converters
+// ********************************
+// Generic loops
 
-// CF32 <> CF32
-static void genericCF32toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+//both formats are plain arrays of samples: one flat loop the compiler can vectorize
+template <typename SrcFormat, typename DstFormat, bool unity, typename R>
+static void convertLoop(const void *srcBuff, void *dstBuff, const size_t numElems, const R scale, std::false_type)
 {
-  const size_t elemDepth = 2;
-
-  if (scaler == 1.0)
-    {
-      const size_t sampleSize = sizeof(float);
-      std::memcpy(dstBuff, srcBuff, numElems*elemDepth*sampleSize);
-    }
-  else
+  typedef SampleOp<typename SrcFormat::Sample, typename DstFormat::Sample> Op;
+  auto *src = (const typename SrcFormat::Sample*)srcBuff;
+  auto *dst = (typename DstFormat::Sample*)dstBuff;
+  for (size_t i = 0; i < numElems*SrcFormat::elemDepth; i++)
     {
-      auto *src = (float*)srcBuff;
-      auto *dst = (float*)dstBuff;
-      for (size_t i = 0; i < numElems*elemDepth; i++)
-        {
-          dst[i] = float(src[i]) * scaler;
-        }
+      dst[i] = Op::template convert<unity>(src[i], scale);
     }
 }
 
-// CS32 <> CS32
-static void genericCS32toCS32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+//either format is packed: unpack, convert, and pack one element at a time
+template <typename SrcFormat, typename DstFormat, bool unity, typename R>
+static void convertLoop(const void *srcBuff, void *dstBuff, const size_t numElems, const R scale, std::true_type)
 {
-  const size_t elemDepth = 2;
-
-  if (scaler == 1.0)
+  typedef SampleOp<typename SrcFormat::Sample, typename DstFormat::Sample> Op;
+  auto *src = (const typename SrcFormat::Packed*)srcBuff;
+  auto *dst = (typename DstFormat::Packed*)dstBuff;
+  for (size_t i = 0; i < numElems; i++)
     {
-      const size_t sampleSize = sizeof(int32_t);
-      std::memcpy(dstBuff, srcBuff, numElems*elemDepth*sampleSize);
-    }
-  else
-    {
-      auto *src = (int32_t*)srcBuff;
-      auto *dst = (int32_t*)dstBuff;
-      for (size_t i = 0; i < numElems*elemDepth; i++)
+      typename SrcFormat::Sample in[SrcFormat::elemDepth];
+      typename DstFormat::Sample out[DstFormat::elemDepth];
+      SrcFormat::load(src, i, in);
+      for (size_t k = 0; k < SrcFormat::elemDepth; k++)
         {
-          dst[i] = int32_t(src[i]) * scaler;
+          out[k] = Op::template convert<unity>(in[k], scale);
         }
+      DstFormat::store(out, dst, i);
     }
 }
 
-// CS16 <> CS16
-static void genericCS16toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <typename SrcFormat, typename DstFormat>
+static void genericConvert(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
 {
-  const size_t elemDepth = 2;
+  typedef SampleOp<typename SrcFormat::Sample, typename DstFormat::Sample> Op;
+  typedef std::integral_constant<bool, SrcFormat::packed or DstFormat::packed> Packed;
 
   if (scaler == 1.0)
     {
-      const size_t sampleSize = sizeof(int16_t);
-      std::memcpy(dstBuff, srcBuff, numElems*elemDepth*sampleSize);
-    }
-  else
-    {
-      auto *src = (int16_t*)srcBuff;
-      auto *dst = (int16_t*)dstBuff;
-      for (size_t i = 0; i < numElems*elemDepth; i++)
+      if (std::is_same<SrcFormat, DstFormat>::value)
         {
-          dst[i] = int16_t(src[i]) * scaler;
+          if (srcBuff != dstBuff) std::memcpy(dstBuff, srcBuff, numElems*SrcFormat::elemSize);
         }
-    }
-}
-
-// CS8 <> CS8
-static void genericCS8toCS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 2;
-
-  if (scaler == 1.0)
-    {
-      const size_t sampleSize = sizeof(int8_t);
-      std::memcpy(dstBuff, srcBuff, numElems*elemDepth*sampleSize);
-    }
-  else
-    {
-      auto *src = (int8_t*)srcBuff;
-      auto *dst = (int8_t*)dstBuff;
-      for (size_t i = 0; i < numElems*elemDepth; i++)
+      else
         {
-          dst[i] = int8_t(src[i]) * scaler;
+          convertLoop<SrcFormat, DstFormat, true>(srcBuff, dstBuff, numElems, Op::unityScale(), Packed());
         }
     }
-}
-
-// Type Converters
-
-// CF32 <> CS16
-static void genericCF32toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 2;
-
-  auto *src = (float*)srcBuff;
-  auto *dst = (int16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::F32toS16(src[i] * scaler);
-    }
-}
-
-static void genericCS16toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 2;
-
-  auto *src = (int16_t*)srcBuff;
-  auto *dst = (float*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S16toF32(src[i]) * scaler;
-    }
-}
-
-// CF32 <> CU16
-static void genericCF32toCU16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 2;
-
-  auto *src = (float*)srcBuff;
-  auto *dst = (uint16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::F32toU16(src[i] * scaler);
-    }
-}
-
-static void genericCU16toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 2;
-
-  auto *src = (uint16_t*)srcBuff;
-  auto *dst = (float*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
+  else
     {
-      dst[i] = SoapySDR::U16toF32(src[i]) * scaler;
+      convertLoop<SrcFormat, DstFormat, false>(srcBuff, dstBuff, numElems, Op::scale(scaler), Packed());
     }
 }
 
-// CF32 <> CS8
-static void genericCF32toCS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+//float > integer conversion that also counts the clipped samples
+template <typename SrcFormat, typename DstFormat>
+static size_t genericConvertClip(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
 {
-  const size_t elemDepth = 2;
-
-  auto *src = (float*)srcBuff;
-  auto *dst = (int8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
+  typedef SampleOp<typename SrcFormat::Sample, typename DstFormat::Sample> Op;
+  auto *src = (const typename SrcFormat::Packed*)srcBuff;
+  auto *dst = (typename DstFormat::Packed*)dstBuff;
+  const auto scale = Op::scale(scaler);
+  size_t clips = 0;
+  for (size_t i = 0; i < numElems; i++)
     {
-      dst[i] = SoapySDR::F32toS8(src[i] * scaler);
+      typename SrcFormat::Sample in[SrcFormat::elemDepth];
+      typename DstFormat::Sample out[DstFormat::elemDepth];
+      SrcFormat::load(src, i, in);
+      for (size_t k = 0; k < SrcFormat::elemDepth; k++)
+        {
+          clips += Op::clip(in[k], scale)?1:0;
+          out[k] = Op::template convert<false>(in[k], scale);
+        }
+      DstFormat::store(out, dst, i);
     }
+  return clips;
 }
 
-static void genericCS8toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <typename SrcFormat, typename DstFormat,
+  bool clips = SampleOp<typename SrcFormat::Sample, typename DstFormat::Sample>::clips>
+struct GenericClip
 {
-  const size_t elemDepth = 2;
+  static constexpr ClipConverterFunction function(void) { return &genericConvertClip<SrcFormat, DstFormat>; }
+};
 
-  auto *src = (int8_t*)srcBuff;
-  auto *dst = (float*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S8toF32(src[i]) * scaler;
-    }
-}
-
-// CF32 <> CU8
-static void genericCF32toCU8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <typename SrcFormat, typename DstFormat>
+struct GenericClip<SrcFormat, DstFormat, false>
 {
-  const size_t elemDepth = 2;
+  static constexpr ClipConverterFunction function(void) { return nullptr; }
+};
 
-  auto *src = (float*)srcBuff;
-  auto *dst = (uint8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::F32toU8(src[i] * scaler);
-    }
-}
+// ********************************
+// Built-in tables
 
-static void genericCU8toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+template <size_t N>
+struct GenericRow
 {
-  const size_t elemDepth = 2;
+  ConverterHandle converters[N];
+};
 
-  auto *src = (uint8_t*)srcBuff;
-  auto *dst = (float*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::U8toF32(src[i]) * scaler;
-    }
-}
-
-// CS16 <> CU16
-static void genericCS16toCU16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+//one source format to each of the target formats
+template <typename SrcFormat, typename... DstFormats>
+static constexpr GenericRow<sizeof...(DstFormats)> genericRow(void)
 {
-  const size_t elemDepth = 2;
-
-  auto *src = (int16_t*)srcBuff;
-  auto *dst = (uint16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S16toU16(src[i] * scaler);
-    }
+  return {{{&genericConvert<SrcFormat, DstFormats>, nullptr,
+    SrcFormat::elemSize, DstFormats::elemSize, SoapySDR::ConverterRegistry::GENERIC,
+    SrcFormat::id(), DstFormats::id(), DstFormats::elemSize <= SrcFormat::elemSize,
+    GenericClip<SrcFormat, DstFormats>::function(), nullptr}...}};
 }
 
-static void genericCU16toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+//each format to each format, indexed by the offset from the first format id
+template <typename... Formats>
+struct GenericMatrix
 {
-  const size_t elemDepth = 2;
+  static const size_t size = sizeof...(Formats);
+  static const GenericRow<sizeof...(Formats)> rows[sizeof...(Formats)];
+  static const char * const names[sizeof...(Formats)];
+};
 
-  auto *src = (uint16_t*)srcBuff;
-  auto *dst = (int16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::U16toS16(src[i]) * scaler;
-    }
-}
+template <typename... Formats>
+const GenericRow<sizeof...(Formats)> GenericMatrix<Formats...>::rows[sizeof...(Formats)] = {genericRow<Formats, Formats...>()...};
 
-// CS16 <> CS8
-static void genericCS16toCS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 2;
+template <typename... Formats>
+const char * const GenericMatrix<Formats...>::names[sizeof...(Formats)] = {Formats::name()...};
 
-  auto *src = (int16_t*)srcBuff;
-  auto *dst = (int8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S16toS8(src[i] * scaler);
-    }
-}
+typedef GenericMatrix<
+  FormatF64, FormatF32, FormatS32, FormatU32,
+  FormatS16, FormatU16, FormatS8, FormatU8> RealMatrix;
 
-static void genericCS8toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 2;
+typedef GenericMatrix<
+  FormatCF64, FormatCF32, FormatCS32, FormatCU32,
+  FormatCS16, FormatCU16, FormatCS12, FormatCU12,
+  FormatCS8, FormatCU8, FormatCS4, FormatCU4> ComplexMatrix;
 
-  auto *src = (int8_t*)srcBuff;
-  auto *dst = (int16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S8toS16(src[i]) * scaler;
-    }
-}
-
-// CS16 <> CU8
-static void genericCS16toCU8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 2;
-
-  auto *src = (int16_t*)srcBuff;
-  auto *dst = (uint8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S16toU8(src[i] * scaler);
-    }
-}
-
-static void genericCU8toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 2;
-
-  auto *src = (uint8_t*)srcBuff;
-  auto *dst = (int16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::U8toS16(src[i]) * scaler;
-    }
-}
-
-// CU16 <> CS8
-static void genericCU16toCS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+size_t getNumBuiltinFormats(void)
 {
-  const size_t elemDepth = 2;
-
-  auto *src = (uint16_t*)srcBuff;
-  auto *dst = (int8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::U16toS8(src[i] * scaler);
-    }
+  return RealMatrix::size + ComplexMatrix::size;
 }
 
-static void genericCS8toCU16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+const char *getBuiltinFormatName(const FormatId formatId)
 {
-  const size_t elemDepth = 2;
-
-  auto *src = (int8_t*)srcBuff;
-  auto *dst = (uint16_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
-    {
-      dst[i] = SoapySDR::S8toU16(src[i]) * scaler;
-    }
+  if (formatId < RealMatrix::size) return RealMatrix::names[formatId];
+  if (formatId < getNumBuiltinFormats()) return ComplexMatrix::names[formatId-RealMatrix::size];
+  return nullptr;
 }
 
-// CS8 <> CU8
-static void genericCS8toCU8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+const ConverterHandle *getBuiltinConverter(const FormatId sourceFormat, const FormatId targetFormat)
 {
-  const size_t elemDepth = 2;
-
-  auto *src = (int8_t*)srcBuff;
-  auto *dst = (uint8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
+  if (sourceFormat < RealMatrix::size and targetFormat < RealMatrix::size)
     {
-      dst[i] = SoapySDR::S8toU8(src[i] * scaler);
+      return &RealMatrix::rows[sourceFormat].converters[targetFormat];
     }
-}
-
-static void genericCU8toCS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
-{
-  const size_t elemDepth = 2;
-
-  auto *src = (uint8_t*)srcBuff;
-  auto *dst = (int8_t*)dstBuff;
-  for (size_t i = 0; i < numElems*elemDepth; i++)
+  const FormatId first = FormatId(RealMatrix::size);
+  if (sourceFormat >= first and sourceFormat < getNumBuiltinFormats() and
+      targetFormat >= first and targetFormat < getNumBuiltinFormats())
     {
-      dst[i] = SoapySDR::U8toS8(src[i]) * scaler;
+      return &ComplexMatrix::rows[sourceFormat-first].converters[targetFormat-first];
     }
+  return nullptr;
 }
 
 /*!
@@ -648,51 +487,21 @@ static void genericCU8toCS8(const void *srcBuff, void *dstBuff, const size_t num
  * is linked against an older copy of SoapySDR
  * which also tries to load its converters
  * into the running copy of the library.
+ *
+ * The generic converters are not registered here,
+ * the registry consults the built-in tables directly.
  */
 void lateLoadDefaultConverters(void)
 {
-    static SoapySDR::ConverterRegistry registerGenericF32toF32(SOAPY_SDR_F32, SOAPY_SDR_F32, SoapySDR::ConverterRegistry::GENERIC, &genericF32toF32);
-    static SoapySDR::ConverterRegistry registerGenericS32toS32(SOAPY_SDR_S32, SOAPY_SDR_S32, SoapySDR::ConverterRegistry::GENERIC, &genericS32toS32);
-    static SoapySDR::ConverterRegistry registerGenericS16toS16(SOAPY_SDR_S16, SOAPY_SDR_S16, SoapySDR::ConverterRegistry::GENERIC, &genericS16toS16);
-    static SoapySDR::ConverterRegistry registerGenericS8toS8(SOAPY_SDR_S8, SOAPY_SDR_S8, SoapySDR::ConverterRegistry::GENERIC, &genericS8toS8);
-    static SoapySDR::ConverterRegistry registerGenericF32toS16(SOAPY_SDR_F32, SOAPY_SDR_S16, SoapySDR::ConverterRegistry::GENERIC, &genericF32toS16);
-    static SoapySDR::ConverterRegistry registerGenericS16toF32(SOAPY_SDR_S16, SOAPY_SDR_F32, SoapySDR::ConverterRegistry::GENERIC, &genericS16toF32);
-    static SoapySDR::ConverterRegistry registerGenericF32toU16(SOAPY_SDR_F32, SOAPY_SDR_U16, SoapySDR::ConverterRegistry::GENERIC, &genericF32toU16);
-    static SoapySDR::ConverterRegistry registerGenericU16toF32(SOAPY_SDR_U16, SOAPY_SDR_F32, SoapySDR::ConverterRegistry::GENERIC, &genericU16toF32);
-    static SoapySDR::ConverterRegistry registerGenericF32toS8(SOAPY_SDR_F32, SOAPY_SDR_S8, SoapySDR::ConverterRegistry::GENERIC, &genericF32toS8);
-    static SoapySDR::ConverterRegistry registerGenericS8toF32(SOAPY_SDR_S8, SOAPY_SDR_F32, SoapySDR::ConverterRegistry::GENERIC, &genericS8toF32);
-    static SoapySDR::ConverterRegistry registerGenericF32toU8(SOAPY_SDR_F32, SOAPY_SDR_U8, SoapySDR::ConverterRegistry::GENERIC, &genericF32toU8);
-    static SoapySDR::ConverterRegistry registerGenericU8toF32(SOAPY_SDR_U8, SOAPY_SDR_F32, SoapySDR::ConverterRegistry::GENERIC, &genericU8toF32);
-    static SoapySDR::ConverterRegistry registerGenericS16toU16(SOAPY_SDR_S16, SOAPY_SDR_U16, SoapySDR::ConverterRegistry::GENERIC, &genericS16toU16);
-    static SoapySDR::ConverterRegistry registerGenericU16toS16(SOAPY_SDR_U16, SOAPY_SDR_S16, SoapySDR::ConverterRegistry::GENERIC, &genericU16toS16);
-    static SoapySDR::ConverterRegistry registerGenericS16toS8(SOAPY_SDR_S16, SOAPY_SDR_S8, SoapySDR::ConverterRegistry::GENERIC, &genericS16toS8);
-    static SoapySDR::ConverterRegistry registerGenericS8toS16(SOAPY_SDR_S8, SOAPY_SDR_S16, SoapySDR::ConverterRegistry::GENERIC, &genericS8toS16);
-    static SoapySDR::ConverterRegistry registerGenericS16toU8(SOAPY_SDR_S16, SOAPY_SDR_U8, SoapySDR::ConverterRegistry::GENERIC, &genericS16toU8);
-    static SoapySDR::ConverterRegistry registerGenericU8toS16(SOAPY_SDR_U8, SOAPY_SDR_S16, SoapySDR::ConverterRegistry::GENERIC, &genericU8toS16);
-    static SoapySDR::ConverterRegistry registerGenericU16toS8(SOAPY_SDR_U16, SOAPY_SDR_S8, SoapySDR::ConverterRegistry::GENERIC, &genericU16toS8);
-    static SoapySDR::ConverterRegistry registerGenericS8toU16(SOAPY_SDR_S8, SOAPY_SDR_U16, SoapySDR::ConverterRegistry::GENERIC, &genericS8toU16);
-    static SoapySDR::ConverterRegistry registerGenericS8toU8(SOAPY_SDR_S8, SOAPY_SDR_U8, SoapySDR::ConverterRegistry::GENERIC, &genericS8toU8);
-    static SoapySDR::ConverterRegistry registerGenericU8toS8(SOAPY_SDR_U8, SOAPY_SDR_S8, SoapySDR::ConverterRegistry::GENERIC, &genericU8toS8);
-    static SoapySDR::ConverterRegistry registerGenericCF32toCF32(SOAPY_SDR_CF32, SOAPY_SDR_CF32, SoapySDR::ConverterRegistry::GENERIC, &genericCF32toCF32);
-    static SoapySDR::ConverterRegistry registerGenericCS32toCS32(SOAPY_SDR_CS32, SOAPY_SDR_CS32, SoapySDR::ConverterRegistry::GENERIC, &genericCS32toCS32);
-    static SoapySDR::ConverterRegistry registerGenericCS16toCS16(SOAPY_SDR_CS16, SOAPY_SDR_CS16, SoapySDR::ConverterRegistry::GENERIC, &genericCS16toCS16);
-    static SoapySDR::ConverterRegistry registerGenericCS8toCS8(SOAPY_SDR_CS8, SOAPY_SDR_CS8, SoapySDR::ConverterRegistry::GENERIC, &genericCS8toCS8);
-    static SoapySDR::ConverterRegistry registerGenericCF32toCS16(SOAPY_SDR_CF32, SOAPY_SDR_CS16, SoapySDR::ConverterRegistry::GENERIC, &genericCF32toCS16);
-    static SoapySDR::ConverterRegistry registerGenericCS16toCF32(SOAPY_SDR_CS16, SOAPY_SDR_CF32, SoapySDR::ConverterRegistry::GENERIC, &genericCS16toCF32);
-    static SoapySDR::ConverterRegistry registerGenericCF32toCU16(SOAPY_SDR_CF32, SOAPY_SDR_CU16, SoapySDR::ConverterRegistry::GENERIC, &genericCF32toCU16);
-    static SoapySDR::ConverterRegistry registerGenericCU16toCF32(SOAPY_SDR_CU16, SOAPY_SDR_CF32, SoapySDR::ConverterRegistry::GENERIC, &genericCU16toCF32);
-    static SoapySDR::ConverterRegistry registerGenericCF32toCS8(SOAPY_SDR_CF32, SOAPY_SDR_CS8, SoapySDR::ConverterRegistry::GENERIC, &genericCF32toCS8);
-    static SoapySDR::ConverterRegistry registerGenericCS8toCF32(SOAPY_SDR_CS8, SOAPY_SDR_CF32, SoapySDR::ConverterRegistry::GENERIC, &genericCS8toCF32);
-    static SoapySDR::ConverterRegistry registerGenericCF32toCU8(SOAPY_SDR_CF32, SOAPY_SDR_CU8, SoapySDR::ConverterRegistry::GENERIC, &genericCF32toCU8);
-    static SoapySDR::ConverterRegistry registerGenericCU8toCF32(SOAPY_SDR_CU8, SOAPY_SDR_CF32, SoapySDR::ConverterRegistry::GENERIC, &genericCU8toCF32);
-    static SoapySDR::ConverterRegistry registerGenericCS16toCU16(SOAPY_SDR_CS16, SOAPY_SDR_CU16, SoapySDR::ConverterRegistry::GENERIC, &genericCS16toCU16);
-    static SoapySDR::ConverterRegistry registerGenericCU16toCS16(SOAPY_SDR_CU16, SOAPY_SDR_CS16, SoapySDR::ConverterRegistry::GENERIC, &genericCU16toCS16);
-    static SoapySDR::ConverterRegistry registerGenericCS16toCS8(SOAPY_SDR_CS16, SOAPY_SDR_CS8, SoapySDR::ConverterRegistry::GENERIC, &genericCS16toCS8);
-    static SoapySDR::ConverterRegistry registerGenericCS8toCS16(SOAPY_SDR_CS8, SOAPY_SDR_CS16, SoapySDR::ConverterRegistry::GENERIC, &genericCS8toCS16);
-    static SoapySDR::ConverterRegistry registerGenericCS16toCU8(SOAPY_SDR_CS16, SOAPY_SDR_CU8, SoapySDR::ConverterRegistry::GENERIC, &genericCS16toCU8);
-    static SoapySDR::ConverterRegistry registerGenericCU8toCS16(SOAPY_SDR_CU8, SOAPY_SDR_CS16, SoapySDR::ConverterRegistry::GENERIC, &genericCU8toCS16);
-    static SoapySDR::ConverterRegistry registerGenericCU16toCS8(SOAPY_SDR_CU16, SOAPY_SDR_CS8, SoapySDR::ConverterRegistry::GENERIC, &genericCU16toCS8);
-    static SoapySDR::ConverterRegistry registerGenericCS8toCU16(SOAPY_SDR_CS8, SOAPY_SDR_CU16, SoapySDR::ConverterRegistry::GENERIC, &genericCS8toCU16);
-    static SoapySDR::ConverterRegistry registerGenericCS8toCU8(SOAPY_SDR_CS8, SOAPY_SDR_CU8, SoapySDR::ConverterRegistry::GENERIC, &genericCS8toCU8);
-    static SoapySDR::ConverterRegistry registerGenericCU8toCS8(SOAPY_SDR_CU8, SOAPY_SDR_CS8, SoapySDR::ConverterRegistry::GENERIC, &genericCU8toCS8);
+    //SIMD converters selected for the running CPU
+    lateLoadVectorizedConverters();
+
+    //fused format conversion and channel (de)interleaving
+    lateLoadInterleaveConverters();
+
+    //fused format conversion and DC offset/IQ balance correction
+    lateLoadCorrectionConverters();
+
+    //fused format conversion and level statistics
+    lateLoadStatsConverters();
 }
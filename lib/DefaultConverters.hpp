@@ -0,0 +1,27 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <cstddef>
+
+/*******************************************************************
+ * Built-in generic converters
+ *
+ * The generic converter for each pair of real or complex formats
+ * in Formats.h is a constant handle in a static table. The table is
+ * consulted directly and never registered, so it costs nothing at
+ * startup. The built-in formats take the first format ids in the
+ * registry, in the order given by getBuiltinFormatName().
+ ******************************************************************/
+
+//! Get the number of built-in formats
+size_t getNumBuiltinFormats(void);
+
+//! Get the markup string of a built-in format, or nullptr for other ids
+const char *getBuiltinFormatName(const SoapySDR::ConverterRegistry::FormatId formatId);
+
+//! Get the generic converter for a pair of built-in formats, or nullptr when there is none
+const SoapySDR::ConverterRegistry::ConverterHandle *getBuiltinConverter(
+    const SoapySDR::ConverterRegistry::FormatId sourceFormat,
+    const SoapySDR::ConverterRegistry::FormatId targetFormat);
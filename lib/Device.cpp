@@ -5,12 +5,26 @@
 
 #include <SoapySDR/Device.hpp>
 #include <SoapySDR/Formats.hpp>
+#include <SoapySDR/Logger.hpp>
 #include <cstdlib>
 #include <algorithm> //min/max/find
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+static bool hasStreamCallbacks(SoapySDR::Device *device);
+static void stopStreamCallbacks(SoapySDR::Device *device, SoapySDR::Stream *stream, const bool all);
 
 SoapySDR::Device::~Device(void)
 {
-    return;
+    //the derived destructor has already run, so a delivery thread may have called into it
+    if (not hasStreamCallbacks(this)) return;
+    SoapySDR::log(SOAPY_SDR_ERROR, "Device::~Device() stream callback still running, stop the delivery in closeStream() or the driver destructor");
+    stopStreamCallbacks(this, nullptr, true);
 }
 
 /*******************************************************************
@@ -87,9 +101,9 @@ SoapySDR::Stream *SoapySDR::Device::setupStream(const int, const std::string &,
     return nullptr;
 }
 
-void SoapySDR::Device::closeStream(Stream *)
+void SoapySDR::Device::closeStream(Stream *stream)
 {
-    return;
+    stopStreamCallbacks(this, stream, false);
 }
 
 size_t SoapySDR::Device::getStreamMTU(Stream *) const
@@ -123,6 +137,35 @@ int SoapySDR::Device::readStreamStatus(Stream *, size_t &, int &, long long &, c
     return SOAPY_SDR_NOT_SUPPORTED;
 }
 
+int SoapySDR::Device::readStreamMulti(Stream *stream, StreamPacket *packets, const size_t numPackets, const long timeoutUs)
+{
+    //only the first packet waits, the rest are filled while data is ready
+    for (size_t i = 0; i < numPackets; i++)
+    {
+        auto &packet = packets[i];
+        packet.ret = this->readStream(stream, packet.buffs, packet.numElems, packet.flags, packet.timeNs, (i == 0)?timeoutUs:0);
+        //the error of a later packet is reported in its ret field
+        if (packet.ret < 0) return (i == 0)?packet.ret:int(i);
+    }
+    return int(numPackets);
+}
+
+int SoapySDR::Device::writeStreamMulti(Stream *stream, StreamPacket *packets, const size_t numPackets, const long timeoutUs)
+{
+    //only the first packet waits, the rest are written while space is available
+    for (size_t i = 0; i < numPackets; i++)
+    {
+        auto &packet = packets[i];
+        packet.ret = this->writeStream(stream, packet.buffs, packet.numElems, packet.flags, packet.timeNs, (i == 0)?timeoutUs:0);
+        //the error of a later packet is reported in its ret field
+        if (packet.ret < 0) return (i == 0)?packet.ret:int(i);
+
+        //a partial write leaves the remainder of the packet to the caller
+        if (size_t(packet.ret) < packet.numElems) return int(i+1);
+    }
+    return int(numPackets);
+}
+
 /*******************************************************************
  * Direct buffer access API
  ******************************************************************/
@@ -156,6 +199,165 @@ void SoapySDR::Device::releaseWriteBuffer(Stream *, const size_t, const size_t,
     return;
 }
 
+/*******************************************************************
+ * Generic stream callback: a thread per stream calls acquireReadBuffer()
+ ******************************************************************/
+struct StreamCallbackWorker
+{
+    std::atomic<bool> running;
+    std::thread thread;
+
+    //the worker that this one replaced, which must finish before this one acquires
+    std::shared_ptr<StreamCallbackWorker> previous;
+    std::promise<void> done;
+    std::shared_future<void> finished;
+};
+
+//the loop holds a reference, so a worker stopped from its own callback can be detached
+typedef std::map<std::pair<SoapySDR::Device *, SoapySDR::Stream *>, std::shared_ptr<StreamCallbackWorker>> StreamCallbackWorkers;
+
+static std::mutex &getStreamCallbackMutex(void)
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+static StreamCallbackWorkers &getStreamCallbackWorkers(void)
+{
+    static StreamCallbackWorkers workers;
+    return workers;
+}
+
+static void streamCallbackLoop(SoapySDR::Device *device, SoapySDR::Stream *stream, const SoapySDR::StreamCallback callback, std::shared_ptr<StreamCallbackWorker> worker)
+{
+    //only one thread acquires from the stream at a time
+    if (worker->previous)
+    {
+        worker->previous->finished.wait();
+        worker->previous.reset();
+    }
+
+    //the stream channels are a subset of the device channels
+    std::vector<const void *> buffs(std::max<size_t>(device->getNumChannels(SOAPY_SDR_RX), 1));
+
+    //repeated errors back off up to the acquire timeout, so a failed stream does not flood the callback
+    const long timeoutUs(100000);
+    long backoffUs(0);
+    try
+    {
+        while (worker->running)
+        {
+            size_t handle(0);
+            int flags(0);
+            long long timeNs(0);
+            const int ret = device->acquireReadBuffer(stream, handle, buffs.data(), flags, timeNs, timeoutUs);
+            if (ret == SOAPY_SDR_TIMEOUT) continue;
+            callback(stream, handle, buffs.data(), ret, flags, timeNs);
+            if (ret == SOAPY_SDR_NOT_SUPPORTED) break;
+            if (ret >= 0)
+            {
+                backoffUs = 0;
+                continue;
+            }
+            if (backoffUs != 0) std::this_thread::sleep_for(std::chrono::microseconds(backoffUs));
+            backoffUs = std::min(std::max<long>(backoffUs*2, 1000), timeoutUs);
+        }
+    }
+    catch (const std::exception &ex)
+    {
+        SoapySDR::logf(SOAPY_SDR_ERROR, "Device::setStreamCallback() delivery stopped: %s", ex.what());
+    }
+    worker->done.set_value();
+}
+
+static bool hasStreamCallbacks(SoapySDR::Device *device)
+{
+    std::lock_guard<std::mutex> lock(getStreamCallbackMutex());
+    for (const auto &pair : getStreamCallbackWorkers())
+    {
+        if (pair.first.first == device) return true;
+    }
+    return false;
+}
+
+/*!
+ * Stop a worker that was removed from the workers map and wait for it,
+ * except when called from its own callback.
+ */
+static void joinStreamCallback(const std::shared_ptr<StreamCallbackWorker> &worker)
+{
+    worker->running = false;
+    if (worker->thread.get_id() == std::this_thread::get_id()) worker->thread.detach();
+    else worker->thread.join();
+}
+
+/*!
+ * Stop the callback delivery for one stream of a device,
+ * or for every stream of the device when stream is nullptr and all is set.
+ * Waits for the delivery threads to finish, except when called
+ * from a callback, where the calling thread finishes after it returns.
+ */
+static void stopStreamCallbacks(SoapySDR::Device *device, SoapySDR::Stream *stream, const bool all)
+{
+    std::vector<std::shared_ptr<StreamCallbackWorker>> stopped;
+    {
+        std::lock_guard<std::mutex> lock(getStreamCallbackMutex());
+        auto &workers = getStreamCallbackWorkers();
+        for (auto it = workers.begin(); it != workers.end();)
+        {
+            if (it->first.first != device or (not all and it->first.second != stream)) ++it;
+            else
+            {
+                stopped.push_back(std::move(it->second));
+                it = workers.erase(it);
+            }
+        }
+    }
+    for (const auto &worker : stopped) joinStreamCallback(worker);
+}
+
+/*!
+ * stopDeviceStreamCallbacks() is called by Device::unmake()
+ * so the delivery stops while the implementation is still intact.
+ */
+void stopDeviceStreamCallbacks(SoapySDR::Device *device)
+{
+    stopStreamCallbacks(device, nullptr, true);
+}
+
+int SoapySDR::Device::setStreamCallback(Stream *stream, const StreamCallback &callback)
+{
+    if (not callback)
+    {
+        stopStreamCallbacks(this, stream, false);
+        return 0;
+    }
+    if (this->getNumDirectAccessBuffers(stream) == 0)
+    {
+        stopStreamCallbacks(this, stream, false);
+        return SOAPY_SDR_NOT_SUPPORTED;
+    }
+
+    //replace the current worker in one step, so concurrent calls leave exactly one registered;
+    //the new worker waits for the replaced one, so only one thread acquires from the stream
+    std::shared_ptr<StreamCallbackWorker> worker(new StreamCallbackWorker());
+    worker->running = true;
+    worker->finished = worker->done.get_future().share();
+    std::shared_ptr<StreamCallbackWorker> replaced;
+    {
+        std::lock_guard<std::mutex> lock(getStreamCallbackMutex());
+        auto &workers = getStreamCallbackWorkers();
+        const auto key = std::make_pair(this, stream);
+        const auto it = workers.find(key);
+        if (it != workers.end()) worker->previous = it->second;
+        worker->thread = std::thread(&streamCallbackLoop, this, stream, callback, worker);
+        replaced = worker->previous;
+        workers[key] = worker;
+    }
+    if (replaced) joinStreamCallback(replaced);
+    return 0;
+}
+
 /*******************************************************************
  * Antenna API
  ******************************************************************/
@@ -6,7 +6,9 @@
 #include "TypeHelpers.hpp"
 #include <SoapySDR/Device.h>
 #include <SoapySDR/Device.hpp>
+#include <SoapySDR/StreamBuffers.hpp>
 #include <algorithm>
+#include <cstddef> //offsetof
 #include <cstdlib>
 #include <cstring>
 #include <cmath> //NAN
@@ -18,6 +20,13 @@
 #define __thread __declspec(thread)
 #endif
 
+static_assert(sizeof(SoapySDR::StreamPacket) == sizeof(SoapySDRStreamPacket), "StreamPacket");
+static_assert(offsetof(SoapySDR::StreamPacket, buffs) == offsetof(SoapySDRStreamPacket, buffs), "StreamPacket::buffs");
+static_assert(offsetof(SoapySDR::StreamPacket, numElems) == offsetof(SoapySDRStreamPacket, numElems), "StreamPacket::numElems");
+static_assert(offsetof(SoapySDR::StreamPacket, flags) == offsetof(SoapySDRStreamPacket, flags), "StreamPacket::flags");
+static_assert(offsetof(SoapySDR::StreamPacket, timeNs) == offsetof(SoapySDRStreamPacket, timeNs), "StreamPacket::timeNs");
+static_assert(offsetof(SoapySDR::StreamPacket, ret) == offsetof(SoapySDRStreamPacket, ret), "StreamPacket::ret");
+
 static __thread int lastErrorStatus;
 
 static __thread char lastErrorMsg[1024];
@@ -220,6 +229,20 @@ int SoapySDRDevice_readStreamStatus(SoapySDRDevice *device, SoapySDRStream *stre
     __SOAPY_SDR_C_CATCH_RET(SOAPY_SDR_STREAM_ERROR);
 }
 
+int SoapySDRDevice_readStreamMulti(SoapySDRDevice *device, SoapySDRStream *stream, SoapySDRStreamPacket *packets, const size_t numPackets, const long timeoutUs)
+{
+    __SOAPY_SDR_C_TRY
+    return device->readStreamMulti(reinterpret_cast<SoapySDR::Stream *>(stream), reinterpret_cast<SoapySDR::StreamPacket *>(packets), numPackets, timeoutUs);
+    __SOAPY_SDR_C_CATCH_RET(SOAPY_SDR_STREAM_ERROR);
+}
+
+int SoapySDRDevice_writeStreamMulti(SoapySDRDevice *device, SoapySDRStream *stream, SoapySDRStreamPacket *packets, const size_t numPackets, const long timeoutUs)
+{
+    __SOAPY_SDR_C_TRY
+    return device->writeStreamMulti(reinterpret_cast<SoapySDR::Stream *>(stream), reinterpret_cast<SoapySDR::StreamPacket *>(packets), numPackets, timeoutUs);
+    __SOAPY_SDR_C_CATCH_RET(SOAPY_SDR_STREAM_ERROR);
+}
+
 /*******************************************************************
  * Direct buffer access API
  ******************************************************************/
@@ -282,6 +305,40 @@ void SoapySDRDevice_releaseWriteBuffer(SoapySDRDevice *device,
     __SOAPY_SDR_C_CATCH_RET(SoapySDRVoidRet);
 }
 
+int SoapySDRDevice_setStreamCallback(SoapySDRDevice *device,
+    SoapySDRStream *stream,
+    SoapySDRStreamCallback callback,
+    void *userData)
+{
+    __SOAPY_SDR_C_TRY
+    if (callback == nullptr) return device->setStreamCallback(reinterpret_cast<SoapySDR::Stream *>(stream), SoapySDR::StreamCallback());
+    return device->setStreamCallback(reinterpret_cast<SoapySDR::Stream *>(stream),
+        [callback, userData](SoapySDR::Stream *s, const size_t handle, const void * const *buffs, const int ret, const int flags, const long long timeNs)
+        {
+            callback(reinterpret_cast<SoapySDRStream *>(s), handle, buffs, ret, flags, timeNs, userData);
+        });
+    __SOAPY_SDR_C_CATCH_RET(SOAPY_SDR_STREAM_ERROR);
+}
+
+void **SoapySDRDevice_allocStreamBuffers(SoapySDRDevice *device,
+    SoapySDRStream *stream,
+    const int direction,
+    const char *format,
+    const size_t numBuffs,
+    const SoapySDRKwargs *args)
+{
+    __SOAPY_SDR_C_TRY
+    return SoapySDR::allocStreamBuffers(device, reinterpret_cast<SoapySDR::Stream *>(stream), direction, format, numBuffs, toKwargs(args));
+    __SOAPY_SDR_C_CATCH_RET(nullptr);
+}
+
+void SoapySDRDevice_freeStreamBuffers(void **buffs)
+{
+    __SOAPY_SDR_C_TRY
+    return SoapySDR::freeStreamBuffers(buffs);
+    __SOAPY_SDR_C_CATCH_RET(SoapySDRVoidRet);
+}
+
 /*******************************************************************
  * Antenna API
  ******************************************************************/
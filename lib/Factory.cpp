@@ -14,6 +14,8 @@
 #include <chrono>
 #include <mutex>
 
+void stopDeviceStreamCallbacks(SoapySDR::Device *device);
+
 static std::recursive_mutex &getFactoryMutex(void)
 {
     static std::recursive_mutex mutex;
@@ -233,6 +235,7 @@ void SoapySDR::Device::unmake(Device *device)
 
     //do not block other callers while we wait on destructor
     lock.unlock();
+    stopDeviceStreamCallbacks(device);
     delete device;
     lock.lock();
 
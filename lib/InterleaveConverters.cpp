@@ -0,0 +1,590 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "CPUFeatures.hpp"
+#include "ConverterKernels.hpp"
+#include <SoapySDR/ConverterPrimitives.hpp>
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <SoapySDR/Formats.hpp>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#ifdef SOAPY_SDR_X86
+#include <immintrin.h>
+#endif
+
+/***********************************************************************
+ * Channel converters for multi-channel interleaved streams.
+ *
+ * Deinterleavers read one buffer of complex elements ordered
+ * ch0, ch1, ..., chN-1, ch0, ... and write one buffer per channel.
+ * Interleavers do the reverse. The format conversion is fused into the
+ * same loop, so each sample is read and written exactly once.
+ *
+ * Any number of channels is supported; 2 and 4 channels have SIMD
+ * kernels that process the bulk of the buffer before the scalar loop
+ * finishes the remainder with identical semantics.
+ **********************************************************************/
+
+typedef SoapySDR::ConverterRegistry::BatchConverterFunction BatchConverterFunction;
+
+// ********************************
+// Sample conversions
+
+//! Same-format copy, the format conversions are in ConverterKernels.hpp
+template <typename T, bool unity>
+struct CopyInt
+{
+  typedef T SrcType; typedef T DstType;
+  static float scale(const double scaler) { return float(scaler); }
+  static T convert(const T in, const float scale) { return unity?in:SoapySDR::SaturateInt<T>(in*scale); }
+};
+
+// ********************************
+// Generic N-way loops
+
+template <typename Op>
+static void deinterleaveRange(const void *srcBuff, void * const *dstBuffs, const size_t numChans, const size_t first, const size_t last, const float scale)
+{
+  auto *src = (const typename Op::SrcType*)srcBuff;
+  for (size_t i = first; i < last; i++)
+    {
+      for (size_t ch = 0; ch < numChans; ch++)
+        {
+          auto *dst = (typename Op::DstType*)dstBuffs[ch];
+          const auto *in = src + (i*numChans+ch)*2;
+          dst[i*2+0] = Op::convert(in[0], scale);
+          dst[i*2+1] = Op::convert(in[1], scale);
+        }
+    }
+}
+
+template <typename Op>
+static void interleaveRange(const void * const *srcBuffs, void *dstBuff, const size_t numChans, const size_t first, const size_t last, const float scale)
+{
+  auto *dst = (typename Op::DstType*)dstBuff;
+  for (size_t i = first; i < last; i++)
+    {
+      for (size_t ch = 0; ch < numChans; ch++)
+        {
+          const auto *src = (const typename Op::SrcType*)srcBuffs[ch];
+          auto *out = dst + (i*numChans+ch)*2;
+          out[0] = Op::convert(src[i*2+0], scale);
+          out[1] = Op::convert(src[i*2+1], scale);
+        }
+    }
+}
+
+template <typename Op>
+static void genericDeinterleave(const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler)
+{
+  deinterleaveRange<Op>(srcBuffs[0], dstBuffs, numChans, 0, numElems, Op::scale(scaler));
+}
+
+template <typename Op>
+static void genericInterleave(const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler)
+{
+  interleaveRange<Op>(srcBuffs, dstBuffs[0], numChans, 0, numElems, Op::scale(scaler));
+}
+
+//the unity scale copy is selected once per call rather than tested per sample
+template <typename T>
+static void copyDeinterleave(const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler)
+{
+  if (scaler == 1.0) genericDeinterleave<CopyInt<T, true>>(srcBuffs, dstBuffs, numChans, numElems, scaler);
+  else genericDeinterleave<CopyInt<T, false>>(srcBuffs, dstBuffs, numChans, numElems, scaler);
+}
+
+template <typename T>
+static void copyInterleave(const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler)
+{
+  if (scaler == 1.0) genericInterleave<CopyInt<T, true>>(srcBuffs, dstBuffs, numChans, numElems, scaler);
+  else genericInterleave<CopyInt<T, false>>(srcBuffs, dstBuffs, numChans, numElems, scaler);
+}
+
+// ********************************
+// Vectorized 2 and 4 channel dispatch
+
+//! A SIMD kernel for a fixed channel count, returns the number of elements processed
+typedef size_t (*DeinterleaveKernel)(const void *, void * const *, const size_t, const float);
+typedef size_t (*InterleaveKernel)(const void * const *, void *, const size_t, const float);
+
+template <typename Op, DeinterleaveKernel kernel2, DeinterleaveKernel kernel4>
+static void vectorDeinterleave(const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler)
+{
+  const float scale = Op::scale(scaler);
+  size_t i = 0;
+  if (numChans == 2) i = kernel2(srcBuffs[0], dstBuffs, numElems, scale);
+  if (numChans == 4) i = kernel4(srcBuffs[0], dstBuffs, numElems, scale);
+  deinterleaveRange<Op>(srcBuffs[0], dstBuffs, numChans, i, numElems, scale);
+}
+
+template <typename Op, InterleaveKernel kernel2, InterleaveKernel kernel4>
+static void vectorInterleave(const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler)
+{
+  const float scale = Op::scale(scaler);
+  size_t i = 0;
+  if (numChans == 2) i = kernel2(srcBuffs, dstBuffs[0], numElems, scale);
+  if (numChans == 4) i = kernel4(srcBuffs, dstBuffs[0], numElems, scale);
+  interleaveRange<Op>(srcBuffs, dstBuffs[0], numChans, i, numElems, scale);
+}
+
+#ifdef SOAPY_SDR_X86
+
+// ********************************
+// SSE2 kernels
+
+SOAPY_SDR_TARGET("sse2")
+static inline __m128 sse2S16toF32lo(const __m128i in, const __m128 scale)
+{
+  return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16)), scale);
+}
+
+SOAPY_SDR_TARGET("sse2")
+static inline __m128 sse2S16toF32hi(const __m128i in, const __m128 scale)
+{
+  return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16)), scale);
+}
+
+SOAPY_SDR_TARGET("sse2")
+static inline __m128i sse2F32toS16(const float *src0, const float *src1, const __m128 scale)
+{
+  const __m128 lo = _mm_set1_ps(-32768.0f);
+  const __m128 hi = _mm_set1_ps(32767.0f);
+  //not-a-number lanes are zeroed like SoapySDR::SaturateInt()
+  const __m128 a0 = _mm_mul_ps(_mm_loadu_ps(src0), scale);
+  const __m128 b0 = _mm_mul_ps(_mm_loadu_ps(src1), scale);
+  const __m128 a = _mm_min_ps(_mm_max_ps(_mm_and_ps(a0, _mm_cmpord_ps(a0, a0)), lo), hi);
+  const __m128 b = _mm_min_ps(_mm_max_ps(_mm_and_ps(b0, _mm_cmpord_ps(b0, b0)), lo), hi);
+  return _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b));
+}
+
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Deinterleave2CS16toCF32(const void *srcBuff, void * const *dstBuffs, const size_t numElems, const float scale)
+{
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  auto *src = (const int16_t*)srcBuff;
+  auto *dst0 = (float*)dstBuffs[0];
+  auto *dst1 = (float*)dstBuffs[1];
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      //complex elements are 32 bits: gather the even and odd elements
+      const __m128i in = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(src+i*4)), _MM_SHUFFLE(3, 1, 2, 0));
+      _mm_storeu_ps(dst0+i*2, sse2S16toF32lo(in, scaleVec));
+      _mm_storeu_ps(dst1+i*2, sse2S16toF32hi(in, scaleVec));
+    }
+  return i;
+}
+
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Deinterleave4CS16toCF32(const void *srcBuff, void * const *dstBuffs, const size_t numElems, const float scale)
+{
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  auto *src = (const int16_t*)srcBuff;
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      const __m128i a = _mm_loadu_si128((const __m128i*)(src+i*8+0));
+      const __m128i b = _mm_loadu_si128((const __m128i*)(src+i*8+8));
+      //transpose 2x4 complex elements into ch0|ch1 and ch2|ch3
+      const __m128i ch01 = _mm_unpacklo_epi32(a, b);
+      const __m128i ch23 = _mm_unpackhi_epi32(a, b);
+      _mm_storeu_ps(((float*)dstBuffs[0])+i*2, sse2S16toF32lo(ch01, scaleVec));
+      _mm_storeu_ps(((float*)dstBuffs[1])+i*2, sse2S16toF32hi(ch01, scaleVec));
+      _mm_storeu_ps(((float*)dstBuffs[2])+i*2, sse2S16toF32lo(ch23, scaleVec));
+      _mm_storeu_ps(((float*)dstBuffs[3])+i*2, sse2S16toF32hi(ch23, scaleVec));
+    }
+  return i;
+}
+
+//! Load 16 bytes as signed 8-bit samples, CU8 is CS8 with the sign bit flipped
+template <typename Op>
+SOAPY_SDR_TARGET("sse2")
+static inline __m128i sse2LoadS8(const void *src)
+{
+  const __m128i in = _mm_loadu_si128((const __m128i*)src);
+  return std::is_unsigned<typename Op::SrcType>::value?_mm_xor_si128(in, _mm_set1_epi8(char(0x80))):in;
+}
+
+template <typename Op>
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Deinterleave2C8toCF32(const void *srcBuff, void * const *dstBuffs, const size_t numElems, const float scale)
+{
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  auto *src = (const uint8_t*)srcBuff;
+  auto *dst0 = (float*)dstBuffs[0];
+  auto *dst1 = (float*)dstBuffs[1];
+  size_t i = 0;
+  for (; i+4 <= numElems; i += 4)
+    {
+      const __m128i in = sse2LoadS8<Op>(src+i*4);
+      //sign extend to 16 bits, then gather the even and odd 32-bit complex elements
+      const __m128i lo = _mm_shuffle_epi32(_mm_srai_epi16(_mm_unpacklo_epi8(in, in), 8), _MM_SHUFFLE(3, 1, 2, 0));
+      const __m128i hi = _mm_shuffle_epi32(_mm_srai_epi16(_mm_unpackhi_epi8(in, in), 8), _MM_SHUFFLE(3, 1, 2, 0));
+      _mm_storeu_ps(dst0+i*2+0, sse2S16toF32lo(lo, scaleVec));
+      _mm_storeu_ps(dst0+i*2+4, sse2S16toF32lo(hi, scaleVec));
+      _mm_storeu_ps(dst1+i*2+0, sse2S16toF32hi(lo, scaleVec));
+      _mm_storeu_ps(dst1+i*2+4, sse2S16toF32hi(hi, scaleVec));
+    }
+  return i;
+}
+
+template <typename Op>
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Deinterleave4C8toCF32(const void *srcBuff, void * const *dstBuffs, const size_t numElems, const float scale)
+{
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  auto *src = (const uint8_t*)srcBuff;
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      const __m128i in = sse2LoadS8<Op>(src+i*8);
+      const __m128i a = _mm_srai_epi16(_mm_unpacklo_epi8(in, in), 8);
+      const __m128i b = _mm_srai_epi16(_mm_unpackhi_epi8(in, in), 8);
+      //transpose 2x4 complex elements into ch0|ch1 and ch2|ch3
+      const __m128i ch01 = _mm_unpacklo_epi32(a, b);
+      const __m128i ch23 = _mm_unpackhi_epi32(a, b);
+      _mm_storeu_ps(((float*)dstBuffs[0])+i*2, sse2S16toF32lo(ch01, scaleVec));
+      _mm_storeu_ps(((float*)dstBuffs[1])+i*2, sse2S16toF32hi(ch01, scaleVec));
+      _mm_storeu_ps(((float*)dstBuffs[2])+i*2, sse2S16toF32lo(ch23, scaleVec));
+      _mm_storeu_ps(((float*)dstBuffs[3])+i*2, sse2S16toF32hi(ch23, scaleVec));
+    }
+  return i;
+}
+
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Interleave2CF32toCS16(const void * const *srcBuffs, void *dstBuff, const size_t numElems, const float scale)
+{
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  auto *src0 = (const float*)srcBuffs[0];
+  auto *src1 = (const float*)srcBuffs[1];
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      const __m128i packed = sse2F32toS16(src0+i*2, src1+i*2, scaleVec);
+      _mm_storeu_si128((__m128i*)(dst+i*4), _mm_shuffle_epi32(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+  return i;
+}
+
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Interleave4CF32toCS16(const void * const *srcBuffs, void *dstBuff, const size_t numElems, const float scale)
+{
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      const __m128i ch01 = _mm_shuffle_epi32(sse2F32toS16(((const float*)srcBuffs[0])+i*2, ((const float*)srcBuffs[1])+i*2, scaleVec), _MM_SHUFFLE(3, 1, 2, 0));
+      const __m128i ch23 = _mm_shuffle_epi32(sse2F32toS16(((const float*)srcBuffs[2])+i*2, ((const float*)srcBuffs[3])+i*2, scaleVec), _MM_SHUFFLE(3, 1, 2, 0));
+      _mm_storeu_si128((__m128i*)(dst+i*8+0), _mm_unpacklo_epi64(ch01, ch23));
+      _mm_storeu_si128((__m128i*)(dst+i*8+8), _mm_unpackhi_epi64(ch01, ch23));
+    }
+  return i;
+}
+
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Deinterleave2CF32toCF32(const void *srcBuff, void * const *dstBuffs, const size_t numElems, const float scale)
+{
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  auto *src = (const float*)srcBuff;
+  auto *dst0 = (float*)dstBuffs[0];
+  auto *dst1 = (float*)dstBuffs[1];
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      const __m128 a = _mm_loadu_ps(src+i*4+0);
+      const __m128 b = _mm_loadu_ps(src+i*4+4);
+      _mm_storeu_ps(dst0+i*2, _mm_mul_ps(_mm_movelh_ps(a, b), scaleVec));
+      _mm_storeu_ps(dst1+i*2, _mm_mul_ps(_mm_movehl_ps(b, a), scaleVec));
+    }
+  return i;
+}
+
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Deinterleave4CF32toCF32(const void *srcBuff, void * const *dstBuffs, const size_t numElems, const float scale)
+{
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  auto *src = (const float*)srcBuff;
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      const __m128 a01 = _mm_loadu_ps(src+i*8+0);
+      const __m128 a23 = _mm_loadu_ps(src+i*8+4);
+      const __m128 b01 = _mm_loadu_ps(src+i*8+8);
+      const __m128 b23 = _mm_loadu_ps(src+i*8+12);
+      _mm_storeu_ps(((float*)dstBuffs[0])+i*2, _mm_mul_ps(_mm_movelh_ps(a01, b01), scaleVec));
+      _mm_storeu_ps(((float*)dstBuffs[1])+i*2, _mm_mul_ps(_mm_movehl_ps(b01, a01), scaleVec));
+      _mm_storeu_ps(((float*)dstBuffs[2])+i*2, _mm_mul_ps(_mm_movelh_ps(a23, b23), scaleVec));
+      _mm_storeu_ps(((float*)dstBuffs[3])+i*2, _mm_mul_ps(_mm_movehl_ps(b23, a23), scaleVec));
+    }
+  return i;
+}
+
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Interleave2CF32toCF32(const void * const *srcBuffs, void *dstBuff, const size_t numElems, const float scale)
+{
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  auto *src0 = (const float*)srcBuffs[0];
+  auto *src1 = (const float*)srcBuffs[1];
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      const __m128 a = _mm_mul_ps(_mm_loadu_ps(src0+i*2), scaleVec);
+      const __m128 b = _mm_mul_ps(_mm_loadu_ps(src1+i*2), scaleVec);
+      _mm_storeu_ps(dst+i*4+0, _mm_movelh_ps(a, b));
+      _mm_storeu_ps(dst+i*4+4, _mm_movehl_ps(b, a));
+    }
+  return i;
+}
+
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2Interleave4CF32toCF32(const void * const *srcBuffs, void *dstBuff, const size_t numElems, const float scale)
+{
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      const __m128 c0 = _mm_mul_ps(_mm_loadu_ps(((const float*)srcBuffs[0])+i*2), scaleVec);
+      const __m128 c1 = _mm_mul_ps(_mm_loadu_ps(((const float*)srcBuffs[1])+i*2), scaleVec);
+      const __m128 c2 = _mm_mul_ps(_mm_loadu_ps(((const float*)srcBuffs[2])+i*2), scaleVec);
+      const __m128 c3 = _mm_mul_ps(_mm_loadu_ps(((const float*)srcBuffs[3])+i*2), scaleVec);
+      _mm_storeu_ps(dst+i*8+0, _mm_movelh_ps(c0, c1));
+      _mm_storeu_ps(dst+i*8+4, _mm_movelh_ps(c2, c3));
+      _mm_storeu_ps(dst+i*8+8, _mm_movehl_ps(c1, c0));
+      _mm_storeu_ps(dst+i*8+12, _mm_movehl_ps(c3, c2));
+    }
+  return i;
+}
+
+// ********************************
+// AVX2 kernels
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m256i avx2F32toS32(const __m256 in, const __m256 scale)
+{
+  const __m256 lo = _mm256_set1_ps(-32768.0f);
+  const __m256 hi = _mm256_set1_ps(32767.0f);
+  const __m256 v = _mm256_mul_ps(in, scale);
+  return _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_and_ps(v, _mm256_cmp_ps(v, v, _CMP_ORD_Q)), lo), hi));
+}
+
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2Deinterleave2CS16toCF32(const void *srcBuff, void * const *dstBuffs, const size_t numElems, const float scale)
+{
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m256i order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  auto *src = (const int16_t*)srcBuff;
+  auto *dst0 = (float*)dstBuffs[0];
+  auto *dst1 = (float*)dstBuffs[1];
+  size_t i = 0;
+  for (; i+4 <= numElems; i += 4)
+    {
+      //complex elements are 32 bits: ch0 to the low lane, ch1 to the high lane
+      const __m256i in = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(src+i*4)), order);
+      const __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(in));
+      const __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(in, 1));
+      _mm256_storeu_ps(dst0+i*2, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scaleVec));
+      _mm256_storeu_ps(dst1+i*2, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scaleVec));
+    }
+  return i;
+}
+
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2Deinterleave4CS16toCF32(const void *srcBuff, void * const *dstBuffs, const size_t numElems, const float scale)
+{
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  auto *src = (const int16_t*)srcBuff;
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      //transpose 2x4 complex elements into ch0|ch1|ch2|ch3 in 64-bit groups
+      const __m256i in = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(src+i*8)), order);
+      const __m256 ch01 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(in))), scaleVec);
+      const __m256 ch23 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(in, 1))), scaleVec);
+      _mm_storeu_ps(((float*)dstBuffs[0])+i*2, _mm256_castps256_ps128(ch01));
+      _mm_storeu_ps(((float*)dstBuffs[1])+i*2, _mm256_extractf128_ps(ch01, 1));
+      _mm_storeu_ps(((float*)dstBuffs[2])+i*2, _mm256_castps256_ps128(ch23));
+      _mm_storeu_ps(((float*)dstBuffs[3])+i*2, _mm256_extractf128_ps(ch23, 1));
+    }
+  return i;
+}
+
+//! Load 16 bytes as signed 8-bit samples with the 16-bit complex elements gathered in the given order
+template <typename Op>
+SOAPY_SDR_TARGET("avx2")
+static inline __m128i avx2GatherS8(const void *src, const __m128i order)
+{
+  const __m128i in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)src), order);
+  return std::is_unsigned<typename Op::SrcType>::value?_mm_xor_si128(in, _mm_set1_epi8(char(0x80))):in;
+}
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m256 avx2S8toF32(const __m128i in, const __m256 scale)
+{
+  return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(in)), scale);
+}
+
+template <typename Op>
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2Deinterleave2C8toCF32(const void *srcBuff, void * const *dstBuffs, const size_t numElems, const float scale)
+{
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m128i order = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+  auto *src = (const uint8_t*)srcBuff;
+  auto *dst0 = (float*)dstBuffs[0];
+  auto *dst1 = (float*)dstBuffs[1];
+  size_t i = 0;
+  for (; i+4 <= numElems; i += 4)
+    {
+      //ch0 to the low 8 bytes, ch1 to the high 8 bytes
+      const __m128i in = avx2GatherS8<Op>(src+i*4, order);
+      _mm256_storeu_ps(dst0+i*2, avx2S8toF32(in, scaleVec));
+      _mm256_storeu_ps(dst1+i*2, avx2S8toF32(_mm_unpackhi_epi64(in, in), scaleVec));
+    }
+  return i;
+}
+
+template <typename Op>
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2Deinterleave4C8toCF32(const void *srcBuff, void * const *dstBuffs, const size_t numElems, const float scale)
+{
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m128i order = _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+  auto *src = (const uint8_t*)srcBuff;
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      //transpose 2x4 complex elements into ch0|ch1|ch2|ch3 in 32-bit groups
+      const __m128i in = avx2GatherS8<Op>(src+i*8, order);
+      const __m256 ch01 = avx2S8toF32(in, scaleVec);
+      const __m256 ch23 = avx2S8toF32(_mm_unpackhi_epi64(in, in), scaleVec);
+      _mm_storeu_ps(((float*)dstBuffs[0])+i*2, _mm256_castps256_ps128(ch01));
+      _mm_storeu_ps(((float*)dstBuffs[1])+i*2, _mm256_extractf128_ps(ch01, 1));
+      _mm_storeu_ps(((float*)dstBuffs[2])+i*2, _mm256_castps256_ps128(ch23));
+      _mm_storeu_ps(((float*)dstBuffs[3])+i*2, _mm256_extractf128_ps(ch23, 1));
+    }
+  return i;
+}
+
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2Interleave2CF32toCS16(const void * const *srcBuffs, void *dstBuff, const size_t numElems, const float scale)
+{
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  auto *src0 = (const float*)srcBuffs[0];
+  auto *src1 = (const float*)srcBuffs[1];
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  for (; i+4 <= numElems; i += 4)
+    {
+      const __m256i a = avx2F32toS32(_mm256_loadu_ps(src0+i*2), scaleVec);
+      const __m256i b = avx2F32toS32(_mm256_loadu_ps(src1+i*2), scaleVec);
+      //packs operates per 128-bit lane, alternate ch0 and ch1 within each lane
+      const __m256i out = _mm256_shuffle_epi32(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+      _mm256_storeu_si256((__m256i*)(dst+i*4), out);
+    }
+  return i;
+}
+
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2Interleave4CF32toCS16(const void * const *srcBuffs, void *dstBuff, const size_t numElems, const float scale)
+{
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m256i order = _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7);
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  for (; i+2 <= numElems; i += 2)
+    {
+      const __m256 ch01 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(((const float*)srcBuffs[0])+i*2)), _mm_loadu_ps(((const float*)srcBuffs[1])+i*2), 1);
+      const __m256 ch23 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(((const float*)srcBuffs[2])+i*2)), _mm_loadu_ps(((const float*)srcBuffs[3])+i*2), 1);
+      const __m256i packed = _mm256_packs_epi32(avx2F32toS32(ch01, scaleVec), avx2F32toS32(ch23, scaleVec));
+      _mm256_storeu_si256((__m256i*)(dst+i*8), _mm256_permutevar8x32_epi32(packed, order));
+    }
+  return i;
+}
+
+#endif //SOAPY_SDR_X86
+
+/***********************************************************************
+ * Kernel tables for each layout in order of preference for each source/target.
+ * Registered by registerKernelTable() with VECTORIZED priority.
+ **********************************************************************/
+struct ChannelKernel
+{
+  const char *sourceFormat;
+  const char *targetFormat;
+  bool CPUFeatures::*isa;
+  BatchConverterFunction function;
+};
+
+static const SoapySDR::ConverterRegistry::ChannelLayout DEINTERLEAVE = SoapySDR::ConverterRegistry::DEINTERLEAVE;
+static const SoapySDR::ConverterRegistry::ChannelLayout INTERLEAVE = SoapySDR::ConverterRegistry::INTERLEAVE;
+
+static const ChannelKernel deinterleaveKernels[] = {
+#ifdef SOAPY_SDR_X86
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF32, &CPUFeatures::avx2, &vectorDeinterleave<CS16toCF32, &avx2Deinterleave2CS16toCF32, &avx2Deinterleave4CS16toCF32>},
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF32, &CPUFeatures::sse2, &vectorDeinterleave<CS16toCF32, &sse2Deinterleave2CS16toCF32, &sse2Deinterleave4CS16toCF32>},
+  {SOAPY_SDR_CS8, SOAPY_SDR_CF32, &CPUFeatures::avx2, &vectorDeinterleave<CS8toCF32, &avx2Deinterleave2C8toCF32<CS8toCF32>, &avx2Deinterleave4C8toCF32<CS8toCF32>>},
+  {SOAPY_SDR_CS8, SOAPY_SDR_CF32, &CPUFeatures::sse2, &vectorDeinterleave<CS8toCF32, &sse2Deinterleave2C8toCF32<CS8toCF32>, &sse2Deinterleave4C8toCF32<CS8toCF32>>},
+  {SOAPY_SDR_CU8, SOAPY_SDR_CF32, &CPUFeatures::avx2, &vectorDeinterleave<CU8toCF32, &avx2Deinterleave2C8toCF32<CU8toCF32>, &avx2Deinterleave4C8toCF32<CU8toCF32>>},
+  {SOAPY_SDR_CU8, SOAPY_SDR_CF32, &CPUFeatures::sse2, &vectorDeinterleave<CU8toCF32, &sse2Deinterleave2C8toCF32<CU8toCF32>, &sse2Deinterleave4C8toCF32<CU8toCF32>>},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CF32, &CPUFeatures::sse2, &vectorDeinterleave<CF32toCF32, &sse2Deinterleave2CF32toCF32, &sse2Deinterleave4CF32toCF32>},
+#endif //SOAPY_SDR_X86
+  {nullptr, nullptr, nullptr, nullptr}
+};
+
+static const ChannelKernel interleaveKernels[] = {
+#ifdef SOAPY_SDR_X86
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS16, &CPUFeatures::avx2, &vectorInterleave<CF32toCS16, &avx2Interleave2CF32toCS16, &avx2Interleave4CF32toCS16>},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS16, &CPUFeatures::sse2, &vectorInterleave<CF32toCS16, &sse2Interleave2CF32toCS16, &sse2Interleave4CF32toCS16>},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CF32, &CPUFeatures::sse2, &vectorInterleave<CF32toCF32, &sse2Interleave2CF32toCF32, &sse2Interleave4CF32toCF32>},
+#endif //SOAPY_SDR_X86
+  {nullptr, nullptr, nullptr, nullptr}
+};
+
+static bool registerChannelConverters(void)
+{
+  typedef SoapySDR::ConverterRegistry Registry;
+
+  //generic deinterleavers for RX
+  Registry(SOAPY_SDR_CS16, SOAPY_SDR_CF32, DEINTERLEAVE, Registry::GENERIC, &genericDeinterleave<CS16toCF32>);
+  Registry(SOAPY_SDR_CS8, SOAPY_SDR_CF32, DEINTERLEAVE, Registry::GENERIC, &genericDeinterleave<CS8toCF32>);
+  Registry(SOAPY_SDR_CU8, SOAPY_SDR_CF32, DEINTERLEAVE, Registry::GENERIC, &genericDeinterleave<CU8toCF32>);
+  Registry(SOAPY_SDR_CF32, SOAPY_SDR_CF32, DEINTERLEAVE, Registry::GENERIC, &genericDeinterleave<CF32toCF32>);
+  Registry(SOAPY_SDR_CS16, SOAPY_SDR_CS16, DEINTERLEAVE, Registry::GENERIC, &copyDeinterleave<int16_t>);
+  Registry(SOAPY_SDR_CS8, SOAPY_SDR_CS8, DEINTERLEAVE, Registry::GENERIC, &copyDeinterleave<int8_t>);
+
+  //generic interleavers for TX
+  Registry(SOAPY_SDR_CF32, SOAPY_SDR_CS16, INTERLEAVE, Registry::GENERIC, &genericInterleave<CF32toCS16>);
+  Registry(SOAPY_SDR_CF32, SOAPY_SDR_CS8, INTERLEAVE, Registry::GENERIC, &genericInterleave<CF32toCS8>);
+  Registry(SOAPY_SDR_CF32, SOAPY_SDR_CU8, INTERLEAVE, Registry::GENERIC, &genericInterleave<CF32toCU8>);
+  Registry(SOAPY_SDR_CF32, SOAPY_SDR_CF32, INTERLEAVE, Registry::GENERIC, &genericInterleave<CF32toCF32>);
+  Registry(SOAPY_SDR_CS16, SOAPY_SDR_CS16, INTERLEAVE, Registry::GENERIC, &copyInterleave<int16_t>);
+  Registry(SOAPY_SDR_CS8, SOAPY_SDR_CS8, INTERLEAVE, Registry::GENERIC, &copyInterleave<int8_t>);
+
+  registerKernelTable(deinterleaveKernels, [](const ChannelKernel &k)
+    {
+      Registry(k.sourceFormat, k.targetFormat, DEINTERLEAVE, Registry::VECTORIZED, k.function);
+    });
+  registerKernelTable(interleaveKernels, [](const ChannelKernel &k)
+    {
+      Registry(k.sourceFormat, k.targetFormat, INTERLEAVE, Registry::VECTORIZED, k.function);
+    });
+  return true;
+}
+
+/*!
+ * lateLoadInterleaveConverters() is called by lateLoadDefaultConverters()
+ * so the channel converters load with the rest of the default set.
+ */
+void lateLoadInterleaveConverters(void)
+{
+  static const bool registered = registerChannelConverters();
+  (void)registered;
+}
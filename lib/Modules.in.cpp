@@ -231,6 +231,9 @@ static std::string GetLastErrorMessage(void)
 
 static bool enableAutomaticLoadModules(true);
 
+void beginConverterBatch(void);
+void endConverterBatch(void);
+
 std::string SoapySDR::loadModule(const std::string &path)
 {
     std::lock_guard<std::recursive_mutex> lock(getModuleMutex());
@@ -244,7 +247,8 @@ std::string SoapySDR::loadModule(const std::string &path)
     //stash the path for registry access
     getModuleLoading().assign(path);
 
-    //load the module
+    //load the module, its converters publish as one registry snapshot
+    beginConverterBatch();
 #ifdef _WIN32
 
     //SetThreadErrorMode() - disable error pop-ups when DLLs are not found
@@ -253,10 +257,12 @@ std::string SoapySDR::loadModule(const std::string &path)
     HMODULE handle = LoadLibrary(path.c_str());
     SetThreadErrorMode(oldMode, nullptr);
 
+    endConverterBatch();
     getModuleLoading().clear();
     if (handle == NULL) return "LoadLibrary() failed: " + GetLastErrorMessage();
 #else
     void *handle = dlopen(path.c_str(), RTLD_LAZY);
+    endConverterBatch();
     getModuleLoading().clear();
     if (handle == NULL) return "dlopen() failed: " + std::string(dlerror());
 #endif
@@ -340,6 +346,8 @@ void SoapySDR::loadModules(void)
     //rather than rely on static initialization
     lateLoadNullDevice();
 
+    //the converters of every module publish as one registry snapshot
+    beginConverterBatch();
     const auto paths = listModules();
     for (size_t i = 0; i < paths.size(); i++)
     {
@@ -352,6 +360,7 @@ void SoapySDR::loadModules(void)
             SoapySDR::logf(SOAPY_SDR_ERROR, "SoapySDR::loadModule(%s)\n  %s", paths[i].c_str(), it.second.c_str());
         }
     }
+    endConverterBatch();
 }
 
 void SoapySDR::unloadModules(void)
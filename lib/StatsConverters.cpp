@@ -0,0 +1,290 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "CPUFeatures.hpp"
+#include "ConverterKernels.hpp"
+#include <SoapySDR/ConverterPrimitives.hpp>
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <SoapySDR/Formats.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#ifdef SOAPY_SDR_X86
+#include <immintrin.h>
+#endif
+
+/***********************************************************************
+ * Stats converters for level metering.
+ *
+ * The conversion is fused with the sum of squared magnitudes, the peak
+ * magnitude, and the saturation count, so metering does not take
+ * another pass over the buffer. The kernels measure the converted
+ * value v = in*scale: the normalized output for integer to float, and
+ * the value in integer units for float to integer, which the driver
+ * normalizes once per call.
+ *
+ * The SIMD kernels accumulate in single precision for at most
+ * STATS_BLOCK_ELEMS elements before flushing to double precision,
+ * so the sums keep their precision over large buffers.
+ **********************************************************************/
+
+typedef SoapySDR::ConverterRegistry::ConverterStats ConverterStats;
+typedef SoapySDR::ConverterRegistry::StatsConverterFunction StatsConverterFunction;
+
+static const size_t STATS_BLOCK_ELEMS = 2048;
+
+//! Statistics of one call in the units of the converted value
+struct StatsAccumulator
+{
+  double sumSquares;
+  float peakSquared;
+  size_t numClipped;
+};
+
+// ********************************
+// Metering ops on the shared sample conversions
+
+struct StatsCS16toCF32 : CS16toCF32
+{
+  static double norm(void) { return 1.0; }
+  static float value(const int16_t in, const float scale) { return convert(in, scale); }
+  static float output(const float v) { return v; }
+  static bool clipped(const int16_t in, const float) { return in == INT16_MAX or in == INT16_MIN; }
+};
+
+struct StatsCS8toCF32 : CS8toCF32
+{
+  static double norm(void) { return 1.0; }
+  static float value(const int8_t in, const float scale) { return convert(in, scale); }
+  static float output(const float v) { return v; }
+  static bool clipped(const int8_t in, const float) { return in == INT8_MAX or in == INT8_MIN; }
+};
+
+struct StatsCU8toCF32 : CU8toCF32
+{
+  static double norm(void) { return 1.0; }
+  static float value(const uint8_t in, const float scale) { return convert(in, scale); }
+  static float output(const float v) { return v; }
+  static bool clipped(const uint8_t in, const float) { return in == UINT8_MAX or in == 0; }
+};
+
+struct StatsCF32toCS16 : CF32toCS16
+{
+  static double norm(void) { return 1.0/SoapySDR::S16_FULL_SCALE; }
+  static float value(const float in, const float scale) { return in*scale; }
+  static int16_t output(const float v) { return SoapySDR::SaturateS16(v); }
+  static bool clipped(const float, const float v) { return v < float(INT16_MIN) or v > float(INT16_MAX); }
+};
+
+struct StatsCF32toCS8 : CF32toCS8
+{
+  static double norm(void) { return 1.0/SoapySDR::S8_FULL_SCALE; }
+  static float value(const float in, const float scale) { return in*scale; }
+  static int8_t output(const float v) { return SoapySDR::SaturateS8(v); }
+  static bool clipped(const float, const float v) { return v < float(INT8_MIN) or v > float(INT8_MAX); }
+};
+
+// ********************************
+// Generic loop and driver
+
+//! A SIMD kernel for the start of the buffer, returns the number of elements processed
+typedef size_t (*StatsKernel)(const void *, void *, const size_t, const float, StatsAccumulator &);
+
+static size_t noKernel(const void *, void *, const size_t, const float, StatsAccumulator &)
+{
+  return 0;
+}
+
+template <typename Op>
+static void statsRange(const void *srcBuff, void *dstBuff, const size_t first, const size_t last, const float scale, StatsAccumulator &acc)
+{
+  auto *src = (const typename Op::SrcType*)srcBuff;
+  auto *dst = (typename Op::DstType*)dstBuff;
+  for (size_t i = first; i < last; i++)
+    {
+      const auto inI = src[i*2+0];
+      const auto inQ = src[i*2+1];
+      const float vi = Op::value(inI, scale);
+      const float vq = Op::value(inQ, scale);
+      dst[i*2+0] = Op::output(vi);
+      dst[i*2+1] = Op::output(vq);
+      acc.numClipped += size_t(Op::clipped(inI, vi)) + size_t(Op::clipped(inQ, vq));
+      const float mag = vi*vi + vq*vq;
+      acc.sumSquares += mag;
+      acc.peakSquared = std::max(acc.peakSquared, mag);
+    }
+}
+
+template <typename Op, StatsKernel kernel>
+static void statsConvert(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler, ConverterStats *stats)
+{
+  const float scale = Op::scale(scaler);
+  StatsAccumulator acc = {0.0, 0.0f, 0};
+  const size_t i = kernel(srcBuff, dstBuff, numElems, scale, acc);
+  statsRange<Op>(srcBuff, dstBuff, i, numElems, scale, acc);
+
+  const double norm = Op::norm();
+  stats->numElems += numElems;
+  stats->sumSquares += acc.sumSquares*norm*norm;
+  stats->peakMagnitude = std::max(stats->peakMagnitude, std::sqrt(double(acc.peakSquared))*norm);
+  stats->numClipped += acc.numClipped;
+}
+
+#ifdef SOAPY_SDR_X86
+
+// ********************************
+// AVX2 kernels
+
+SOAPY_SDR_TARGET("avx2")
+static inline void avx2FlushStats(const __m256 sumSquares, const __m256 peakSquared, const __m256i numClipped, StatsAccumulator &acc)
+{
+  float sums[8], peaks[8];
+  int32_t clips[8];
+  _mm256_storeu_ps(sums, sumSquares);
+  _mm256_storeu_ps(peaks, peakSquared);
+  _mm256_storeu_si256((__m256i *)clips, numClipped);
+  for (size_t j = 0; j < 8; j++)
+    {
+      acc.sumSquares += sums[j];
+      acc.peakSquared = std::max(acc.peakSquared, peaks[j]);
+      acc.numClipped += size_t(clips[j]);
+    }
+}
+
+//! Accumulate the squares and magnitudes of 4 complex values
+SOAPY_SDR_TARGET("avx2")
+static inline void avx2Accumulate(const __m256 v, __m256 &sumSquares, __m256 &peakSquared)
+{
+  const __m256 sq = _mm256_mul_ps(v, v);
+  sumSquares = _mm256_add_ps(sumSquares, sq);
+  peakSquared = _mm256_max_ps(peakSquared, _mm256_add_ps(sq, _mm256_permute_ps(sq, _MM_SHUFFLE(2, 3, 0, 1))));
+}
+
+//! CS16 to CF32, 8 complex elements per iteration
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2StatsCS16toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const float scale, StatsAccumulator &acc)
+{
+  auto *src = (const int16_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m256i hi = _mm256_set1_epi32(INT16_MAX);
+  const __m256i lo = _mm256_set1_epi32(INT16_MIN);
+
+  size_t i = 0;
+  while (i+8 <= numElems)
+    {
+      __m256 sumSquares = _mm256_setzero_ps();
+      __m256 peakSquared = _mm256_setzero_ps();
+      __m256i numClipped = _mm256_setzero_si256();
+      const size_t blockEnd = std::min(numElems, i+STATS_BLOCK_ELEMS);
+      for (; i+8 <= blockEnd; i += 8)
+        {
+          const __m256i in = _mm256_loadu_si256((const __m256i*)(src+i*2));
+          const __m256i in0 = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(in));
+          const __m256i in1 = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(in, 1));
+          numClipped = _mm256_sub_epi32(numClipped, _mm256_or_si256(_mm256_cmpeq_epi32(in0, hi), _mm256_cmpeq_epi32(in0, lo)));
+          numClipped = _mm256_sub_epi32(numClipped, _mm256_or_si256(_mm256_cmpeq_epi32(in1, hi), _mm256_cmpeq_epi32(in1, lo)));
+          const __m256 v0 = _mm256_mul_ps(_mm256_cvtepi32_ps(in0), scaleVec);
+          const __m256 v1 = _mm256_mul_ps(_mm256_cvtepi32_ps(in1), scaleVec);
+          _mm256_storeu_ps(dst+i*2+0, v0);
+          _mm256_storeu_ps(dst+i*2+8, v1);
+          avx2Accumulate(v0, sumSquares, peakSquared);
+          avx2Accumulate(v1, sumSquares, peakSquared);
+        }
+      avx2FlushStats(sumSquares, peakSquared, numClipped, acc);
+    }
+  return i;
+}
+
+//! CF32 to CS16, 8 complex elements per iteration
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2StatsCF32toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const float scale, StatsAccumulator &acc)
+{
+  auto *src = (const float*)srcBuff;
+  auto *dst = (int16_t*)dstBuff;
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m256 hi = _mm256_set1_ps(float(INT16_MAX));
+  const __m256 lo = _mm256_set1_ps(float(INT16_MIN));
+
+  size_t i = 0;
+  while (i+8 <= numElems)
+    {
+      __m256 sumSquares = _mm256_setzero_ps();
+      __m256 peakSquared = _mm256_setzero_ps();
+      __m256i numClipped = _mm256_setzero_si256();
+      const size_t blockEnd = std::min(numElems, i+STATS_BLOCK_ELEMS);
+      for (; i+8 <= blockEnd; i += 8)
+        {
+          const __m256 v0 = _mm256_mul_ps(_mm256_loadu_ps(src+i*2+0), scaleVec);
+          const __m256 v1 = _mm256_mul_ps(_mm256_loadu_ps(src+i*2+8), scaleVec);
+          const __m256 clip0 = _mm256_or_ps(_mm256_cmp_ps(v0, hi, _CMP_GT_OQ), _mm256_cmp_ps(v0, lo, _CMP_LT_OQ));
+          const __m256 clip1 = _mm256_or_ps(_mm256_cmp_ps(v1, hi, _CMP_GT_OQ), _mm256_cmp_ps(v1, lo, _CMP_LT_OQ));
+          numClipped = _mm256_sub_epi32(numClipped, _mm256_castps_si256(clip0));
+          numClipped = _mm256_sub_epi32(numClipped, _mm256_castps_si256(clip1));
+          //not-a-number lanes are zeroed like SoapySDR::SaturateInt()
+          const __m256 z0 = _mm256_and_ps(v0, _mm256_cmp_ps(v0, v0, _CMP_ORD_Q));
+          const __m256 z1 = _mm256_and_ps(v1, _mm256_cmp_ps(v1, v1, _CMP_ORD_Q));
+          const __m256i s0 = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(z0, lo), hi));
+          const __m256i s1 = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(z1, lo), hi));
+          _mm256_storeu_si256((__m256i*)(dst+i*2), _mm256_permute4x64_epi64(_mm256_packs_epi32(s0, s1), _MM_SHUFFLE(3, 1, 2, 0)));
+          avx2Accumulate(v0, sumSquares, peakSquared);
+          avx2Accumulate(v1, sumSquares, peakSquared);
+        }
+      avx2FlushStats(sumSquares, peakSquared, numClipped, acc);
+    }
+  return i;
+}
+
+#endif //SOAPY_SDR_X86
+
+/***********************************************************************
+ * Kernel table in order of preference for each source/target.
+ * Registered by registerKernelTable() with VECTORIZED priority.
+ **********************************************************************/
+struct StatsKernelEntry
+{
+  const char *sourceFormat;
+  const char *targetFormat;
+  bool CPUFeatures::*isa;
+  StatsConverterFunction function;
+};
+
+static const StatsKernelEntry statsKernels[] = {
+#ifdef SOAPY_SDR_X86
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF32, &CPUFeatures::avx2, &statsConvert<StatsCS16toCF32, &avx2StatsCS16toCF32>},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS16, &CPUFeatures::avx2, &statsConvert<StatsCF32toCS16, &avx2StatsCF32toCS16>},
+#endif //SOAPY_SDR_X86
+  {nullptr, nullptr, nullptr, nullptr}
+};
+
+static bool registerStatsConverters(void)
+{
+  typedef SoapySDR::ConverterRegistry Registry;
+
+  //generic converters for RX metering
+  Registry(SOAPY_SDR_CS16, SOAPY_SDR_CF32, Registry::GENERIC, &statsConvert<StatsCS16toCF32, &noKernel>);
+  Registry(SOAPY_SDR_CS8, SOAPY_SDR_CF32, Registry::GENERIC, &statsConvert<StatsCS8toCF32, &noKernel>);
+  Registry(SOAPY_SDR_CU8, SOAPY_SDR_CF32, Registry::GENERIC, &statsConvert<StatsCU8toCF32, &noKernel>);
+
+  //generic converters for TX metering
+  Registry(SOAPY_SDR_CF32, SOAPY_SDR_CS16, Registry::GENERIC, &statsConvert<StatsCF32toCS16, &noKernel>);
+  Registry(SOAPY_SDR_CF32, SOAPY_SDR_CS8, Registry::GENERIC, &statsConvert<StatsCF32toCS8, &noKernel>);
+
+  registerKernelTable(statsKernels, [](const StatsKernelEntry &k)
+    {
+      Registry(k.sourceFormat, k.targetFormat, Registry::VECTORIZED, k.function);
+    });
+  return true;
+}
+
+/*!
+ * lateLoadStatsConverters() is called by lateLoadDefaultConverters()
+ * so the stats converters load with the rest of the default set.
+ */
+void lateLoadStatsConverters(void)
+{
+  static const bool registered = registerStatsConverters();
+  (void)registered;
+}
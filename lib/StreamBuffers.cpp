@@ -0,0 +1,183 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/StreamBuffers.hpp>
+#include <SoapySDR/Formats.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+//! Buffers start on at least a cache line for SIMD loads and stores
+static const size_t MIN_ALIGNMENT = 64;
+
+//! The common huge page size, explicit huge page mappings are rounded up to it
+static const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+/***********************************************************************
+ * The allocation record is stored before the returned pointer array
+ **********************************************************************/
+struct StreamBuffersRecord
+{
+    void *base;
+    size_t length;
+    bool mapped;
+    bool locked;
+};
+
+static StreamBuffersRecord *getRecord(void **buffs)
+{
+    return reinterpret_cast<StreamBuffersRecord *>(buffs) - 1;
+}
+
+/***********************************************************************
+ * Page mappings for huge pages and locked memory
+ **********************************************************************/
+static void *mapPages(size_t &length, const bool hugePages)
+{
+#ifdef _WIN32
+    //large pages on windows require a privilege that applications rarely hold
+    if (hugePages) SoapySDR::log(SOAPY_SDR_DEBUG, "allocStreamBuffers() huge pages not supported");
+    return VirtualAlloc(nullptr, length, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+    void *mem = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    //explicit huge pages are only available when reserved by the administrator
+    if (hugePages)
+    {
+        const size_t hugeLength = (length + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        mem = mmap(nullptr, hugeLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mem != MAP_FAILED)
+        {
+            length = hugeLength;
+            return mem;
+        }
+    }
+#endif
+    mem = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) return nullptr;
+#ifdef MADV_HUGEPAGE
+    //otherwise ask for transparent huge pages, the kernel may decline
+    if (hugePages) madvise(mem, length, MADV_HUGEPAGE);
+#endif
+    return mem;
+#endif
+}
+
+static void unmapPages(void *mem, const size_t length)
+{
+#ifdef _WIN32
+    (void)length;
+    VirtualFree(mem, 0, MEM_RELEASE);
+#else
+    munmap(mem, length);
+#endif
+}
+
+static bool lockPages(void *mem, const size_t length)
+{
+#ifdef _WIN32
+    return VirtualLock(mem, length) != 0;
+#else
+    return mlock(mem, length) == 0;
+#endif
+}
+
+static void unlockPages(void *mem, const size_t length)
+{
+#ifdef _WIN32
+    VirtualUnlock(mem, length);
+#else
+    munlock(mem, length);
+#endif
+}
+
+/***********************************************************************
+ * Allocation API
+ **********************************************************************/
+static size_t getAlignment(SoapySDR::Device *device, const int direction, const SoapySDR::Kwargs &args)
+{
+    //the driver hints its DMA alignment with the default of the alignment stream arg
+    std::string alignmentStr;
+    const auto it = args.find("alignment");
+    if (it != args.end()) alignmentStr = it->second;
+    else for (const auto &info : device->getStreamArgsInfo(direction, 0))
+    {
+        if (info.key == "alignment") alignmentStr = info.value;
+    }
+    if (alignmentStr.empty()) return MIN_ALIGNMENT;
+
+    const size_t alignment = std::max<size_t>(std::stoul(alignmentStr), MIN_ALIGNMENT);
+    if ((alignment & (alignment - 1)) != 0)
+    {
+        throw std::invalid_argument("allocStreamBuffers() alignment must be a power of two: " + alignmentStr);
+    }
+    return alignment;
+}
+
+static bool getFlag(const SoapySDR::Kwargs &args, const std::string &key)
+{
+    const auto it = args.find(key);
+    return it != args.end() and SoapySDR::StringToSetting<bool>(it->second);
+}
+
+void **SoapySDR::allocStreamBuffers(Device *device, Stream *stream, const int direction, const std::string &format, const size_t numBuffs, const Kwargs &args)
+{
+    if (numBuffs == 0) throw std::invalid_argument("allocStreamBuffers() requires non-zero numBuffs");
+    const size_t elemSize = SoapySDR::formatToSize(format);
+    if (elemSize == 0) throw std::invalid_argument("allocStreamBuffers() unknown format: " + format);
+
+    const size_t alignment = getAlignment(device, direction, args);
+    const bool hugePages = getFlag(args, "hugePages");
+    const bool lock = getFlag(args, "lock");
+
+    //each buffer starts on the alignment, the extra alignment aligns the first one
+    const size_t buffSize = std::max<size_t>(device->getStreamMTU(stream), 1)*elemSize;
+    const size_t stride = (buffSize + alignment - 1) & ~(alignment - 1);
+    size_t length = stride*numBuffs + alignment;
+
+    void *recordMem = std::malloc(sizeof(StreamBuffersRecord) + numBuffs*sizeof(void *));
+    if (recordMem == nullptr) throw std::bad_alloc();
+    auto record = static_cast<StreamBuffersRecord *>(recordMem);
+
+    //locked memory is mapped separately so that unlocking does not affect the heap
+    record->mapped = hugePages or lock;
+    record->base = record->mapped?mapPages(length, hugePages):std::malloc(length);
+    record->length = length;
+    record->locked = false;
+    if (record->base == nullptr)
+    {
+        std::free(recordMem);
+        throw std::bad_alloc();
+    }
+
+    if (lock)
+    {
+        record->locked = lockPages(record->base, length);
+        if (not record->locked) SoapySDR::logf(SOAPY_SDR_WARNING, "allocStreamBuffers() failed to lock %d bytes", int(length));
+    }
+
+    const auto addr = reinterpret_cast<uintptr_t>(record->base);
+    char *first = static_cast<char *>(record->base) + ((alignment - (addr & (alignment - 1))) & (alignment - 1));
+    void **buffs = reinterpret_cast<void **>(record + 1);
+    for (size_t i = 0; i < numBuffs; i++) buffs[i] = first + i*stride;
+    return buffs;
+}
+
+void SoapySDR::freeStreamBuffers(void **buffs)
+{
+    if (buffs == nullptr) return;
+    auto record = getRecord(buffs);
+    if (record->locked) unlockPages(record->base, record->length);
+    if (record->mapped) unmapPages(record->base, record->length);
+    else std::free(record->base);
+    std::free(record);
+}
@@ -0,0 +1,1387 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include "CPUFeatures.hpp"
+#include "ConverterKernels.hpp"
+#include <SoapySDR/ConverterPrimitives.hpp>
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <SoapySDR/Formats.hpp>
+#include <limits>
+#include <string>
+
+#ifdef SOAPY_SDR_X86
+#include <immintrin.h>
+#endif
+
+#ifdef SOAPY_SDR_NEON
+#include <arm_neon.h>
+#endif
+
+/***********************************************************************
+ * Vectorized converters for the complex 8/16-bit <> CF32 hot paths
+ * for unpacking/packing the CS12 and CS4 wire formats, and for
+ * widening/narrowing between double and single precision or integers.
+ *
+ * Each kernel processes the bulk of the buffer with SIMD and finishes
+ * the remainder with a scalar loop that has identical semantics.
+ * Float to integer conversions truncate and saturate to the integer
+ * range like the generic converters. The CF32 to CS16/CS8/CU8 kernels
+ * are templated on countClips: clip counting instances keep one counter
+ * per vector lane, and the counting compiles away in the plain instances.
+ * The CS16/CS8/CU8 to CF32 kernels are templated on streaming: those
+ * instances write the aligned bulk with non-temporal stores.
+ **********************************************************************/
+
+typedef SoapySDR::ConverterRegistry::ConverterFunction ConverterFunction;
+
+//! Saturate like SaturateInt() and count the sample when it is out of range
+template <typename T>
+static inline T clipF32toInt(const float from, size_t *clips)
+{
+  const float lo = float(std::numeric_limits<T>::min());
+  const float hi = float(std::numeric_limits<T>::max());
+  if (clips != nullptr and (from < lo or from > hi)) (*clips)++;
+  return SoapySDR::SaturateInt<T>(from);
+}
+
+//! Adapt a clip counting kernel to the ConverterFunction signature
+template <SoapySDR::ConverterRegistry::ClipConverterFunction kernel>
+static void discardClips(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  kernel(srcBuff, dstBuff, numElems, scaler);
+}
+
+
+// The double precision kernels are templated on the element depth
+// so the same kernel serves the real and the complex formats.
+
+// ********************************
+// SSE2 kernels
+
+#ifdef SOAPY_SDR_X86
+
+SOAPY_SDR_TARGET("sse2")
+static inline __m128i sse2F32toS32(const float *src, const __m128 scale, const __m128 lo, const __m128 hi, __m128i *clips = nullptr)
+{
+  const __m128 in = _mm_mul_ps(_mm_loadu_ps(src), scale);
+  //out of range lanes compare as all ones (-1), subtracting counts them
+  if (clips != nullptr) *clips = _mm_sub_epi32(*clips, _mm_castps_si128(_mm_or_ps(_mm_cmplt_ps(in, lo), _mm_cmpgt_ps(in, hi))));
+  //not-a-number lanes are zeroed like SoapySDR::SaturateInt()
+  return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_and_ps(in, _mm_cmpord_ps(in, in)), lo), hi));
+}
+
+SOAPY_SDR_TARGET("sse2")
+static inline size_t sse2SumClips(const __m128i clips)
+{
+  uint32_t lanes[4];
+  _mm_storeu_si128((__m128i*)lanes, clips);
+  return size_t(lanes[0])+lanes[1]+lanes[2]+lanes[3];
+}
+
+template <bool streaming = false>
+SOAPY_SDR_TARGET("sse2")
+static inline void sse2S32toF32(float *dst, const __m128i in, const __m128 scale)
+{
+  const __m128 out = _mm_mul_ps(_mm_cvtepi32_ps(in), scale);
+  if (streaming) _mm_stream_ps(dst, out);
+  else _mm_storeu_ps(dst, out);
+}
+
+template <bool streaming>
+SOAPY_SDR_TARGET("sse2")
+static void sse2CS16toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S16_FULL_SCALE);
+  const __m128 scaleVec = _mm_set1_ps(scale);
+
+  auto *src = (const int16_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      const __m128i in = _mm_loadu_si128((const __m128i*)(src+i));
+      sse2S32toF32<streaming>(dst+i+0, _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16), scaleVec);
+      sse2S32toF32<streaming>(dst+i+4, _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i])*scale;
+  if (streaming) _mm_sfence();
+}
+
+template <bool countClips>
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2CF32toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S16_FULL_SCALE);
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  const __m128 lo = _mm_set1_ps(-32768.0f);
+  const __m128 hi = _mm_set1_ps(32767.0f);
+  __m128i clipVec = _mm_setzero_si128();
+  __m128i *clipVecPtr = countClips?&clipVec:nullptr;
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      const __m128i a = sse2F32toS32(src+i+0, scaleVec, lo, hi, clipVecPtr);
+      const __m128i b = sse2F32toS32(src+i+4, scaleVec, lo, hi, clipVecPtr);
+      _mm_storeu_si128((__m128i*)(dst+i), _mm_packs_epi32(a, b));
+    }
+  size_t clips = countClips?sse2SumClips(clipVec):0;
+  for (; i < numSamps; i++) dst[i] = clipF32toInt<int16_t>(src[i]*scale, countClips?&clips:nullptr);
+  return clips;
+}
+
+template <bool streaming = false>
+SOAPY_SDR_TARGET("sse2")
+static inline void sse2S8toF32(float *dst, const __m128i in, const __m128 scale)
+{
+  const __m128i lo16 = _mm_srai_epi16(_mm_unpacklo_epi8(in, in), 8);
+  const __m128i hi16 = _mm_srai_epi16(_mm_unpackhi_epi8(in, in), 8);
+  sse2S32toF32<streaming>(dst+0, _mm_srai_epi32(_mm_unpacklo_epi16(lo16, lo16), 16), scale);
+  sse2S32toF32<streaming>(dst+4, _mm_srai_epi32(_mm_unpackhi_epi16(lo16, lo16), 16), scale);
+  sse2S32toF32<streaming>(dst+8, _mm_srai_epi32(_mm_unpacklo_epi16(hi16, hi16), 16), scale);
+  sse2S32toF32<streaming>(dst+12, _mm_srai_epi32(_mm_unpackhi_epi16(hi16, hi16), 16), scale);
+}
+
+SOAPY_SDR_TARGET("sse2")
+static inline __m128i sse2F32toS8(const float *src, const __m128 scale, __m128i *clips = nullptr)
+{
+  const __m128 lo = _mm_set1_ps(-128.0f);
+  const __m128 hi = _mm_set1_ps(127.0f);
+  const __m128i a = _mm_packs_epi32(sse2F32toS32(src+0, scale, lo, hi, clips), sse2F32toS32(src+4, scale, lo, hi, clips));
+  const __m128i b = _mm_packs_epi32(sse2F32toS32(src+8, scale, lo, hi, clips), sse2F32toS32(src+12, scale, lo, hi, clips));
+  return _mm_packs_epi16(a, b);
+}
+
+template <bool streaming>
+SOAPY_SDR_TARGET("sse2")
+static void sse2CS8toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S8_FULL_SCALE);
+  const __m128 scaleVec = _mm_set1_ps(scale);
+
+  auto *src = (const int8_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      sse2S8toF32<streaming>(dst+i, _mm_loadu_si128((const __m128i*)(src+i)), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i])*scale;
+  if (streaming) _mm_sfence();
+}
+
+template <bool countClips>
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2CF32toCS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S8_FULL_SCALE);
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  __m128i clipVec = _mm_setzero_si128();
+  __m128i *clipVecPtr = countClips?&clipVec:nullptr;
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (int8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      _mm_storeu_si128((__m128i*)(dst+i), sse2F32toS8(src+i, scaleVec, clipVecPtr));
+    }
+  size_t clips = countClips?sse2SumClips(clipVec):0;
+  for (; i < numSamps; i++) dst[i] = clipF32toInt<int8_t>(src[i]*scale, countClips?&clips:nullptr);
+  return clips;
+}
+
+template <bool streaming>
+SOAPY_SDR_TARGET("sse2")
+static void sse2CU8toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S8_FULL_SCALE);
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  const __m128i offset = _mm_set1_epi8(char(SoapySDR::U8_ZERO_OFFSET));
+
+  auto *src = (const uint8_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      const __m128i in = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src+i)), offset);
+      sse2S8toF32<streaming>(dst+i, in, scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = float(SoapySDR::U8toS8(src[i]))*scale;
+  if (streaming) _mm_sfence();
+}
+
+template <bool countClips>
+SOAPY_SDR_TARGET("sse2")
+static size_t sse2CF32toCU8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S8_FULL_SCALE);
+  const __m128 scaleVec = _mm_set1_ps(scale);
+  const __m128i offset = _mm_set1_epi8(char(SoapySDR::U8_ZERO_OFFSET));
+  __m128i clipVec = _mm_setzero_si128();
+  __m128i *clipVecPtr = countClips?&clipVec:nullptr;
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (uint8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      _mm_storeu_si128((__m128i*)(dst+i), _mm_xor_si128(sse2F32toS8(src+i, scaleVec, clipVecPtr), offset));
+    }
+  size_t clips = countClips?sse2SumClips(clipVec):0;
+  for (; i < numSamps; i++) dst[i] = SoapySDR::S8toU8(clipF32toInt<int8_t>(src[i]*scale, countClips?&clips:nullptr));
+  return clips;
+}
+
+SOAPY_SDR_TARGET("sse2")
+static inline void sse2UnpackCS4(const __m128i in, __m128i &lo, __m128i &hi)
+{
+  //I is the low nibble and Q the high nibble, both move to the top of a byte
+  const __m128i nibble = _mm_set1_epi8(char(0xf0));
+  const __m128i i = _mm_and_si128(_mm_slli_epi16(in, 4), nibble);
+  const __m128i q = _mm_and_si128(in, nibble);
+  lo = _mm_unpacklo_epi8(i, q);
+  hi = _mm_unpackhi_epi8(i, q);
+}
+
+SOAPY_SDR_TARGET("sse2")
+static inline __m128i sse2PackCS4(const __m128i lo, const __m128i hi)
+{
+  //each 16-bit word holds one I/Q pair, gather the top nibbles into the low byte
+  const __m128i iMask = _mm_set1_epi16(0x000f);
+  const __m128i qMask = _mm_set1_epi16(0x00f0);
+  const __m128i a = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(lo, 4), iMask), _mm_and_si128(_mm_srli_epi16(lo, 8), qMask));
+  const __m128i b = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(hi, 4), iMask), _mm_and_si128(_mm_srli_epi16(hi, 8), qMask));
+  return _mm_packus_epi16(a, b);
+}
+
+SOAPY_SDR_TARGET("sse2")
+static void sse2CS4toCS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  auto *src = (const uint8_t*)srcBuff;
+  auto *dst = (int8_t*)dstBuff;
+  size_t i = 0;
+  //integer rescaling is uncommon for wire formats, it takes the scalar loop
+  if (scaler == 1.0) for (; i+16 <= numElems; i += 16)
+    {
+      __m128i lo, hi;
+      sse2UnpackCS4(_mm_loadu_si128((const __m128i*)(src+i)), lo, hi);
+      _mm_storeu_si128((__m128i*)(dst+i*2+0), lo);
+      _mm_storeu_si128((__m128i*)(dst+i*2+16), hi);
+    }
+  const float scale = float(scaler);
+  for (; i < numElems; i++)
+    {
+      int8_t tmp[2];
+      SoapySDR::CS4toCS8(src[i], tmp);
+      dst[i*2+0] = SoapySDR::SaturateInt<int8_t>(tmp[0] * scale);
+      dst[i*2+1] = SoapySDR::SaturateInt<int8_t>(tmp[1] * scale);
+    }
+}
+
+SOAPY_SDR_TARGET("sse2")
+static void sse2CS8toCS4(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  auto *src = (const int8_t*)srcBuff;
+  auto *dst = (uint8_t*)dstBuff;
+  size_t i = 0;
+  if (scaler == 1.0) for (; i+16 <= numElems; i += 16)
+    {
+      const __m128i lo = _mm_loadu_si128((const __m128i*)(src+i*2+0));
+      const __m128i hi = _mm_loadu_si128((const __m128i*)(src+i*2+16));
+      _mm_storeu_si128((__m128i*)(dst+i), sse2PackCS4(lo, hi));
+    }
+  const float scale = float(scaler);
+  for (; i < numElems; i++)
+    {
+      const int8_t tmp[2] = {SoapySDR::SaturateInt<int8_t>(src[i*2+0] * scale), SoapySDR::SaturateInt<int8_t>(src[i*2+1] * scale)};
+      dst[i] = SoapySDR::CS8toCS4(tmp);
+    }
+}
+
+SOAPY_SDR_TARGET("sse2")
+static void sse2CS4toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const float scale = float(scaler/SoapySDR::S8_FULL_SCALE);
+  const __m128 scaleVec = _mm_set1_ps(scale);
+
+  auto *src = (const uint8_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numElems; i += 16)
+    {
+      __m128i lo, hi;
+      sse2UnpackCS4(_mm_loadu_si128((const __m128i*)(src+i)), lo, hi);
+      sse2S8toF32(dst+i*2+0, lo, scaleVec);
+      sse2S8toF32(dst+i*2+16, hi, scaleVec);
+    }
+  for (; i < numElems; i++)
+    {
+      int8_t tmp[2];
+      SoapySDR::CS4toCS8(src[i], tmp);
+      dst[i*2+0] = float(tmp[0])*scale;
+      dst[i*2+1] = float(tmp[1])*scale;
+    }
+}
+
+SOAPY_SDR_TARGET("sse2")
+static void sse2CF32toCS4(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const float scale = float(scaler*SoapySDR::S8_FULL_SCALE);
+  const __m128 scaleVec = _mm_set1_ps(scale);
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (uint8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numElems; i += 16)
+    {
+      const __m128i lo = sse2F32toS8(src+i*2+0, scaleVec);
+      const __m128i hi = sse2F32toS8(src+i*2+16, scaleVec);
+      _mm_storeu_si128((__m128i*)(dst+i), sse2PackCS4(lo, hi));
+    }
+  for (; i < numElems; i++)
+    {
+      const int8_t tmp[2] = {SoapySDR::SaturateInt<int8_t>(src[i*2+0]*scale), SoapySDR::SaturateInt<int8_t>(src[i*2+1]*scale)};
+      dst[i] = SoapySDR::CS8toCS4(tmp);
+    }
+}
+
+// SSE2 double precision kernels
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("sse2")
+static void sse2F64toF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const __m128d scaleVec = _mm_set1_pd(scaler);
+
+  auto *src = (const double*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+4 <= numSamps; i += 4)
+    {
+      const __m128 a = _mm_cvtpd_ps(_mm_mul_pd(_mm_loadu_pd(src+i+0), scaleVec));
+      const __m128 b = _mm_cvtpd_ps(_mm_mul_pd(_mm_loadu_pd(src+i+2), scaleVec));
+      _mm_storeu_ps(dst+i, _mm_movelh_ps(a, b));
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i]*scaler);
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("sse2")
+static void sse2F32toF64(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const __m128d scaleVec = _mm_set1_pd(scaler);
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (double*)dstBuff;
+  size_t i = 0;
+  for (; i+4 <= numSamps; i += 4)
+    {
+      const __m128 in = _mm_loadu_ps(src+i);
+      _mm_storeu_pd(dst+i+0, _mm_mul_pd(_mm_cvtps_pd(in), scaleVec));
+      _mm_storeu_pd(dst+i+2, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(in, in)), scaleVec));
+    }
+  for (; i < numSamps; i++) dst[i] = double(src[i])*scaler;
+}
+
+SOAPY_SDR_TARGET("sse2")
+static inline __m128i sse2F64toS32(const double *src, const __m128d scale, const __m128d lo, const __m128d hi)
+{
+  //four doubles to four saturated int32
+  const __m128d a0 = _mm_mul_pd(_mm_loadu_pd(src+0), scale);
+  const __m128d b0 = _mm_mul_pd(_mm_loadu_pd(src+2), scale);
+  const __m128d a = _mm_min_pd(_mm_max_pd(_mm_and_pd(a0, _mm_cmpord_pd(a0, a0)), lo), hi);
+  const __m128d b = _mm_min_pd(_mm_max_pd(_mm_and_pd(b0, _mm_cmpord_pd(b0, b0)), lo), hi);
+  return _mm_unpacklo_epi64(_mm_cvttpd_epi32(a), _mm_cvttpd_epi32(b));
+}
+
+SOAPY_SDR_TARGET("sse2")
+static inline void sse2S32toF64(double *dst, const __m128i in, const __m128d scale)
+{
+  _mm_storeu_pd(dst+0, _mm_mul_pd(_mm_cvtepi32_pd(in), scale));
+  _mm_storeu_pd(dst+2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(in, 8)), scale));
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("sse2")
+static void sse2F64toS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const double scale = scaler*SoapySDR::S16_FULL_SCALE;
+  const __m128d scaleVec = _mm_set1_pd(scale);
+  const __m128d lo = _mm_set1_pd(-32768.0);
+  const __m128d hi = _mm_set1_pd(32767.0);
+
+  auto *src = (const double*)srcBuff;
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      const __m128i a = sse2F64toS32(src+i+0, scaleVec, lo, hi);
+      const __m128i b = sse2F64toS32(src+i+4, scaleVec, lo, hi);
+      _mm_storeu_si128((__m128i*)(dst+i), _mm_packs_epi32(a, b));
+    }
+  for (; i < numSamps; i++) dst[i] = SoapySDR::SaturateInt<int16_t>(src[i]*scale);
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("sse2")
+static void sse2S16toF64(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const double scale = scaler/SoapySDR::S16_FULL_SCALE;
+  const __m128d scaleVec = _mm_set1_pd(scale);
+
+  auto *src = (const int16_t*)srcBuff;
+  auto *dst = (double*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      const __m128i in = _mm_loadu_si128((const __m128i*)(src+i));
+      sse2S32toF64(dst+i+0, _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16), scaleVec);
+      sse2S32toF64(dst+i+4, _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = double(src[i])*scale;
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("sse2")
+static void sse2F64toS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const double scale = scaler*SoapySDR::S8_FULL_SCALE;
+  const __m128d scaleVec = _mm_set1_pd(scale);
+  const __m128d lo = _mm_set1_pd(-128.0);
+  const __m128d hi = _mm_set1_pd(127.0);
+
+  auto *src = (const double*)srcBuff;
+  auto *dst = (int8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      const __m128i a = _mm_packs_epi32(sse2F64toS32(src+i+0, scaleVec, lo, hi), sse2F64toS32(src+i+4, scaleVec, lo, hi));
+      const __m128i b = _mm_packs_epi32(sse2F64toS32(src+i+8, scaleVec, lo, hi), sse2F64toS32(src+i+12, scaleVec, lo, hi));
+      _mm_storeu_si128((__m128i*)(dst+i), _mm_packs_epi16(a, b));
+    }
+  for (; i < numSamps; i++) dst[i] = SoapySDR::SaturateInt<int8_t>(src[i]*scale);
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("sse2")
+static void sse2S8toF64(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const double scale = scaler/SoapySDR::S8_FULL_SCALE;
+  const __m128d scaleVec = _mm_set1_pd(scale);
+
+  auto *src = (const int8_t*)srcBuff;
+  auto *dst = (double*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      const __m128i in8 = _mm_loadl_epi64((const __m128i*)(src+i));
+      const __m128i in = _mm_srai_epi16(_mm_unpacklo_epi8(in8, in8), 8);
+      sse2S32toF64(dst+i+0, _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16), scaleVec);
+      sse2S32toF64(dst+i+4, _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = double(src[i])*scale;
+}
+
+// ********************************
+// AVX2 kernels
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m256i avx2F32toS32(const float *src, const __m256 scale, const __m256 lo, const __m256 hi, __m256i *clips = nullptr)
+{
+  const __m256 in = _mm256_mul_ps(_mm256_loadu_ps(src), scale);
+  if (clips != nullptr) *clips = _mm256_sub_epi32(*clips, _mm256_castps_si256(_mm256_or_ps(
+    _mm256_cmp_ps(in, lo, _CMP_LT_OQ), _mm256_cmp_ps(in, hi, _CMP_GT_OQ))));
+  return _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_and_ps(in, _mm256_cmp_ps(in, in, _CMP_ORD_Q)), lo), hi));
+}
+
+SOAPY_SDR_TARGET("avx2")
+static inline size_t avx2SumClips(const __m256i clips)
+{
+  return sse2SumClips(_mm_add_epi32(_mm256_castsi256_si128(clips), _mm256_extracti128_si256(clips, 1)));
+}
+
+template <bool streaming = false>
+SOAPY_SDR_TARGET("avx2")
+static inline void avx2S32toF32(float *dst, const __m256i in, const __m256 scale)
+{
+  const __m256 out = _mm256_mul_ps(_mm256_cvtepi32_ps(in), scale);
+  if (streaming) _mm256_stream_ps(dst, out);
+  else _mm256_storeu_ps(dst, out);
+}
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m256i avx2F32toS8(const float *src, const __m256 scale, __m256i *clips = nullptr)
+{
+  const __m256 lo = _mm256_set1_ps(-128.0f);
+  const __m256 hi = _mm256_set1_ps(127.0f);
+  const __m256i a = _mm256_packs_epi32(avx2F32toS32(src+0, scale, lo, hi, clips), avx2F32toS32(src+8, scale, lo, hi, clips));
+  const __m256i b = _mm256_packs_epi32(avx2F32toS32(src+16, scale, lo, hi, clips), avx2F32toS32(src+24, scale, lo, hi, clips));
+  //packs operates per 128-bit lane, restore the sample order across lanes
+  return _mm256_permutevar8x32_epi32(_mm256_packs_epi16(a, b), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+template <bool streaming>
+SOAPY_SDR_TARGET("avx2")
+static void avx2CS16toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S16_FULL_SCALE);
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+
+  auto *src = (const int16_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      avx2S32toF32<streaming>(dst+i+0, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src+i+0))), scaleVec);
+      avx2S32toF32<streaming>(dst+i+8, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src+i+8))), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i])*scale;
+  if (streaming) _mm_sfence();
+}
+
+template <bool countClips>
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2CF32toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S16_FULL_SCALE);
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m256 lo = _mm256_set1_ps(-32768.0f);
+  const __m256 hi = _mm256_set1_ps(32767.0f);
+  __m256i clipVec = _mm256_setzero_si256();
+  __m256i *clipVecPtr = countClips?&clipVec:nullptr;
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      const __m256i a = avx2F32toS32(src+i+0, scaleVec, lo, hi, clipVecPtr);
+      const __m256i b = avx2F32toS32(src+i+8, scaleVec, lo, hi, clipVecPtr);
+      //packs operates per 128-bit lane, restore the sample order across lanes
+      const __m256i out = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xd8);
+      _mm256_storeu_si256((__m256i*)(dst+i), out);
+    }
+  size_t clips = countClips?avx2SumClips(clipVec):0;
+  for (; i < numSamps; i++) dst[i] = clipF32toInt<int16_t>(src[i]*scale, countClips?&clips:nullptr);
+  return clips;
+}
+
+template <bool streaming>
+SOAPY_SDR_TARGET("avx2")
+static void avx2CS8toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S8_FULL_SCALE);
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+
+  auto *src = (const int8_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      const __m128i in = _mm_loadu_si128((const __m128i*)(src+i));
+      avx2S32toF32<streaming>(dst+i+0, _mm256_cvtepi8_epi32(in), scaleVec);
+      avx2S32toF32<streaming>(dst+i+8, _mm256_cvtepi8_epi32(_mm_srli_si128(in, 8)), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i])*scale;
+  if (streaming) _mm_sfence();
+}
+
+template <bool countClips>
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2CF32toCS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S8_FULL_SCALE);
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  __m256i clipVec = _mm256_setzero_si256();
+  __m256i *clipVecPtr = countClips?&clipVec:nullptr;
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (int8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+32 <= numSamps; i += 32)
+    {
+      _mm256_storeu_si256((__m256i*)(dst+i), avx2F32toS8(src+i, scaleVec, clipVecPtr));
+    }
+  size_t clips = countClips?avx2SumClips(clipVec):0;
+  for (; i < numSamps; i++) dst[i] = clipF32toInt<int8_t>(src[i]*scale, countClips?&clips:nullptr);
+  return clips;
+}
+
+template <bool streaming>
+SOAPY_SDR_TARGET("avx2")
+static void avx2CU8toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S8_FULL_SCALE);
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m128i offset = _mm_set1_epi8(char(SoapySDR::U8_ZERO_OFFSET));
+
+  auto *src = (const uint8_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      const __m128i in = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src+i)), offset);
+      avx2S32toF32<streaming>(dst+i+0, _mm256_cvtepi8_epi32(in), scaleVec);
+      avx2S32toF32<streaming>(dst+i+8, _mm256_cvtepi8_epi32(_mm_srli_si128(in, 8)), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = float(SoapySDR::U8toS8(src[i]))*scale;
+  if (streaming) _mm_sfence();
+}
+
+template <bool countClips>
+SOAPY_SDR_TARGET("avx2")
+static size_t avx2CF32toCU8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S8_FULL_SCALE);
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m256i offset = _mm256_set1_epi8(char(SoapySDR::U8_ZERO_OFFSET));
+  __m256i clipVec = _mm256_setzero_si256();
+  __m256i *clipVecPtr = countClips?&clipVec:nullptr;
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (uint8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+32 <= numSamps; i += 32)
+    {
+      _mm256_storeu_si256((__m256i*)(dst+i), _mm256_xor_si256(avx2F32toS8(src+i, scaleVec, clipVecPtr), offset));
+    }
+  size_t clips = countClips?avx2SumClips(clipVec):0;
+  for (; i < numSamps; i++) dst[i] = SoapySDR::S8toU8(clipF32toInt<int8_t>(src[i]*scale, countClips?&clips:nullptr));
+  return clips;
+}
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m256i avx2UnpackCS12(const uint8_t *src)
+{
+  //each 128-bit lane unpacks 4 elements from 12 bytes
+  const __m128i lo = _mm_loadu_si128((const __m128i*)(src+0));
+  const __m128i hi = _mm_loadu_si128((const __m128i*)(src+12));
+  const __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+  const __m256i shuffle = _mm256_setr_epi8(
+    0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11,
+    0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11);
+  const __m256i words = _mm256_shuffle_epi8(in, shuffle);
+  //I is the low 12 bits of the even words, Q is the high 12 bits of the odd words
+  const __m256i i = _mm256_slli_epi16(words, 4);
+  const __m256i q = _mm256_and_si256(words, _mm256_set1_epi16(int16_t(0xfff0)));
+  return _mm256_blend_epi16(i, q, 0xaa);
+}
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m256i avx2PackCS12(const __m256i in)
+{
+  //each 32-bit lane holds one I/Q pair, keep the top 12 bits of each as 24 bits
+  const __m256i i = _mm256_srli_epi32(_mm256_slli_epi32(in, 16), 20);
+  const __m256i q = _mm256_slli_epi32(_mm256_srli_epi32(in, 20), 12);
+  const __m256i shuffle = _mm256_setr_epi8(
+    0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+    0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  const __m256i bytes = _mm256_shuffle_epi8(_mm256_or_si256(i, q), shuffle);
+  //move the 24 valid bytes to the front of the register
+  return _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+}
+
+//The CS12 kernels load 28 bytes to unpack 8 elements and store 32 bytes
+//to pack 8 elements, so the vector loops stop early enough to stay in bounds.
+
+SOAPY_SDR_TARGET("avx2")
+static void avx2CS12toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  auto *src = (const uint8_t*)srcBuff;
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  //integer rescaling is uncommon for wire formats, it takes the scalar loop
+  if (scaler == 1.0) for (; i+10 <= numElems; i += 8)
+    {
+      _mm256_storeu_si256((__m256i*)(dst+i*2), avx2UnpackCS12(src+i*3));
+    }
+  const float scale = float(scaler);
+  for (; i < numElems; i++)
+    {
+      int16_t tmp[2];
+      SoapySDR::CS12toCS16(src+i*3, tmp);
+      dst[i*2+0] = SoapySDR::SaturateInt<int16_t>(tmp[0] * scale);
+      dst[i*2+1] = SoapySDR::SaturateInt<int16_t>(tmp[1] * scale);
+    }
+}
+
+SOAPY_SDR_TARGET("avx2")
+static void avx2CS16toCS12(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  auto *src = (const int16_t*)srcBuff;
+  auto *dst = (uint8_t*)dstBuff;
+  size_t i = 0;
+  if (scaler == 1.0) for (; i+11 <= numElems; i += 8)
+    {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(src+i*2));
+      _mm256_storeu_si256((__m256i*)(dst+i*3), avx2PackCS12(in));
+    }
+  const float scale = float(scaler);
+  for (; i < numElems; i++)
+    {
+      const int16_t tmp[2] = {SoapySDR::SaturateInt<int16_t>(src[i*2+0] * scale), SoapySDR::SaturateInt<int16_t>(src[i*2+1] * scale)};
+      SoapySDR::CS16toCS12(tmp, dst+i*3);
+    }
+}
+
+SOAPY_SDR_TARGET("avx2")
+static void avx2CS12toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const float scale = float(scaler/SoapySDR::S16_FULL_SCALE);
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+
+  auto *src = (const uint8_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+10 <= numElems; i += 8)
+    {
+      const __m256i in = avx2UnpackCS12(src+i*3);
+      avx2S32toF32(dst+i*2+0, _mm256_cvtepi16_epi32(_mm256_castsi256_si128(in)), scaleVec);
+      avx2S32toF32(dst+i*2+8, _mm256_cvtepi16_epi32(_mm256_extracti128_si256(in, 1)), scaleVec);
+    }
+  for (; i < numElems; i++)
+    {
+      int16_t tmp[2];
+      SoapySDR::CS12toCS16(src+i*3, tmp);
+      dst[i*2+0] = float(tmp[0])*scale;
+      dst[i*2+1] = float(tmp[1])*scale;
+    }
+}
+
+SOAPY_SDR_TARGET("avx2")
+static void avx2CF32toCS12(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const float scale = float(scaler*SoapySDR::S16_FULL_SCALE);
+  const __m256 scaleVec = _mm256_set1_ps(scale);
+  const __m256 lo = _mm256_set1_ps(-32768.0f);
+  const __m256 hi = _mm256_set1_ps(32767.0f);
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (uint8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+11 <= numElems; i += 8)
+    {
+      const __m256i a = avx2F32toS32(src+i*2+0, scaleVec, lo, hi);
+      const __m256i b = avx2F32toS32(src+i*2+8, scaleVec, lo, hi);
+      //packs operates per 128-bit lane, restore the sample order across lanes
+      const __m256i in = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xd8);
+      _mm256_storeu_si256((__m256i*)(dst+i*3), avx2PackCS12(in));
+    }
+  for (; i < numElems; i++)
+    {
+      const int16_t tmp[2] = {SoapySDR::SaturateInt<int16_t>(src[i*2+0]*scale), SoapySDR::SaturateInt<int16_t>(src[i*2+1]*scale)};
+      SoapySDR::CS16toCS12(tmp, dst+i*3);
+    }
+}
+
+// AVX2 double precision kernels
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("avx2")
+static void avx2F64toF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const __m256d scaleVec = _mm256_set1_pd(scaler);
+
+  auto *src = (const double*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      const __m128 a = _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_loadu_pd(src+i+0), scaleVec));
+      const __m128 b = _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_loadu_pd(src+i+4), scaleVec));
+      _mm256_storeu_ps(dst+i, _mm256_insertf128_ps(_mm256_castps128_ps256(a), b, 1));
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i]*scaler);
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("avx2")
+static void avx2F32toF64(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const __m256d scaleVec = _mm256_set1_pd(scaler);
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (double*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      _mm256_storeu_pd(dst+i+0, _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(src+i+0)), scaleVec));
+      _mm256_storeu_pd(dst+i+4, _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(src+i+4)), scaleVec));
+    }
+  for (; i < numSamps; i++) dst[i] = double(src[i])*scaler;
+}
+
+SOAPY_SDR_TARGET("avx2")
+static inline __m128i avx2F64toS32(const double *src, const __m256d scale, const __m256d lo, const __m256d hi)
+{
+  const __m256d in = _mm256_mul_pd(_mm256_loadu_pd(src), scale);
+  return _mm256_cvttpd_epi32(_mm256_min_pd(_mm256_max_pd(_mm256_and_pd(in, _mm256_cmp_pd(in, in, _CMP_ORD_Q)), lo), hi));
+}
+
+SOAPY_SDR_TARGET("avx2")
+static inline void avx2S32toF64(double *dst, const __m256i in, const __m256d scale)
+{
+  _mm256_storeu_pd(dst+0, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(in)), scale));
+  _mm256_storeu_pd(dst+4, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(in, 1)), scale));
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("avx2")
+static void avx2F64toS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const double scale = scaler*SoapySDR::S16_FULL_SCALE;
+  const __m256d scaleVec = _mm256_set1_pd(scale);
+  const __m256d lo = _mm256_set1_pd(-32768.0);
+  const __m256d hi = _mm256_set1_pd(32767.0);
+
+  auto *src = (const double*)srcBuff;
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      const __m128i a = avx2F64toS32(src+i+0, scaleVec, lo, hi);
+      const __m128i b = avx2F64toS32(src+i+4, scaleVec, lo, hi);
+      _mm_storeu_si128((__m128i*)(dst+i), _mm_packs_epi32(a, b));
+    }
+  for (; i < numSamps; i++) dst[i] = SoapySDR::SaturateInt<int16_t>(src[i]*scale);
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("avx2")
+static void avx2S16toF64(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const double scale = scaler/SoapySDR::S16_FULL_SCALE;
+  const __m256d scaleVec = _mm256_set1_pd(scale);
+
+  auto *src = (const int16_t*)srcBuff;
+  auto *dst = (double*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      avx2S32toF64(dst+i, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src+i))), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = double(src[i])*scale;
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("avx2")
+static void avx2F64toS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const double scale = scaler*SoapySDR::S8_FULL_SCALE;
+  const __m256d scaleVec = _mm256_set1_pd(scale);
+  const __m256d lo = _mm256_set1_pd(-128.0);
+  const __m256d hi = _mm256_set1_pd(127.0);
+
+  auto *src = (const double*)srcBuff;
+  auto *dst = (int8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      const __m128i a = _mm_packs_epi32(avx2F64toS32(src+i+0, scaleVec, lo, hi), avx2F64toS32(src+i+4, scaleVec, lo, hi));
+      const __m128i b = _mm_packs_epi32(avx2F64toS32(src+i+8, scaleVec, lo, hi), avx2F64toS32(src+i+12, scaleVec, lo, hi));
+      _mm_storeu_si128((__m128i*)(dst+i), _mm_packs_epi16(a, b));
+    }
+  for (; i < numSamps; i++) dst[i] = SoapySDR::SaturateInt<int8_t>(src[i]*scale);
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("avx2")
+static void avx2S8toF64(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const double scale = scaler/SoapySDR::S8_FULL_SCALE;
+  const __m256d scaleVec = _mm256_set1_pd(scale);
+
+  auto *src = (const int8_t*)srcBuff;
+  auto *dst = (double*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      avx2S32toF64(dst+i, _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(src+i))), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = double(src[i])*scale;
+}
+
+// ********************************
+// AVX-512 kernels
+
+//GCC 12 warns about _mm512_undefined_*() used internally by the intrinsics
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+SOAPY_SDR_TARGET("avx512f")
+static inline __m512i avx512F32toS32(const float *src, const __m512 scale, const __m512 lo, const __m512 hi, __m512i *clips = nullptr)
+{
+  const __m512 in = _mm512_mul_ps(_mm512_loadu_ps(src), scale);
+  if (clips != nullptr)
+    {
+      const __mmask16 out = _mm512_cmp_ps_mask(in, lo, _CMP_LT_OQ) | _mm512_cmp_ps_mask(in, hi, _CMP_GT_OQ);
+      *clips = _mm512_mask_add_epi32(*clips, out, *clips, _mm512_set1_epi32(1));
+    }
+  return _mm512_cvttps_epi32(_mm512_min_ps(_mm512_max_ps(_mm512_maskz_mov_ps(_mm512_cmp_ps_mask(in, in, _CMP_ORD_Q), in), lo), hi));
+}
+
+SOAPY_SDR_TARGET("avx512f")
+static inline size_t avx512SumClips(const __m512i clips)
+{
+  uint32_t lanes[16];
+  _mm512_storeu_si512(lanes, clips);
+  size_t sum = 0;
+  for (const auto lane : lanes) sum += lane;
+  return sum;
+}
+
+template <bool streaming = false>
+SOAPY_SDR_TARGET("avx512f")
+static inline void avx512S32toF32(float *dst, const __m512i in, const __m512 scale)
+{
+  const __m512 out = _mm512_mul_ps(_mm512_cvtepi32_ps(in), scale);
+  if (streaming) _mm512_stream_ps(dst, out);
+  else _mm512_storeu_ps(dst, out);
+}
+
+template <bool streaming>
+SOAPY_SDR_TARGET("avx512f")
+static void avx512CS16toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S16_FULL_SCALE);
+  const __m512 scaleVec = _mm512_set1_ps(scale);
+
+  auto *src = (const int16_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      avx512S32toF32<streaming>(dst+i, _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*)(src+i))), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i])*scale;
+  if (streaming) _mm_sfence();
+}
+
+template <bool countClips>
+SOAPY_SDR_TARGET("avx512f")
+static size_t avx512CF32toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S16_FULL_SCALE);
+  const __m512 scaleVec = _mm512_set1_ps(scale);
+  const __m512 lo = _mm512_set1_ps(-32768.0f);
+  const __m512 hi = _mm512_set1_ps(32767.0f);
+  __m512i clipVec = _mm512_setzero_si512();
+  __m512i *clipVecPtr = countClips?&clipVec:nullptr;
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      const __m512i in = avx512F32toS32(src+i, scaleVec, lo, hi, clipVecPtr);
+      _mm256_storeu_si256((__m256i*)(dst+i), _mm512_cvtsepi32_epi16(in));
+    }
+  size_t clips = countClips?avx512SumClips(clipVec):0;
+  for (; i < numSamps; i++) dst[i] = clipF32toInt<int16_t>(src[i]*scale, countClips?&clips:nullptr);
+  return clips;
+}
+
+template <bool streaming>
+SOAPY_SDR_TARGET("avx512f")
+static void avx512CS8toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S8_FULL_SCALE);
+  const __m512 scaleVec = _mm512_set1_ps(scale);
+
+  auto *src = (const int8_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      avx512S32toF32<streaming>(dst+i, _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i*)(src+i))), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i])*scale;
+  if (streaming) _mm_sfence();
+}
+
+template <bool countClips>
+SOAPY_SDR_TARGET("avx512f")
+static size_t avx512CF32toCS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S8_FULL_SCALE);
+  const __m512 scaleVec = _mm512_set1_ps(scale);
+  const __m512 lo = _mm512_set1_ps(-128.0f);
+  const __m512 hi = _mm512_set1_ps(127.0f);
+  __m512i clipVec = _mm512_setzero_si512();
+  __m512i *clipVecPtr = countClips?&clipVec:nullptr;
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (int8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      const __m512i in = avx512F32toS32(src+i, scaleVec, lo, hi, clipVecPtr);
+      _mm_storeu_si128((__m128i*)(dst+i), _mm512_cvtsepi32_epi8(in));
+    }
+  size_t clips = countClips?avx512SumClips(clipVec):0;
+  for (; i < numSamps; i++) dst[i] = clipF32toInt<int8_t>(src[i]*scale, countClips?&clips:nullptr);
+  return clips;
+}
+
+template <bool streaming>
+SOAPY_SDR_TARGET("avx512f")
+static void avx512CU8toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S8_FULL_SCALE);
+  const __m512 scaleVec = _mm512_set1_ps(scale);
+  const __m128i offset = _mm_set1_epi8(char(SoapySDR::U8_ZERO_OFFSET));
+
+  auto *src = (const uint8_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      const __m128i in = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src+i)), offset);
+      avx512S32toF32<streaming>(dst+i, _mm512_cvtepi8_epi32(in), scaleVec);
+    }
+  for (; i < numSamps; i++) dst[i] = float(SoapySDR::U8toS8(src[i]))*scale;
+  if (streaming) _mm_sfence();
+}
+
+template <bool countClips>
+SOAPY_SDR_TARGET("avx512f")
+static size_t avx512CF32toCU8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S8_FULL_SCALE);
+  const __m512 scaleVec = _mm512_set1_ps(scale);
+  const __m512 lo = _mm512_set1_ps(-128.0f);
+  const __m512 hi = _mm512_set1_ps(127.0f);
+  const __m128i offset = _mm_set1_epi8(char(SoapySDR::U8_ZERO_OFFSET));
+  __m512i clipVec = _mm512_setzero_si512();
+  __m512i *clipVecPtr = countClips?&clipVec:nullptr;
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (uint8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+16 <= numSamps; i += 16)
+    {
+      const __m512i in = avx512F32toS32(src+i, scaleVec, lo, hi, clipVecPtr);
+      _mm_storeu_si128((__m128i*)(dst+i), _mm_xor_si128(_mm512_cvtsepi32_epi8(in), offset));
+    }
+  size_t clips = countClips?avx512SumClips(clipVec):0;
+  for (; i < numSamps; i++) dst[i] = SoapySDR::S8toU8(clipF32toInt<int8_t>(src[i]*scale, countClips?&clips:nullptr));
+  return clips;
+}
+
+// AVX-512 double precision kernels
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("avx512f")
+static void avx512F64toF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const __m512d scaleVec = _mm512_set1_pd(scaler);
+
+  auto *src = (const double*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      _mm256_storeu_ps(dst+i, _mm512_cvtpd_ps(_mm512_mul_pd(_mm512_loadu_pd(src+i), scaleVec)));
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i]*scaler);
+}
+
+template <size_t elemDepth>
+SOAPY_SDR_TARGET("avx512f")
+static void avx512F32toF64(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*elemDepth;
+  const __m512d scaleVec = _mm512_set1_pd(scaler);
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (double*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      _mm512_storeu_pd(dst+i, _mm512_mul_pd(_mm512_cvtps_pd(_mm256_loadu_ps(src+i)), scaleVec));
+    }
+  for (; i < numSamps; i++) dst[i] = double(src[i])*scaler;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif //SOAPY_SDR_X86
+
+// ********************************
+// NEON kernels
+
+#ifdef SOAPY_SDR_NEON
+
+//vcvtq_s32_f32 truncates, saturates, and converts not-a-number to zero,
+//and vqmovn saturates when narrowing
+
+static inline int16x8_t neonF32toS16(const float *src, const float scale)
+{
+  const int32x4_t a = vcvtq_s32_f32(vmulq_n_f32(vld1q_f32(src+0), scale));
+  const int32x4_t b = vcvtq_s32_f32(vmulq_n_f32(vld1q_f32(src+4), scale));
+  return vcombine_s16(vqmovn_s32(a), vqmovn_s32(b));
+}
+
+static inline void neonS16toF32(float *dst, const int16x8_t in, const float scale)
+{
+  vst1q_f32(dst+0, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(in))), scale));
+  vst1q_f32(dst+4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), scale));
+}
+
+static void neonCS16toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S16_FULL_SCALE);
+
+  auto *src = (const int16_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      neonS16toF32(dst+i, vld1q_s16(src+i), scale);
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i])*scale;
+}
+
+static void neonCF32toCS16(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S16_FULL_SCALE);
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (int16_t*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      vst1q_s16(dst+i, neonF32toS16(src+i, scale));
+    }
+  for (; i < numSamps; i++) dst[i] = SoapySDR::SaturateInt<int16_t>(src[i]*scale);
+}
+
+static void neonCS8toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S8_FULL_SCALE);
+
+  auto *src = (const int8_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      neonS16toF32(dst+i, vmovl_s8(vld1_s8(src+i)), scale);
+    }
+  for (; i < numSamps; i++) dst[i] = float(src[i])*scale;
+}
+
+static void neonCF32toCS8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S8_FULL_SCALE);
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (int8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      vst1_s8(dst+i, vqmovn_s16(neonF32toS16(src+i, scale)));
+    }
+  for (; i < numSamps; i++) dst[i] = SoapySDR::SaturateInt<int8_t>(src[i]*scale);
+}
+
+static void neonCU8toCF32(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler/SoapySDR::S8_FULL_SCALE);
+  const uint8x8_t offset = vdup_n_u8(SoapySDR::U8_ZERO_OFFSET);
+
+  auto *src = (const uint8_t*)srcBuff;
+  auto *dst = (float*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      const int8x8_t in = vreinterpret_s8_u8(veor_u8(vld1_u8(src+i), offset));
+      neonS16toF32(dst+i, vmovl_s8(in), scale);
+    }
+  for (; i < numSamps; i++) dst[i] = float(SoapySDR::U8toS8(src[i]))*scale;
+}
+
+static void neonCF32toCU8(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t numSamps = numElems*2;
+  const float scale = float(scaler*SoapySDR::S8_FULL_SCALE);
+  const uint8x8_t offset = vdup_n_u8(SoapySDR::U8_ZERO_OFFSET);
+
+  auto *src = (const float*)srcBuff;
+  auto *dst = (uint8_t*)dstBuff;
+  size_t i = 0;
+  for (; i+8 <= numSamps; i += 8)
+    {
+      const int8x8_t out = vqmovn_s16(neonF32toS16(src+i, scale));
+      vst1_u8(dst+i, veor_u8(vreinterpret_u8_s8(out), offset));
+    }
+  for (; i < numSamps; i++) dst[i] = SoapySDR::S8toU8(SoapySDR::SaturateInt<int8_t>(src[i]*scale));
+}
+
+#endif //SOAPY_SDR_NEON
+
+/***********************************************************************
+ * Streaming store variants for large target buffers.
+ * Non-temporal stores require an aligned address, so the cached kernel
+ * converts the elements up to the first aligned target address,
+ * or the entire buffer when the target is not element aligned.
+ **********************************************************************/
+template <ConverterFunction cached, ConverterFunction streaming, size_t srcElemSize, size_t dstElemSize, size_t alignment>
+static void streamConvert(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+  const size_t offset = size_t(dstBuff) % alignment;
+  size_t head = (offset == 0)?0:(alignment-offset)/dstElemSize;
+  if (offset % dstElemSize != 0 or head > numElems) head = numElems;
+  if (head != 0) cached(srcBuff, dstBuff, head, scaler);
+  if (head == numElems) return;
+  streaming((const char *)srcBuff+head*srcElemSize, (char *)dstBuff+head*dstElemSize, numElems-head, scaler);
+}
+
+/***********************************************************************
+ * Kernel table in order of preference for each source/target pair.
+ * Registered by registerKernelTable() with VECTORIZED priority.
+ **********************************************************************/
+struct VectorizedKernel
+{
+  const char *sourceFormat;
+  const char *targetFormat;
+  bool CPUFeatures::*isa;
+  ConverterFunction function;
+  SoapySDR::ConverterRegistry::ClipConverterFunction clipFunction;
+  ConverterFunction streamingFunction;
+};
+
+static const VectorizedKernel vectorizedKernels[] = {
+#ifdef SOAPY_SDR_X86
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF32, &CPUFeatures::avx512f, &avx512CS16toCF32<false>, nullptr, &streamConvert<&avx512CS16toCF32<false>, &avx512CS16toCF32<true>, 4, 8, 64>},
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF32, &CPUFeatures::avx2, &avx2CS16toCF32<false>, nullptr, &streamConvert<&avx2CS16toCF32<false>, &avx2CS16toCF32<true>, 4, 8, 32>},
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF32, &CPUFeatures::sse2, &sse2CS16toCF32<false>, nullptr, &streamConvert<&sse2CS16toCF32<false>, &sse2CS16toCF32<true>, 4, 8, 16>},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS16, &CPUFeatures::avx512f, &discardClips<&avx512CF32toCS16<false>>, &avx512CF32toCS16<true>, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS16, &CPUFeatures::avx2, &discardClips<&avx2CF32toCS16<false>>, &avx2CF32toCS16<true>, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS16, &CPUFeatures::sse2, &discardClips<&sse2CF32toCS16<false>>, &sse2CF32toCS16<true>, nullptr},
+  {SOAPY_SDR_CS8, SOAPY_SDR_CF32, &CPUFeatures::avx512f, &avx512CS8toCF32<false>, nullptr, &streamConvert<&avx512CS8toCF32<false>, &avx512CS8toCF32<true>, 2, 8, 64>},
+  {SOAPY_SDR_CS8, SOAPY_SDR_CF32, &CPUFeatures::avx2, &avx2CS8toCF32<false>, nullptr, &streamConvert<&avx2CS8toCF32<false>, &avx2CS8toCF32<true>, 2, 8, 32>},
+  {SOAPY_SDR_CS8, SOAPY_SDR_CF32, &CPUFeatures::sse2, &sse2CS8toCF32<false>, nullptr, &streamConvert<&sse2CS8toCF32<false>, &sse2CS8toCF32<true>, 2, 8, 16>},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS8, &CPUFeatures::avx512f, &discardClips<&avx512CF32toCS8<false>>, &avx512CF32toCS8<true>, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS8, &CPUFeatures::avx2, &discardClips<&avx2CF32toCS8<false>>, &avx2CF32toCS8<true>, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS8, &CPUFeatures::sse2, &discardClips<&sse2CF32toCS8<false>>, &sse2CF32toCS8<true>, nullptr},
+  {SOAPY_SDR_CU8, SOAPY_SDR_CF32, &CPUFeatures::avx512f, &avx512CU8toCF32<false>, nullptr, &streamConvert<&avx512CU8toCF32<false>, &avx512CU8toCF32<true>, 2, 8, 64>},
+  {SOAPY_SDR_CU8, SOAPY_SDR_CF32, &CPUFeatures::avx2, &avx2CU8toCF32<false>, nullptr, &streamConvert<&avx2CU8toCF32<false>, &avx2CU8toCF32<true>, 2, 8, 32>},
+  {SOAPY_SDR_CU8, SOAPY_SDR_CF32, &CPUFeatures::sse2, &sse2CU8toCF32<false>, nullptr, &streamConvert<&sse2CU8toCF32<false>, &sse2CU8toCF32<true>, 2, 8, 16>},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CU8, &CPUFeatures::avx512f, &discardClips<&avx512CF32toCU8<false>>, &avx512CF32toCU8<true>, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CU8, &CPUFeatures::avx2, &discardClips<&avx2CF32toCU8<false>>, &avx2CF32toCU8<true>, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CU8, &CPUFeatures::sse2, &discardClips<&sse2CF32toCU8<false>>, &sse2CF32toCU8<true>, nullptr},
+  {SOAPY_SDR_CS12, SOAPY_SDR_CS16, &CPUFeatures::avx2, &avx2CS12toCS16, nullptr, nullptr},
+  {SOAPY_SDR_CS16, SOAPY_SDR_CS12, &CPUFeatures::avx2, &avx2CS16toCS12, nullptr, nullptr},
+  {SOAPY_SDR_CS12, SOAPY_SDR_CF32, &CPUFeatures::avx2, &avx2CS12toCF32, nullptr, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS12, &CPUFeatures::avx2, &avx2CF32toCS12, nullptr, nullptr},
+  {SOAPY_SDR_CS4, SOAPY_SDR_CS8, &CPUFeatures::sse2, &sse2CS4toCS8, nullptr, nullptr},
+  {SOAPY_SDR_CS8, SOAPY_SDR_CS4, &CPUFeatures::sse2, &sse2CS8toCS4, nullptr, nullptr},
+  {SOAPY_SDR_CS4, SOAPY_SDR_CF32, &CPUFeatures::sse2, &sse2CS4toCF32, nullptr, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS4, &CPUFeatures::sse2, &sse2CF32toCS4, nullptr, nullptr},
+  {SOAPY_SDR_F64, SOAPY_SDR_F32, &CPUFeatures::avx512f, &avx512F64toF32<1>, nullptr, nullptr},
+  {SOAPY_SDR_F64, SOAPY_SDR_F32, &CPUFeatures::avx2, &avx2F64toF32<1>, nullptr, nullptr},
+  {SOAPY_SDR_F64, SOAPY_SDR_F32, &CPUFeatures::sse2, &sse2F64toF32<1>, nullptr, nullptr},
+  {SOAPY_SDR_F32, SOAPY_SDR_F64, &CPUFeatures::avx512f, &avx512F32toF64<1>, nullptr, nullptr},
+  {SOAPY_SDR_F32, SOAPY_SDR_F64, &CPUFeatures::avx2, &avx2F32toF64<1>, nullptr, nullptr},
+  {SOAPY_SDR_F32, SOAPY_SDR_F64, &CPUFeatures::sse2, &sse2F32toF64<1>, nullptr, nullptr},
+  {SOAPY_SDR_F64, SOAPY_SDR_S16, &CPUFeatures::avx2, &avx2F64toS16<1>, nullptr, nullptr},
+  {SOAPY_SDR_F64, SOAPY_SDR_S16, &CPUFeatures::sse2, &sse2F64toS16<1>, nullptr, nullptr},
+  {SOAPY_SDR_S16, SOAPY_SDR_F64, &CPUFeatures::avx2, &avx2S16toF64<1>, nullptr, nullptr},
+  {SOAPY_SDR_S16, SOAPY_SDR_F64, &CPUFeatures::sse2, &sse2S16toF64<1>, nullptr, nullptr},
+  {SOAPY_SDR_F64, SOAPY_SDR_S8, &CPUFeatures::avx2, &avx2F64toS8<1>, nullptr, nullptr},
+  {SOAPY_SDR_F64, SOAPY_SDR_S8, &CPUFeatures::sse2, &sse2F64toS8<1>, nullptr, nullptr},
+  {SOAPY_SDR_S8, SOAPY_SDR_F64, &CPUFeatures::avx2, &avx2S8toF64<1>, nullptr, nullptr},
+  {SOAPY_SDR_S8, SOAPY_SDR_F64, &CPUFeatures::sse2, &sse2S8toF64<1>, nullptr, nullptr},
+  {SOAPY_SDR_CF64, SOAPY_SDR_CF32, &CPUFeatures::avx512f, &avx512F64toF32<2>, nullptr, nullptr},
+  {SOAPY_SDR_CF64, SOAPY_SDR_CF32, &CPUFeatures::avx2, &avx2F64toF32<2>, nullptr, nullptr},
+  {SOAPY_SDR_CF64, SOAPY_SDR_CF32, &CPUFeatures::sse2, &sse2F64toF32<2>, nullptr, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CF64, &CPUFeatures::avx512f, &avx512F32toF64<2>, nullptr, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CF64, &CPUFeatures::avx2, &avx2F32toF64<2>, nullptr, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CF64, &CPUFeatures::sse2, &sse2F32toF64<2>, nullptr, nullptr},
+  {SOAPY_SDR_CF64, SOAPY_SDR_CS16, &CPUFeatures::avx2, &avx2F64toS16<2>, nullptr, nullptr},
+  {SOAPY_SDR_CF64, SOAPY_SDR_CS16, &CPUFeatures::sse2, &sse2F64toS16<2>, nullptr, nullptr},
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF64, &CPUFeatures::avx2, &avx2S16toF64<2>, nullptr, nullptr},
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF64, &CPUFeatures::sse2, &sse2S16toF64<2>, nullptr, nullptr},
+  {SOAPY_SDR_CF64, SOAPY_SDR_CS8, &CPUFeatures::avx2, &avx2F64toS8<2>, nullptr, nullptr},
+  {SOAPY_SDR_CF64, SOAPY_SDR_CS8, &CPUFeatures::sse2, &sse2F64toS8<2>, nullptr, nullptr},
+  {SOAPY_SDR_CS8, SOAPY_SDR_CF64, &CPUFeatures::avx2, &avx2S8toF64<2>, nullptr, nullptr},
+  {SOAPY_SDR_CS8, SOAPY_SDR_CF64, &CPUFeatures::sse2, &sse2S8toF64<2>, nullptr, nullptr},
+#endif //SOAPY_SDR_X86
+#ifdef SOAPY_SDR_NEON
+  {SOAPY_SDR_CS16, SOAPY_SDR_CF32, &CPUFeatures::neon, &neonCS16toCF32, nullptr, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS16, &CPUFeatures::neon, &neonCF32toCS16, nullptr, nullptr},
+  {SOAPY_SDR_CS8, SOAPY_SDR_CF32, &CPUFeatures::neon, &neonCS8toCF32, nullptr, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CS8, &CPUFeatures::neon, &neonCF32toCS8, nullptr, nullptr},
+  {SOAPY_SDR_CU8, SOAPY_SDR_CF32, &CPUFeatures::neon, &neonCU8toCF32, nullptr, nullptr},
+  {SOAPY_SDR_CF32, SOAPY_SDR_CU8, &CPUFeatures::neon, &neonCF32toCU8, nullptr, nullptr},
+#endif //SOAPY_SDR_NEON
+  {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}
+};
+
+static bool registerVectorizedConverters(void)
+{
+  registerKernelTable(vectorizedKernels, [](const VectorizedKernel &k)
+    {
+      SoapySDR::ConverterRegistry::ConverterDescriptor desc;
+      desc.function = k.function;
+      desc.clipFunction = k.clipFunction;
+      desc.streamingFunction = k.streamingFunction;
+      //every kernel loads a block before storing it, so narrowing kernels work in place
+      desc.inPlaceSafe = SoapySDR::formatToSize(k.targetFormat) <= SoapySDR::formatToSize(k.sourceFormat);
+      SoapySDR::ConverterRegistry(k.sourceFormat, k.targetFormat, SoapySDR::ConverterRegistry::VECTORIZED, desc);
+    });
+  return true;
+}
+
+/*!
+ * lateLoadVectorizedConverters() is called by lateLoadDefaultConverters()
+ * so the CPU is inspected at the same time the generic converters load.
+ */
+void lateLoadVectorizedConverters(void)
+{
+  static const bool registered = registerVectorizedConverters();
+  (void)registered;
+}
@@ -0,0 +1,108 @@
+-- Copyright (c) 2021 Josh Blum
+-- SPDX-License-Identifier: BSL-1.0
+
+---
+-- Convert buffers between stream formats
+-- @module SoapySDR.Converter
+
+local ffi = require("ffi")
+local lib = require("SoapySDR.Lib")
+local Utility = require("SoapySDR.Utility")
+
+local Converter = {}
+
+---
+-- A resolved converter between two stream formats.
+--
+-- The native function pointer is looked up once and cached, so calling the
+-- converter runs the registered C function directly on FFI buffers.
+--
+-- @type Converter
+-- @tfield string sourceFormat the source format markup string
+-- @tfield string targetFormat the target format markup string
+-- @tfield uint sourceElemSize the size in bytes of one source element
+-- @tfield uint targetElemSize the size in bytes of one target element
+-- @tfield bool inPlaceSafe true when the source and target may be the same buffer
+local ConverterMT = {}
+ConverterMT.__index = ConverterMT
+
+---
+-- Convert numElems from the source buffer into the target buffer.
+-- @tparam Converter self the resolved converter
+-- @param srcBuff an FFI buffer of at least numElems source elements
+-- @param dstBuff an FFI buffer of at least numElems target elements
+-- @tparam uint numElems the number of elements to convert
+-- @tparam[opt=1.0] number scaler the scale factor
+--
+-- @usage
+-- local conv = SoapySDR.Converter.resolve(SoapySDR.Format.CS16, SoapySDR.Format.CF32)
+-- local src = ffi.new("int16_t[?]", 2*numElems)
+-- local dst = ffi.new("complex float[?]", numElems)
+-- conv(src, dst, numElems, 1.0/32768)
+function ConverterMT:__call(srcBuff, dstBuff, numElems, scaler)
+    if self.fn ~= nil then
+        self.fn(srcBuff, dstBuff, numElems, scaler or 1.0)
+    else
+        lib.SoapySDRConverter_convertPath(self.path, srcBuff, dstBuff, numElems, scaler or 1.0)
+    end
+end
+
+---
+-- Get a list of formats to which we can convert the source format.
+-- @tparam SoapySDR.Format sourceFormat the source format markup string
+-- @treturn table a list of target formats
+function Converter.listTargetFormats(sourceFormat)
+    local lengthPtr = ffi.new("size_t[1]")
+    return Utility.processRawStringList(
+        lib.SoapySDRConverter_listTargetFormats(sourceFormat, lengthPtr),
+        lengthPtr)
+end
+
+---
+-- Get a list of formats from which we can convert to the target format.
+-- @tparam SoapySDR.Format targetFormat the target format markup string
+-- @treturn table a list of source formats
+function Converter.listSourceFormats(targetFormat)
+    local lengthPtr = ffi.new("size_t[1]")
+    return Utility.processRawStringList(
+        lib.SoapySDRConverter_listSourceFormats(targetFormat, lengthPtr),
+        lengthPtr)
+end
+
+---
+-- Resolve the best converter between two formats.
+--
+-- When no single converter exists, a chain of converters through
+-- intermediate formats is used instead. Resolve once when a stream
+-- is configured and reuse the returned converter for every buffer.
+--
+-- @tparam SoapySDR.Format sourceFormat the source format markup string
+-- @tparam SoapySDR.Format targetFormat the target format markup string
+-- @treturn Converter the resolved converter, or nil when the formats are not convertible
+function Converter.resolve(sourceFormat, targetFormat)
+    local sourceId = lib.SoapySDRConverter_internFormat(sourceFormat)
+    local targetId = lib.SoapySDRConverter_internFormat(targetFormat)
+
+    local conv =
+    {
+        sourceFormat = sourceFormat,
+        targetFormat = targetFormat,
+        sourceElemSize = tonumber(lib.SoapySDR_formatToSize(sourceFormat)),
+        targetElemSize = tonumber(lib.SoapySDR_formatToSize(targetFormat)),
+        inPlaceSafe = false
+    }
+
+    local handle = lib.SoapySDRConverter_resolve(sourceId, targetId)
+    if handle ~= nil then
+        conv.handle = handle
+        conv.fn = handle["function"]
+        conv.inPlaceSafe = handle.inPlaceSafe
+    else
+        conv.path = lib.SoapySDRConverter_resolvePath(sourceId, targetId)
+        if conv.path == nil then return nil end
+    end
+
+    return setmetatable(conv, ConverterMT)
+end
+
+return Converter
@@ -82,6 +82,53 @@ if not __internal.SoapySDR then
 
         size_t SoapySDR_formatToSize(const char *format);
 
+        /* SoapySDR/Converters.h */
+
+        typedef void (*SoapySDRConverterFunction)(const void *, void *, const size_t, const double);
+
+        typedef void (*SoapySDRBatchConverterFunction)(const void * const *, void * const *, const size_t, const size_t, const double);
+
+        typedef size_t (*SoapySDRClipConverterFunction)(const void *, void *, const size_t, const double);
+
+        typedef enum
+        {
+            SOAPY_SDR_CONVERTER_GENERIC    = 0,
+            SOAPY_SDR_CONVERTER_VECTORIZED = 3,
+            SOAPY_SDR_CONVERTER_CUSTOM     = 5
+        } SoapySDRConverterFunctionPriority;
+
+        typedef uint32_t SoapySDRConverterFormatId;
+
+        typedef struct
+        {
+            SoapySDRConverterFunction function;
+            SoapySDRBatchConverterFunction batchFunction;
+            size_t sourceElemSize;
+            size_t targetElemSize;
+            SoapySDRConverterFunctionPriority priority;
+            SoapySDRConverterFormatId sourceFormat;
+            SoapySDRConverterFormatId targetFormat;
+            bool inPlaceSafe;
+            SoapySDRClipConverterFunction clipFunction;
+            SoapySDRConverterFunction streamingFunction;
+        } SoapySDRConverterHandle;
+
+        typedef struct SoapySDRConverterPath SoapySDRConverterPath;
+
+        char **SoapySDRConverter_listTargetFormats(const char *sourceFormat, size_t *length);
+
+        char **SoapySDRConverter_listSourceFormats(const char *targetFormat, size_t *length);
+
+        SoapySDRConverterFormatId SoapySDRConverter_internFormat(const char *format);
+
+        const SoapySDRConverterHandle *SoapySDRConverter_resolve(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat);
+
+        const SoapySDRConverterHandle *SoapySDRConverter_resolveWithPriority(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat, const SoapySDRConverterFunctionPriority priority);
+
+        const SoapySDRConverterPath *SoapySDRConverter_resolvePath(const SoapySDRConverterFormatId sourceFormat, const SoapySDRConverterFormatId targetFormat);
+
+        int SoapySDRConverter_convertPath(const SoapySDRConverterPath *path, const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler);
+
         /* SoapySDR/Logger.h */
 
         typedef enum
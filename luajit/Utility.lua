@@ -284,7 +284,7 @@ function Utility.processRawStringList(stringList, lengthPtr)
         ret[i+1] = ffi.string(stringList[i])
     end
 
-    lib.SoapySDRStrings_clear(ffi.new("char**[1]", {cStrs}), len)
+    lib.SoapySDRStrings_clear(ffi.new("char**[1]", {stringList}), len)
 
     return ret
 end
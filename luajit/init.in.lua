@@ -211,6 +211,7 @@ local SoapySDR =
     enumerateDevices = enumerateDevices,
 
     Device = Device,
+    Converter = require("SoapySDR.Converter"),
     Logger = require("SoapySDR.Logger"),
     Time = require("SoapySDR.Time")
 }
@@ -0,0 +1,67 @@
+-- Copyright (c) 2021 Josh Blum
+-- SPDX-License-Identifier: BSL-1.0
+
+SoapySDR = require("SoapySDR")
+
+ffi = require("ffi")
+luaunit = require("luaunit")
+
+local function contains(list, value)
+    for _,v in ipairs(list) do
+        if v == value then return true end
+    end
+    return false
+end
+
+function testListFormats()
+    luaunit.assertTrue(contains(SoapySDR.Converter.listTargetFormats(SoapySDR.Format.CS16), SoapySDR.Format.CF32))
+    luaunit.assertTrue(contains(SoapySDR.Converter.listSourceFormats(SoapySDR.Format.CF32), SoapySDR.Format.CS16))
+end
+
+function testConvertFFIBuffers()
+    local numElems = 16
+    local conv = SoapySDR.Converter.resolve(SoapySDR.Format.CS16, SoapySDR.Format.CF32)
+    luaunit.assertNotNil(conv)
+    luaunit.assertEquals(conv.sourceElemSize, 4)
+    luaunit.assertEquals(conv.targetElemSize, 8)
+
+    local src = ffi.new("int16_t[?]", 2*numElems)
+    local dst = ffi.new("float[?]", 2*numElems)
+    for i = 0,2*numElems-1 do
+        src[i] = (i - numElems) * 1024
+    end
+
+    conv(src, dst, numElems, 1.0/32768)
+    for i = 0,2*numElems-1 do
+        luaunit.assertAlmostEquals(dst[i], src[i] / 32768, 1e-6)
+    end
+
+    -- the same cached converter runs again on the next buffer
+    conv(src, dst, numElems, 2.0/32768)
+    luaunit.assertAlmostEquals(dst[0], 2 * src[0] / 32768, 1e-6)
+end
+
+function testConvertInPlace()
+    local numElems = 16
+    local conv = SoapySDR.Converter.resolve(SoapySDR.Format.CF32, SoapySDR.Format.CS16)
+    luaunit.assertNotNil(conv)
+    luaunit.assertTrue(conv.inPlaceSafe)
+
+    local buff = ffi.new("float[?]", 2*numElems)
+    for i = 0,2*numElems-1 do
+        buff[i] = (i - numElems) / 32
+    end
+
+    conv(buff, buff, numElems, 32767)
+    local out = ffi.cast("int16_t*", buff)
+    for i = 0,2*numElems-1 do
+        luaunit.assertTrue(math.abs(out[i] - ((i - numElems) / 32) * 32767) <= 1)
+    end
+end
+
+function testUnknownFormat()
+    luaunit.assertNil(SoapySDR.Converter.resolve("NOT_A_FORMAT", SoapySDR.Format.CF32))
+end
+
+local runner = luaunit.LuaUnit.new()
+os.exit(runner:runSuite())
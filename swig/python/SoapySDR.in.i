@@ -67,6 +67,8 @@ SoapySDR library: {2}""".format(COMPILE_ABI_VERSION, PYTHONLIB_ABI_VERSION, CORE
 #include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Time.hpp>
 #include <SoapySDR/Logger.hpp>
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <cstdint>
 %}
 
 ////////////////////////////////////////////////////////////////////////
@@ -264,6 +266,137 @@ def registerLogHandler(handler):
 
 %include <SoapySDR/Logger.hpp>
 
+////////////////////////////////////////////////////////////////////////
+// Format converters on buffer-protocol objects
+// The buffers are used in place and the GIL is released during conversion
+////////////////////////////////////////////////////////////////////////
+%{
+    struct _SoapySDR_pythonBuffer
+    {
+        _SoapySDR_pythonBuffer(PyObject *obj, const int flags, const char *what)
+        {
+            if (PyObject_GetBuffer(obj, &view, flags | PyBUF_C_CONTIGUOUS) != 0)
+            {
+                PyErr_Clear();
+                throw std::invalid_argument(std::string(what) + " must be a C-contiguous" +
+                    ((flags & PyBUF_WRITABLE) ? " writable" : "") + " buffer");
+            }
+        }
+        ~_SoapySDR_pythonBuffer(void)
+        {
+            PyBuffer_Release(&view);
+        }
+        Py_buffer view;
+    };
+
+    //the resolved converter or path, with the element sizes it was registered with
+    struct _SoapySDR_pythonConverter
+    {
+        _SoapySDR_pythonConverter(const std::string &sourceFormat, const std::string &targetFormat)
+        {
+            const auto sourceId = SoapySDR::ConverterRegistry::internFormat(sourceFormat);
+            const auto targetId = SoapySDR::ConverterRegistry::internFormat(targetFormat);
+            handle = SoapySDR::ConverterRegistry::resolve(sourceId, targetId);
+            path = (handle == nullptr)? SoapySDR::ConverterRegistry::resolvePath(sourceId, targetId) : nullptr;
+            if (handle != nullptr)
+            {
+                sourceSize = handle->sourceElemSize;
+                targetSize = handle->targetElemSize;
+            }
+            else if (path != nullptr)
+            {
+                sourceSize = path->hops.front()->sourceElemSize;
+                targetSize = path->hops.back()->targetElemSize;
+            }
+            else
+            {
+                throw std::invalid_argument("no converter from " + sourceFormat + " to " + targetFormat);
+            }
+
+            //custom formats have no size in their markup, so buffers of them can not be counted in elements
+            if (sourceSize == 0 || targetSize == 0)
+            {
+                throw std::invalid_argument("unknown element size for the conversion from " + sourceFormat + " to " + targetFormat);
+            }
+        }
+        const SoapySDR::ConverterRegistry::ConverterHandle *handle;
+        const SoapySDR::ConverterRegistry::ConverterPath *path;
+        size_t sourceSize;
+        size_t targetSize;
+    };
+%}
+
+%inline %{
+    std::vector<size_t> convertElemSizes__(const std::string &sourceFormat, const std::string &targetFormat)
+    {
+        const _SoapySDR_pythonConverter converter(sourceFormat, targetFormat);
+        return std::vector<size_t>{converter.sourceSize, converter.targetSize};
+    }
+
+    size_t convertBuffers__(PyObject *src, PyObject *dst, const std::string &sourceFormat, const std::string &targetFormat, const double scaler)
+    {
+        const _SoapySDR_pythonConverter converter(sourceFormat, targetFormat);
+        const auto handle = converter.handle;
+        const auto path = converter.path;
+        const size_t sourceSize = converter.sourceSize;
+        const size_t targetSize = converter.targetSize;
+
+        _SoapySDR_pythonBuffer srcBuff(src, PyBUF_SIMPLE, "src");
+        _SoapySDR_pythonBuffer dstBuff(dst, PyBUF_WRITABLE, "out");
+        const size_t numElems = size_t(srcBuff.view.len)/sourceSize;
+        if (size_t(dstBuff.view.len) < numElems*targetSize)
+        {
+            throw std::invalid_argument("out is too small for " + std::to_string(numElems) + " " + targetFormat + " elements");
+        }
+
+        //overlapping buffers are only supported in place by converters that declare it
+        const auto srcBegin = uintptr_t(srcBuff.view.buf), srcEnd = srcBegin + numElems*sourceSize;
+        const auto dstBegin = uintptr_t(dstBuff.view.buf), dstEnd = dstBegin + numElems*targetSize;
+        if (numElems != 0 && srcBegin < dstEnd && dstBegin < srcEnd &&
+            !(srcBegin == dstBegin && handle != nullptr && handle->inPlaceSafe))
+        {
+            throw std::invalid_argument("conversion from " + sourceFormat + " to " + targetFormat + " can not be done in place");
+        }
+
+        Py_BEGIN_ALLOW_THREADS
+        if (handle != nullptr) (*handle)(srcBuff.view.buf, dstBuff.view.buf, numElems, scaler);
+        else (*path)(srcBuff.view.buf, dstBuff.view.buf, numElems, scaler);
+        Py_END_ALLOW_THREADS
+        return numElems;
+    }
+%}
+
+%insert("python")
+%{
+def _convertOutputArray(format, numElems, elemSize):
+    import numpy
+    dtypes = dict(F64='f8', F32='f4', S32='i4', U32='u4', S16='i2', U16='u2', S8='i1', U8='u1', CF64='c16', CF32='c8')
+    if format in dtypes: return numpy.empty(numElems, dtype=dtypes[format])
+    if format[0] == 'C' and format[1:] in dtypes and format[1:] not in ('F64', 'F32'):
+        return numpy.empty((numElems, 2), dtype=dtypes[format[1:]])
+    return numpy.empty(numElems*elemSize, dtype='u1')
+
+def convert(src, sourceFormat, targetFormat, out = None, scaler = 1.0):
+    """Convert a buffer of samples between two stream formats.
+
+    The conversion uses the best registered converter and operates directly
+    on the memory of buffer-protocol objects such as numpy arrays.
+    The interpreter lock is released while the samples are converted.
+
+    :param src: a C-contiguous buffer of sourceFormat elements
+    :param sourceFormat: the source format markup string, ex SOAPY_SDR_CS16
+    :param targetFormat: the target format markup string, ex SOAPY_SDR_CF32
+    :param out: an optional preallocated writable buffer, or src when the converter supports in place
+    :param scaler: the scale factor applied by the converter
+    :returns: out, or a new numpy array of the target format when out is None
+    """
+    if out is None:
+        sourceSize, targetSize = convertElemSizes__(sourceFormat, targetFormat)
+        out = _convertOutputArray(targetFormat, memoryview(src).nbytes//sourceSize, targetSize)
+    convertBuffers__(src, out, sourceFormat, targetFormat, scaler)
+    return out
+%}
+
 ////////////////////////////////////////////////////////////////////////
 // Device object
 ////////////////////////////////////////////////////////////////////////
@@ -274,6 +407,8 @@ def registerLogHandler(handler):
 %warnfilter(509) SoapySDR::Device::make;
 
 %nodefaultctor SoapySDR::Device;
+%ignore SoapySDR::StreamCallback;
+%ignore SoapySDR::Device::setStreamCallback;
 %include <SoapySDR/Device.hpp>
 
 //narrow import * to SOAPY_SDR_ constants
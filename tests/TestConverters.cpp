@@ -0,0 +1,1140 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/ConverterRegistry.hpp>
+#include <SoapySDR/ConverterPrimitives.hpp>
+#include <SoapySDR/Formats.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <complex>
+#include <string>
+#include <vector>
+#include <limits>
+#include <type_traits>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+/***********************************************************************
+ * Random input generation within the nominal range of the format
+ **********************************************************************/
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, T>::type randomSample(void)
+{
+    return T(std::rand())/RAND_MAX*0.9 - 0.45;
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value, T>::type randomSample(void)
+{
+    return T(std::rand());
+}
+
+template <typename T>
+double tolerance(void)
+{
+    return std::is_floating_point<T>::value?1e-6:1.0;
+}
+
+/***********************************************************************
+ * Compare a converter priority against the generic implementation
+ **********************************************************************/
+template <typename SrcType, typename DstType>
+static bool checkAgainstGeneric(
+    const std::string &sourceFormat,
+    const std::string &targetFormat,
+    const SoapySDR::ConverterRegistry::FunctionPriority priority)
+{
+    printf("  Check %s -> %s (priority %d) ... ", sourceFormat.c_str(), targetFormat.c_str(), int(priority));
+    const size_t elemDepth = SoapySDR::formatToSize(sourceFormat)/sizeof(SrcType);
+
+    const auto generic = SoapySDR::ConverterRegistry::getFunction(sourceFormat, targetFormat, SoapySDR::ConverterRegistry::GENERIC);
+    const auto function = SoapySDR::ConverterRegistry::getFunction(sourceFormat, targetFormat, priority);
+
+    //odd sizes exercise the scalar remainder after the vector loop
+    for (const size_t numElems : {0, 1, 3, 7, 8, 15, 16, 17, 33, 1000})
+    {
+        for (const double scaler : {1.0, 0.5, 2.0})
+        {
+            std::vector<SrcType> src(numElems*elemDepth);
+            for (auto &s : src) s = randomSample<SrcType>();
+            const size_t dstSize = numElems*SoapySDR::formatToSize(targetFormat)/sizeof(DstType);
+            std::vector<DstType> expected(dstSize), actual(dstSize);
+            generic(src.data(), expected.data(), numElems, scaler);
+            function(src.data(), actual.data(), numElems, scaler);
+
+            for (size_t i = 0; i < dstSize; i++)
+            {
+                if (std::abs(double(expected[i]) - double(actual[i])) <= tolerance<DstType>()) continue;
+                printf("FAIL\n");
+                printf("  -> numElems=%d, scaler=%f, index=%d: %f != %f\n",
+                    int(numElems), scaler, int(i), double(expected[i]), double(actual[i]));
+                return false;
+            }
+        }
+    }
+    printf("PASS\n");
+    return true;
+}
+
+template <typename SrcType, typename DstType>
+static bool checkAllPriorities(const std::string &sourceFormat, const std::string &targetFormat)
+{
+    for (const auto priority : SoapySDR::ConverterRegistry::listPriorities(sourceFormat, targetFormat))
+    {
+        if (priority == SoapySDR::ConverterRegistry::GENERIC) continue;
+        if (not checkAgainstGeneric<SrcType, DstType>(sourceFormat, targetFormat, priority)) return false;
+    }
+    return true;
+}
+
+/***********************************************************************
+ * Check saturation and clip counting with out of range input
+ **********************************************************************/
+template <typename DstType>
+static bool checkClipCounts(const std::string &targetFormat, const double lo, const double hi)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    const auto sourceId = Registry::internFormat(SOAPY_SDR_CF32);
+    const auto targetId = Registry::internFormat(targetFormat);
+    const double fullScale = (lo < -128.0)?SoapySDR::S16_FULL_SCALE:SoapySDR::S8_FULL_SCALE;
+    const int offset = std::is_unsigned<DstType>::value?128:0;
+
+    for (const auto priority : Registry::listPriorities(SOAPY_SDR_CF32, targetFormat))
+    {
+        printf("  Check CF32 -> %s clip count (priority %d) ... ", targetFormat.c_str(), int(priority));
+        const auto *handle = Registry::resolve(sourceId, targetId, priority);
+        if (handle == nullptr or handle->clipFunction == nullptr)
+        {
+            printf("FAIL\n");
+            printf("  -> no clip converter\n");
+            return false;
+        }
+
+        for (const size_t numElems : {0, 1, 3, 7, 8, 15, 16, 17, 33, 1000})
+        {
+            for (const double scaler : {1.0, 0.5, 2.0})
+            {
+                //three times the nominal range so that about half of the samples clip
+                std::vector<float> src(numElems*2);
+                for (auto &s : src) s = randomSample<float>()*3.0f;
+
+                const float scale = float(scaler*fullScale);
+                size_t expectedClips(0);
+                std::vector<DstType> expected(src.size());
+                for (size_t i = 0; i < src.size(); i++)
+                {
+                    const float samp = src[i]*scale;
+                    if (samp < lo or samp > hi) expectedClips++;
+                    expected[i] = DstType(int(std::max(lo, std::min(hi, double(samp)))) + offset);
+                }
+
+                std::vector<DstType> plain(src.size()), clipped(src.size());
+                handle->function(src.data(), plain.data(), numElems, scaler);
+                const size_t clips = handle->clipFunction(src.data(), clipped.data(), numElems, scaler);
+
+                if (clips != expectedClips or plain != clipped or plain != expected)
+                {
+                    printf("FAIL\n");
+                    printf("  -> numElems=%d, scaler=%f, clips=%d, expected=%d\n",
+                        int(numElems), scaler, int(clips), int(expectedClips));
+                    return false;
+                }
+            }
+        }
+        printf("PASS\n");
+    }
+    return true;
+}
+
+/***********************************************************************
+ * Check that not-a-number converts to zero at every priority
+ **********************************************************************/
+template <typename SrcType, typename DstType>
+static bool checkNotANumber(const std::string &sourceFormat, const std::string &targetFormat)
+{
+    const DstType zero = std::is_unsigned<DstType>::value?DstType(128):DstType(0);
+    const size_t elemDepth = SoapySDR::formatToSize(sourceFormat)/sizeof(SrcType);
+    for (const auto priority : SoapySDR::ConverterRegistry::listPriorities(sourceFormat, targetFormat))
+    {
+        printf("  Check %s -> %s not-a-number (priority %d) ... ", sourceFormat.c_str(), targetFormat.c_str(), int(priority));
+        const auto function = SoapySDR::ConverterRegistry::getFunction(sourceFormat, targetFormat, priority);
+
+        //every other sample is not-a-number, in the vector loop and the remainder
+        const size_t numElems = 37;
+        std::vector<SrcType> src(numElems*elemDepth);
+        for (size_t i = 0; i < src.size(); i++) src[i] = (i%2 == 0)?std::numeric_limits<SrcType>::quiet_NaN():SrcType(0.25);
+        std::vector<DstType> dst(src.size());
+        function(src.data(), dst.data(), numElems, 1.0);
+        for (size_t i = 0; i < dst.size(); i += 2)
+        {
+            if (dst[i] == zero) continue;
+            printf("FAIL\n");
+            printf("  -> index=%d: %d != %d\n", int(i), int(dst[i]), int(zero));
+            return false;
+        }
+        printf("PASS\n");
+    }
+    return true;
+}
+
+/***********************************************************************
+ * Check the bit layout of the packed formats
+ **********************************************************************/
+static bool checkPackedLayout(void)
+{
+    printf("  Check packed CS12 and CS4 layout ... ");
+    const int16_t cs16[2] = {int16_t(0x1230), int16_t(0xabc0)};
+    const uint8_t cs12[3] = {0x23, 0xc1, 0xab};
+    const int8_t cs8[2] = {int8_t(0x30), int8_t(0xa0)};
+    const uint8_t cs4[1] = {0xa3};
+
+    uint8_t packed12[3] = {};
+    int16_t unpacked16[2] = {};
+    uint8_t packed4[1] = {};
+    int8_t unpacked8[2] = {};
+    SoapySDR::ConverterRegistry::getFunction(SOAPY_SDR_CS16, SOAPY_SDR_CS12)(cs16, packed12, 1, 1.0);
+    SoapySDR::ConverterRegistry::getFunction(SOAPY_SDR_CS12, SOAPY_SDR_CS16)(cs12, unpacked16, 1, 1.0);
+    SoapySDR::ConverterRegistry::getFunction(SOAPY_SDR_CS8, SOAPY_SDR_CS4)(cs8, packed4, 1, 1.0);
+    SoapySDR::ConverterRegistry::getFunction(SOAPY_SDR_CS4, SOAPY_SDR_CS8)(cs4, unpacked8, 1, 1.0);
+
+    if (std::equal(cs12, cs12+3, packed12) and std::equal(cs16, cs16+2, unpacked16) and
+        std::equal(cs4, cs4+1, packed4) and std::equal(cs8, cs8+2, unpacked8))
+    {
+        printf("PASS\n");
+        return true;
+    }
+    printf("FAIL\n");
+    return false;
+}
+
+/***********************************************************************
+ * Check resolved handles against the string lookup API
+ **********************************************************************/
+static bool checkHandles(void)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    printf("  Check handle layout ... ");
+    if (sizeof(Registry::ConverterHandle) != 64 or alignof(Registry::ConverterHandle) != 64)
+    {
+        printf("FAIL\n");
+        return false;
+    }
+    printf("PASS\n");
+
+    printf("  Check interned formats ... ");
+    const auto cs16 = Registry::internFormat(SOAPY_SDR_CS16);
+    const auto cf32 = Registry::internFormat(SOAPY_SDR_CF32);
+    const auto unknown = Registry::internFormat("NOT_A_FORMAT");
+    if (cs16 != Registry::internFormat(std::string("CS") + "16") or cs16 == cf32 or
+        Registry::getFormatString(cf32) != SOAPY_SDR_CF32 or
+        unknown != Registry::internFormat("NOT_A_FORMAT") or
+        Registry::getFormatString(unknown) != "NOT_A_FORMAT" or
+        Registry::getFormatString(Registry::INVALID_FORMAT_ID) != "")
+    {
+        printf("FAIL\n");
+        return false;
+    }
+    printf("PASS\n");
+
+    printf("  Check resolved handles ... ");
+    for (const auto &source : Registry::listAvailableSourceFormats())
+    {
+        for (const auto &target : Registry::listTargetFormats(source))
+        {
+            const auto srcId = Registry::internFormat(source);
+            const auto dstId = Registry::internFormat(target);
+            const auto *handle = Registry::resolve(srcId, dstId);
+            if (handle == nullptr or (size_t(handle) % 64) != 0 or
+                handle->function != Registry::getFunction(source, target) or
+                handle->priority != Registry::listPriorities(source, target).back() or
+                handle->sourceElemSize != SoapySDR::formatToSize(source) or
+                handle->targetElemSize != SoapySDR::formatToSize(target) or
+                handle->sourceFormat != srcId or handle->targetFormat != dstId)
+            {
+                printf("FAIL\n  -> %s -> %s\n", source.c_str(), target.c_str());
+                return false;
+            }
+            for (const auto priority : Registry::listPriorities(source, target))
+            {
+                const auto *h = Registry::resolve(srcId, dstId, priority);
+                if (h == nullptr or h->function != Registry::getFunction(source, target, priority))
+                {
+                    printf("FAIL\n  -> %s -> %s priority %d\n", source.c_str(), target.c_str(), int(priority));
+                    return false;
+                }
+            }
+        }
+    }
+    if (Registry::resolve(cs16, unknown) != nullptr or
+        Registry::resolve(Registry::INVALID_FORMAT_ID, cf32) != nullptr or
+        Registry::resolve(cs16, cf32, Registry::CUSTOM) != nullptr)
+    {
+        printf("FAIL\n  -> unexpected handle\n");
+        return false;
+    }
+    printf("PASS\n");
+    return true;
+}
+
+/***********************************************************************
+ * Query the registry while another thread registers converters
+ **********************************************************************/
+static void dummyConverter(const void *, void *, const size_t, const double)
+{
+    return;
+}
+
+static bool checkConcurrentRegistration(void)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    printf("  Check concurrent registration ... ");
+    const auto cs16 = Registry::internFormat(SOAPY_SDR_CS16);
+    const auto cf32 = Registry::internFormat(SOAPY_SDR_CF32);
+    const auto expected = Registry::resolve(cs16, cf32)->function;
+
+    std::atomic<bool> done(false);
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < 4; i++) readers.emplace_back([&]()
+    {
+        while (not done)
+        {
+            if (Registry::resolve(cs16, cf32)->function != expected) ok = false;
+            if (Registry::getFunction(SOAPY_SDR_CS16, SOAPY_SDR_CF32) != expected) ok = false;
+            if (Registry::listTargetFormats(SOAPY_SDR_CS16).empty()) ok = false;
+        }
+    });
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        const auto format = "TEST" + std::to_string(i);
+        Registry(format, SOAPY_SDR_CF32, Registry::CUSTOM, &dummyConverter);
+        const auto *handle = Registry::resolve(Registry::internFormat(format), cf32);
+        if (handle == nullptr or handle->function != &dummyConverter) ok = false;
+    }
+
+    done = true;
+    for (auto &reader : readers) reader.join();
+    printf("%s\n", ok?"PASS":"FAIL");
+    return ok;
+}
+
+/***********************************************************************
+ * Convert channel arrays with and without batch-native converters
+ **********************************************************************/
+static size_t batchCalls(0);
+
+static void scaleConverter(const void *srcBuff, void *dstBuff, const size_t numElems, const double scaler)
+{
+    const float *src = (const float *)srcBuff;
+    float *dst = (float *)dstBuff;
+    for (size_t i = 0; i < numElems; i++) dst[i] = float(src[i]*scaler);
+}
+
+static void scaleBatchConverter(const void * const *srcBuffs, void * const *dstBuffs, const size_t numChans, const size_t numElems, const double scaler)
+{
+    batchCalls++;
+    for (size_t ch = 0; ch < numChans; ch++) scaleConverter(srcBuffs[ch], dstBuffs[ch], numElems, scaler);
+}
+
+static bool checkConvertChannels(void)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    const size_t numChans(5), numElems(1000);
+
+    std::vector<std::vector<int16_t>> src(numChans, std::vector<int16_t>(numElems*2));
+    std::vector<std::vector<float>> expected(numChans, std::vector<float>(numElems*2));
+    std::vector<const void *> srcBuffs;
+    for (auto &s : src)
+    {
+        for (auto &x : s) x = randomSample<int16_t>();
+        srcBuffs.push_back(s.data());
+    }
+
+    const auto *handle = Registry::resolve(Registry::internFormat(SOAPY_SDR_CS16), Registry::internFormat(SOAPY_SDR_CF32));
+    for (size_t ch = 0; ch < numChans; ch++) handle->function(src[ch].data(), expected[ch].data(), numElems, 0.5);
+
+    for (const size_t numThreads : {1, 2, 4, 16})
+    {
+        printf("  Check per-channel conversion with %d threads ... ", int(numThreads));
+        std::vector<std::vector<float>> actual(numChans, std::vector<float>(numElems*2));
+        std::vector<void *> dstBuffs;
+        for (auto &a : actual) dstBuffs.push_back(a.data());
+        Registry::convertChannels(*handle, srcBuffs.data(), dstBuffs.data(), numChans, numElems, 0.5, numThreads);
+        if (actual != expected)
+        {
+            printf("FAIL\n");
+            return false;
+        }
+        printf("PASS\n");
+    }
+
+    printf("  Check batch-native conversion ... ");
+    Registry::ConverterDescriptor batchDesc;
+    batchDesc.function = &scaleConverter;
+    batchDesc.batchFunction = &scaleBatchConverter;
+    Registry("TEST_BATCH", "TEST_BATCH_OUT", Registry::CUSTOM, batchDesc);
+    const auto *batch = Registry::resolve(Registry::internFormat("TEST_BATCH"), Registry::internFormat("TEST_BATCH_OUT"));
+    if (batch == nullptr or batch->function != &scaleConverter or batch->batchFunction != &scaleBatchConverter or
+        handle->batchFunction != nullptr)
+    {
+        printf("FAIL\n  -> unexpected handle\n");
+        return false;
+    }
+    std::vector<float> in0(numElems, 1.0f), in1(numElems, 2.0f), out0(numElems), out1(numElems);
+    const void *ins[] = {in0.data(), in1.data()};
+    void *outs[] = {out0.data(), out1.data()};
+    Registry::convertChannels(*batch, ins, outs, 2, numElems, 0.5);
+    if (batchCalls != 1 or out0 != std::vector<float>(numElems, 0.5f) or out1 != std::vector<float>(numElems, 1.0f))
+    {
+        printf("FAIL\n");
+        return false;
+    }
+    printf("PASS\n");
+    return true;
+}
+
+/***********************************************************************
+ * Check channel converters against the single-channel converters
+ **********************************************************************/
+template <typename SrcType, typename DstType>
+static bool checkChannelConverter(
+    const std::string &sourceFormat,
+    const std::string &targetFormat,
+    const SoapySDR::ConverterRegistry::ChannelLayout layout)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    const bool deinterleave = (layout == Registry::DEINTERLEAVE);
+    const auto single = Registry::getFunction(sourceFormat, targetFormat);
+
+    for (const auto priority : Registry::listPriorities(sourceFormat, targetFormat, layout))
+    {
+        printf("  Check %s %s -> %s (priority %d) ... ", deinterleave?"deinterleave":"interleave",
+            sourceFormat.c_str(), targetFormat.c_str(), int(priority));
+        const auto function = Registry::getFunction(sourceFormat, targetFormat, layout, priority);
+
+        for (const size_t numChans : {1, 2, 3, 4, 5})
+        {
+            for (const size_t numElems : {0, 1, 3, 8, 17, 1000})
+            {
+                for (const double scaler : {1.0, 0.5})
+                {
+                    //random planar source and the interleaved equivalent
+                    std::vector<std::vector<SrcType>> planarIn(numChans, std::vector<SrcType>(numElems*2));
+                    std::vector<SrcType> packedIn(numChans*numElems*2);
+                    for (size_t ch = 0; ch < numChans; ch++)
+                    {
+                        for (size_t i = 0; i < numElems*2; i++)
+                        {
+                            planarIn[ch][i] = randomSample<SrcType>();
+                            packedIn[(i/2*numChans+ch)*2+i%2] = planarIn[ch][i];
+                        }
+                    }
+
+                    //expected output from the single channel converter
+                    std::vector<std::vector<DstType>> expected(numChans, std::vector<DstType>(numElems*2));
+                    for (size_t ch = 0; ch < numChans; ch++) single(planarIn[ch].data(), expected[ch].data(), numElems, scaler);
+
+                    std::vector<std::vector<DstType>> planarOut(numChans, std::vector<DstType>(numElems*2));
+                    std::vector<DstType> packedOut(numChans*numElems*2);
+                    std::vector<const void *> ins;
+                    std::vector<void *> outs;
+                    if (deinterleave)
+                    {
+                        ins.push_back(packedIn.data());
+                        for (auto &o : planarOut) outs.push_back(o.data());
+                    }
+                    else
+                    {
+                        for (auto &in : planarIn) ins.push_back(in.data());
+                        outs.push_back(packedOut.data());
+                    }
+                    function(ins.data(), outs.data(), numChans, numElems, scaler);
+
+                    for (size_t ch = 0; ch < numChans; ch++)
+                    {
+                        for (size_t i = 0; i < numElems*2; i++)
+                        {
+                            const DstType actual = deinterleave?planarOut[ch][i]:packedOut[(i/2*numChans+ch)*2+i%2];
+                            if (std::abs(double(expected[ch][i]) - double(actual)) <= tolerance<DstType>()) continue;
+                            printf("FAIL\n");
+                            printf("  -> numChans=%d, numElems=%d, scaler=%f, ch=%d, index=%d: %f != %f\n",
+                                int(numChans), int(numElems), scaler, int(ch), int(i), double(expected[ch][i]), double(actual));
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        printf("PASS\n");
+    }
+    return true;
+}
+
+static bool checkChannelConverters(void)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    bool ok(true);
+    ok = ok and checkChannelConverter<int16_t, float>(SOAPY_SDR_CS16, SOAPY_SDR_CF32, Registry::DEINTERLEAVE);
+    ok = ok and checkChannelConverter<int8_t, float>(SOAPY_SDR_CS8, SOAPY_SDR_CF32, Registry::DEINTERLEAVE);
+    ok = ok and checkChannelConverter<uint8_t, float>(SOAPY_SDR_CU8, SOAPY_SDR_CF32, Registry::DEINTERLEAVE);
+    ok = ok and checkChannelConverter<float, float>(SOAPY_SDR_CF32, SOAPY_SDR_CF32, Registry::DEINTERLEAVE);
+    ok = ok and checkChannelConverter<int16_t, int16_t>(SOAPY_SDR_CS16, SOAPY_SDR_CS16, Registry::DEINTERLEAVE);
+    ok = ok and checkChannelConverter<int8_t, int8_t>(SOAPY_SDR_CS8, SOAPY_SDR_CS8, Registry::DEINTERLEAVE);
+    ok = ok and checkChannelConverter<float, int16_t>(SOAPY_SDR_CF32, SOAPY_SDR_CS16, Registry::INTERLEAVE);
+    ok = ok and checkChannelConverter<float, int8_t>(SOAPY_SDR_CF32, SOAPY_SDR_CS8, Registry::INTERLEAVE);
+    ok = ok and checkChannelConverter<float, uint8_t>(SOAPY_SDR_CF32, SOAPY_SDR_CU8, Registry::INTERLEAVE);
+    ok = ok and checkChannelConverter<float, float>(SOAPY_SDR_CF32, SOAPY_SDR_CF32, Registry::INTERLEAVE);
+    ok = ok and checkChannelConverter<int16_t, int16_t>(SOAPY_SDR_CS16, SOAPY_SDR_CS16, Registry::INTERLEAVE);
+    ok = ok and checkChannelConverter<int8_t, int8_t>(SOAPY_SDR_CS8, SOAPY_SDR_CS8, Registry::INTERLEAVE);
+    return ok;
+}
+
+/***********************************************************************
+ * Fused conversion with DC offset and IQ balance correction
+ **********************************************************************/
+template <typename SrcType>
+static bool checkCorrection(const std::string &sourceFormat)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    const size_t numElems(1000 + 3);
+    std::vector<SrcType> src(numElems*2);
+    for (auto &x : src) x = randomSample<SrcType>();
+
+    //reference: plain conversion then correction in double precision
+    const std::complex<double> dc(0.01, -0.02), iq(0.05, 0.03);
+    std::vector<std::complex<float>> converted(numElems);
+    Registry::getFunction(sourceFormat, SOAPY_SDR_CF32, Registry::GENERIC)(src.data(), converted.data(), numElems, 0.5);
+
+    std::complex<double> trackedDC;
+    std::vector<std::complex<float>> trackedOut;
+    for (const auto priority : Registry::listCorrectionPriorities(sourceFormat, SOAPY_SDR_CF32))
+    {
+        printf("  Check correction %s -> CF32 (priority %d) ... ", sourceFormat.c_str(), int(priority));
+        const auto fn = Registry::getCorrectionFunction(sourceFormat, SOAPY_SDR_CF32, priority);
+        Registry::IQCorrection corr;
+        corr.dcOffset = dc;
+        corr.iqBalance = iq;
+        std::vector<std::complex<float>> out(numElems);
+        fn(src.data(), out.data(), numElems, 0.5, &corr);
+        for (size_t i = 0; i < numElems; i++)
+        {
+            const std::complex<double> p = std::complex<double>(converted[i]) - dc;
+            const std::complex<double> expected = p + iq*std::conj(p);
+            if (std::abs(expected - std::complex<double>(out[i])) > 1e-5 or corr.dcOffset != dc)
+            {
+                printf("FAIL\n  -> index %d: expected (%f, %f), actual (%f, %f)\n", int(i),
+                    expected.real(), expected.imag(), out[i].real(), out[i].imag());
+                return false;
+            }
+        }
+
+        //the tracker result must not depend on the kernel
+        corr.dcTracking = 0.01;
+        fn(src.data(), out.data(), numElems, 0.5, &corr);
+        if (trackedOut.empty())
+        {
+            trackedDC = corr.dcOffset;
+            trackedOut = out;
+        }
+        for (size_t i = 0; i < numElems; i++)
+        {
+            if (std::abs(trackedOut[i] - out[i]) > 1e-5 or std::abs(trackedDC - corr.dcOffset) > 1e-6)
+            {
+                printf("FAIL\n  -> tracking mismatch at index %d\n", int(i));
+                return false;
+            }
+        }
+        printf("PASS\n");
+    }
+    return true;
+}
+
+static bool checkDCTracking(void)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    printf("  Check DC tracking convergence ... ");
+    const size_t numElems(4096);
+    const std::complex<float> offset(0.3f, -0.2f);
+    std::vector<std::complex<float>> src(numElems), out(numElems);
+    for (auto &x : src) x = offset + std::complex<float>(randomSample<float>(), randomSample<float>())*0.01f;
+
+    Registry::IQCorrection corr;
+    corr.dcTracking = 0.01;
+    const auto fn = Registry::getCorrectionFunction(SOAPY_SDR_CF32, SOAPY_SDR_CF32);
+    for (size_t n = 0; n < 4; n++) fn(src.data(), out.data(), numElems, 1.0, &corr);
+    if (std::abs(corr.dcOffset - std::complex<double>(offset)) > 1e-3 or std::abs(out.back()) > 0.02)
+    {
+        printf("FAIL\n  -> dcOffset (%f, %f)\n", corr.dcOffset.real(), corr.dcOffset.imag());
+        return false;
+    }
+    printf("PASS\n");
+    return true;
+}
+
+/***********************************************************************
+ * Fused conversion with level statistics
+ **********************************************************************/
+template <typename SrcType, typename DstType>
+static bool checkStats(const std::string &sourceFormat, const std::string &targetFormat, const double fullScale)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    const size_t numElems(5000 + 5);
+    const double scaler(0.75);
+    const bool fromFloat = std::is_floating_point<SrcType>::value;
+
+    //float sources exceed full scale, integer sources include the rails
+    std::vector<SrcType> src(numElems*2);
+    for (auto &x : src) x = fromFloat?SrcType(randomSample<SrcType>()*3):randomSample<SrcType>();
+    if (not fromFloat) for (size_t i = 0; i < 10; i++) src[i*7] = (i%2)?std::numeric_limits<SrcType>::max():std::numeric_limits<SrcType>::min();
+
+    std::vector<DstType> expected(numElems*2);
+    Registry::getFunction(sourceFormat, targetFormat, Registry::GENERIC)(src.data(), expected.data(), numElems, scaler);
+
+    //reference statistics in double precision on the floating point side
+    double sumSquares(0.0), peak(0.0);
+    size_t numClipped(0);
+    std::vector<double> values(numElems*2);
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        if (fromFloat)
+        {
+            const float v = float(src[i])*float(scaler*fullScale);
+            numClipped += (v < -fullScale or v > fullScale-1)?1:0;
+            values[i] = v/fullScale;
+        }
+        else
+        {
+            values[i] = double(expected[i]);
+            numClipped += (src[i] == std::numeric_limits<SrcType>::max() or src[i] == std::numeric_limits<SrcType>::min())?1:0;
+        }
+    }
+    for (size_t i = 0; i < numElems; i++)
+    {
+        const double mag = values[i*2]*values[i*2] + values[i*2+1]*values[i*2+1];
+        sumSquares += mag;
+        peak = std::max(peak, std::sqrt(mag));
+    }
+
+    for (const auto priority : Registry::listStatsPriorities(sourceFormat, targetFormat))
+    {
+        printf("  Check stats %s -> %s (priority %d) ... ", sourceFormat.c_str(), targetFormat.c_str(), int(priority));
+        Registry::ConverterStats stats;
+        std::vector<DstType> out(numElems*2);
+        const auto fn = Registry::getStatsFunction(sourceFormat, targetFormat, priority);
+        fn(src.data(), out.data(), numElems, scaler, &stats);
+        fn(src.data(), out.data(), numElems, scaler, &stats);
+        if (out != expected)
+        {
+            printf("FAIL\n  -> output does not match the converter\n");
+            return false;
+        }
+        if (stats.numElems != numElems*2 or stats.numClipped != numClipped*2 or
+            std::abs(stats.sumSquares/(sumSquares*2) - 1.0) > 1e-4 or std::abs(stats.peakMagnitude/peak - 1.0) > 1e-5 or
+            std::abs(stats.meanPower() - sumSquares/numElems) > 1e-4*stats.meanPower())
+        {
+            printf("FAIL\n  -> elems %d, clipped %d (expected %d), sum %f (expected %f), peak %f (expected %f)\n",
+                int(stats.numElems), int(stats.numClipped), int(numClipped*2), stats.sumSquares, sumSquares*2, stats.peakMagnitude, peak);
+            return false;
+        }
+        printf("PASS\n");
+    }
+    return true;
+}
+
+/***********************************************************************
+ * Check the streaming store variants and the store mode selection
+ **********************************************************************/
+template <typename SrcType>
+static bool checkStreamingStores(const std::string &sourceFormat)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    printf("  Check %s -> %s streaming stores ... ", sourceFormat.c_str(), SOAPY_SDR_CF32);
+    const auto *handle = Registry::resolve(Registry::internFormat(sourceFormat), Registry::internFormat(SOAPY_SDR_CF32), Registry::VECTORIZED);
+    if (handle == nullptr or handle->streamingFunction == nullptr)
+    {
+        printf("SKIP\n");
+        return true;
+    }
+
+    //offset the target by single floats to cover every alignment of the head
+    std::vector<SrcType> src(2*1000);
+    for (auto &x : src) x = randomSample<SrcType>();
+    std::vector<float> expected(2*1000+16), actual(2*1000+16);
+    for (size_t offset = 0; offset < 16; offset++)
+    {
+        for (const size_t numElems : {0, 1, 3, 17, 33, 1000})
+        {
+            std::fill(actual.begin(), actual.end(), 0.0f);
+            handle->function(src.data(), expected.data()+offset, numElems, 0.5);
+            handle->streamingFunction(src.data(), actual.data()+offset, numElems, 0.5);
+            if (not std::equal(expected.begin()+offset, expected.begin()+offset+2*numElems, actual.begin()+offset))
+            {
+                printf("FAIL\n  -> offset=%d, numElems=%d\n", int(offset), int(numElems));
+                return false;
+            }
+        }
+    }
+    printf("PASS\n");
+    return true;
+}
+
+static size_t cachedCalls(0), streamingCalls(0);
+
+static void cachedConverter(const void *, void *, const size_t, const double)
+{
+    cachedCalls++;
+}
+
+static void streamingConverter(const void *, void *, const size_t, const double)
+{
+    streamingCalls++;
+}
+
+static bool checkStoreModes(void)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    printf("  Check store mode selection ... ");
+    Registry::ConverterDescriptor desc;
+    desc.function = &cachedConverter;
+    desc.streamingFunction = &streamingConverter;
+    Registry("STREAM_IN32", "STREAM_OUT32", Registry::CUSTOM, desc);
+    const auto *handle = Registry::resolve(Registry::internFormat("STREAM_IN32"), Registry::internFormat("STREAM_OUT32"));
+    if (handle == nullptr or handle->targetElemSize != 4)
+    {
+        printf("FAIL\n");
+        return false;
+    }
+    const size_t threshold = Registry::getStreamingThreshold();
+    Registry::setStreamingThreshold(1024);
+
+    //the threshold is 256 elements of the 32-bit target format
+    (*handle)(nullptr, nullptr, 255);
+    const bool below = cachedCalls == 1 and streamingCalls == 0;
+    (*handle)(nullptr, nullptr, 256);
+    const bool above = cachedCalls == 1 and streamingCalls == 1;
+    (*handle)(nullptr, nullptr, 1000, 1.0, Registry::CACHED_STORES);
+    (*handle)(nullptr, nullptr, 1, 1.0, Registry::STREAMING_STORES);
+    const bool forced = cachedCalls == 2 and streamingCalls == 2;
+
+    Registry::setStreamingThreshold(threshold);
+    if (not below or not above or not forced)
+    {
+        printf("FAIL\n");
+        return false;
+    }
+    printf("PASS\n");
+    return true;
+}
+
+/***********************************************************************
+ * Check converters registered over the built-in generic converters
+ **********************************************************************/
+static void overlayF64toU16(const void *, void *, const size_t, const double)
+{
+    return;
+}
+
+static bool checkBuiltinOverlay(void)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    printf("  Check built-in converter overlay ... ");
+    const auto f64 = Registry::internFormat(SOAPY_SDR_F64);
+    const auto u16 = Registry::internFormat(SOAPY_SDR_U16);
+    const auto *builtin = Registry::resolve(f64, u16);
+    if (builtin == nullptr or builtin->priority != Registry::GENERIC or builtin->clipFunction == nullptr)
+    {
+        printf("FAIL\n  -> no built-in F64 -> U16 converter\n");
+        return false;
+    }
+
+    //the built-in priority is taken, the custom one overrides it
+    Registry(SOAPY_SDR_F64, SOAPY_SDR_U16, Registry::GENERIC, &overlayF64toU16);
+    Registry(SOAPY_SDR_F64, SOAPY_SDR_U16, Registry::CUSTOM, &overlayF64toU16);
+    const auto *custom = Registry::resolve(f64, u16);
+    const std::vector<Registry::FunctionPriority> priorities{Registry::GENERIC, Registry::CUSTOM};
+    if (custom == nullptr or custom->function != &overlayF64toU16 or
+        custom->clipFunction != builtin->clipFunction or
+        Registry::resolve(f64, u16, Registry::GENERIC) != builtin or
+        Registry::getFunction(SOAPY_SDR_F64, SOAPY_SDR_U16, Registry::GENERIC) != builtin->function or
+        Registry::listPriorities(SOAPY_SDR_F64, SOAPY_SDR_U16) != priorities)
+    {
+        printf("FAIL\n");
+        return false;
+    }
+    printf("PASS\n");
+    return true;
+}
+
+/***********************************************************************
+ * Check that every format converts to every format of its kind
+ **********************************************************************/
+static double matrixTolerance(const std::string &format)
+{
+    if (format.find('F') != std::string::npos) return 1e-6;
+    //two steps of the integer format for truncation and rescaling
+    const size_t bits = SoapySDR::formatToSize(format)*8/((format.front() == 'C')?2:1);
+    return 1.0/double(uint64_t(1) << (bits-2));
+}
+
+static bool checkConverterMatrix(const std::string &name, const std::string &reference, const std::vector<std::string> &formats)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    printf("  Check %s converter matrix ... ", name.c_str());
+
+    //values that are exact in every format, including 4-bit integers
+    const float values[] = {0.0f, 0.25f, -0.5f, 0.375f, -0.125f, 0.75f};
+    const size_t numElems = 6/(SoapySDR::formatToSize(reference)/sizeof(float));
+    std::vector<uint8_t> src(64), dst(64);
+    float out[6];
+
+    for (const auto &srcFormat : formats)
+    {
+        for (const auto &dstFormat : formats)
+        {
+            const auto convert = Registry::getFunction(srcFormat, dstFormat, Registry::GENERIC);
+            if (convert == nullptr)
+            {
+                printf("FAIL\n  -> no %s -> %s converter\n", srcFormat.c_str(), dstFormat.c_str());
+                return false;
+            }
+            const double tol = std::max(matrixTolerance(srcFormat), matrixTolerance(dstFormat));
+            for (const double scaler : {1.0, 0.5})
+            {
+                Registry::getFunction(reference, srcFormat, Registry::GENERIC)(values, src.data(), numElems, 1.0);
+                convert(src.data(), dst.data(), numElems, scaler);
+                Registry::getFunction(dstFormat, reference, Registry::GENERIC)(dst.data(), out, numElems, 1.0);
+                for (size_t i = 0; i < 6; i++)
+                {
+                    if (std::abs(out[i] - values[i]*scaler) > tol)
+                    {
+                        printf("FAIL\n  -> %s -> %s scaler %g index %d: expected %f, actual %f\n",
+                            srcFormat.c_str(), dstFormat.c_str(), scaler, int(i), values[i]*scaler, out[i]);
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    printf("PASS\n");
+    return true;
+}
+
+/***********************************************************************
+ * Check that in-place safe converters work with aliased buffers
+ **********************************************************************/
+static bool checkInPlace(const std::string &name, const std::string &reference, const std::vector<std::string> &formats)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    printf("  Check in-place %s converters ... ", name.c_str());
+    const size_t elemDepth = SoapySDR::formatToSize(reference)/sizeof(float);
+
+    for (const auto &srcFormat : formats)
+    {
+        for (const auto &dstFormat : formats)
+        {
+            for (const auto priority : Registry::listPriorities(srcFormat, dstFormat))
+            {
+                const auto *handle = Registry::resolve(Registry::internFormat(srcFormat), Registry::internFormat(dstFormat), priority);
+                const bool narrowing = handle->targetElemSize <= handle->sourceElemSize;
+                if (priority <= Registry::VECTORIZED and handle->inPlaceSafe != narrowing)
+                {
+                    printf("FAIL\n  -> %s -> %s (priority %d) in-place safe %d\n", srcFormat.c_str(), dstFormat.c_str(), int(priority), int(handle->inPlaceSafe));
+                    return false;
+                }
+                if (not handle->inPlaceSafe) continue;
+
+                for (const size_t numElems : {0, 1, 3, 7, 8, 15, 16, 17, 33, 1000})
+                {
+                    std::vector<float> values(numElems*elemDepth);
+                    for (auto &x : values) x = randomSample<float>();
+                    std::vector<uint8_t> src(numElems*handle->sourceElemSize), expected(numElems*handle->targetElemSize);
+                    Registry::getFunction(reference, srcFormat, Registry::GENERIC)(values.data(), src.data(), numElems, 1.0);
+
+                    for (const double scaler : {1.0, 0.5, 2.0})
+                    {
+                        auto buff = src;
+                        handle->function(src.data(), expected.data(), numElems, scaler);
+                        handle->function(buff.data(), buff.data(), numElems, scaler);
+                        bool ok = std::equal(expected.begin(), expected.end(), buff.begin());
+                        if (ok and handle->clipFunction != nullptr)
+                        {
+                            buff = src;
+                            const size_t clips = handle->clipFunction(src.data(), expected.data(), numElems, scaler);
+                            ok = handle->clipFunction(buff.data(), buff.data(), numElems, scaler) == clips and
+                                std::equal(expected.begin(), expected.end(), buff.begin());
+                        }
+                        if (not ok)
+                        {
+                            printf("FAIL\n  -> %s -> %s (priority %d) numElems %d scaler %g\n",
+                                srcFormat.c_str(), dstFormat.c_str(), int(priority), int(numElems), scaler);
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    printf("PASS\n");
+    return true;
+}
+
+/***********************************************************************
+ * Convert through a multi-hop path between unconnected formats
+ **********************************************************************/
+static bool checkConverterPaths(void)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    const auto cs16 = Registry::internFormat(SOAPY_SDR_CS16);
+    const auto cf32 = Registry::internFormat(SOAPY_SDR_CF32);
+    const auto cf64 = Registry::internFormat(SOAPY_SDR_CF64);
+
+    printf("  Check direct path ... ");
+    const auto *direct = Registry::resolvePath(cs16, cf32);
+    if (direct == nullptr or direct->hops.size() != 1 or direct->hops[0] != Registry::resolve(cs16, cf32))
+    {
+        printf("FAIL\n");
+        return false;
+    }
+    printf("PASS\n");
+
+    printf("  Check unconnected path ... ");
+    if (Registry::resolvePath(Registry::internFormat("TEST_NO_PATH"), cf64) != nullptr)
+    {
+        printf("FAIL\n");
+        return false;
+    }
+    printf("PASS\n");
+
+    //a packed format without a direct converter to CF64,
+    //it reaches CF64 through the wider or the lossy formats
+    const auto packed = Registry::internFormat("TEST_PATH_CS12");
+    for (const auto &format : {SOAPY_SDR_CS16, SOAPY_SDR_CS8, SOAPY_SDR_CS4})
+    {
+        Registry("TEST_PATH_CS12", format, Registry::CUSTOM, Registry::getFunction(SOAPY_SDR_CS12, format, Registry::GENERIC));
+    }
+
+    printf("  Check TEST_PATH_CS12 -> CF64 path ... ");
+    const auto *path = Registry::resolvePath(packed, cf64);
+    if (Registry::resolve(packed, cf64) != nullptr or path == nullptr or path->hops.size() < 2 or
+        path->hops.front()->sourceFormat != packed or path->hops.back()->targetFormat != cf64)
+    {
+        printf("FAIL\n  -> unexpected path\n");
+        return false;
+    }
+    for (size_t i = 1; i < path->hops.size(); i++)
+    {
+        const auto format = Registry::getFormatString(path->hops[i]->sourceFormat);
+        if (format == SOAPY_SDR_CS8 or format == SOAPY_SDR_CS4 or format == SOAPY_SDR_CU8)
+        {
+            printf("FAIL\n  -> lossy intermediate format %s\n", format.c_str());
+            return false;
+        }
+    }
+
+    //a length that is not a multiple of the block size
+    const size_t numElems = path->blockElems*3 + 7;
+    std::vector<uint8_t> src(numElems*3);
+    for (auto &x : src) x = randomSample<uint8_t>();
+    std::vector<int16_t> wide(numElems*2);
+    std::vector<double> expected(numElems*2), actual(numElems*2);
+    Registry::getFunction(SOAPY_SDR_CS12, SOAPY_SDR_CS16, Registry::GENERIC)(src.data(), wide.data(), numElems, 1.0);
+    Registry::getFunction(SOAPY_SDR_CS16, SOAPY_SDR_CF64, Registry::GENERIC)(wide.data(), expected.data(), numElems, 0.5);
+    (*path)(src.data(), actual.data(), numElems, 0.5);
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        if (std::abs(expected[i] - actual[i]) > 1e-6)
+        {
+            printf("FAIL\n  -> index %d: expected %f, actual %f\n", int(i), expected[i], actual[i]);
+            return false;
+        }
+    }
+    printf("PASS\n");
+    return true;
+}
+
+/***********************************************************************
+ * Auto-tuning selects the fastest priority and stores it in the cache
+ **********************************************************************/
+static void fastConverter(const void *srcBuff, void *dstBuff, const size_t numElems, const double)
+{
+    std::memcpy(dstBuff, srcBuff, numElems*sizeof(int32_t));
+}
+
+static void slowConverter(const void *srcBuff, void *dstBuff, const size_t numElems, const double)
+{
+    const int32_t *src = (const int32_t *)srcBuff;
+    int32_t *dst = (int32_t *)dstBuff;
+    for (size_t i = 0; i < numElems; i++)
+    {
+        volatile int32_t x = src[i];
+        for (size_t j = 0; j < 16; j++) x = x + 0;
+        dst[i] = x;
+    }
+}
+
+static bool checkAutoTuning(void)
+{
+    typedef SoapySDR::ConverterRegistry Registry;
+    printf("  Check auto-tuning ... ");
+#ifdef _WIN32
+    _putenv_s("SOAPY_SDR_CONVERTER_TUNING_CACHE", TUNING_CACHE_DIR);
+#else
+    setenv("SOAPY_SDR_CONVERTER_TUNING_CACHE", TUNING_CACHE_DIR, 1);
+#endif
+
+    Registry("TUNE_IN32", "TUNE_OUT32", Registry::GENERIC, &fastConverter);
+    Registry("TUNE_IN32", "TUNE_OUT32", Registry::CUSTOM, &slowConverter);
+    const auto source = Registry::internFormat("TUNE_IN32");
+    const auto target = Registry::internFormat("TUNE_OUT32");
+    if (Registry::resolve(source, target)->function != &slowConverter)
+    {
+        printf("FAIL\n  -> expected the highest priority without tuning\n");
+        return false;
+    }
+
+    //resolution is a lookup, only tune() and getFunction() measure the pair
+    Registry::setAutoTuning(true);
+    if (Registry::resolve(source, target)->function != &slowConverter)
+    {
+        Registry::setAutoTuning(false);
+        printf("FAIL\n  -> expected the highest priority before tuning\n");
+        return false;
+    }
+    const auto *tuned = Registry::tune(source, target);
+    const bool selected = tuned->function == &fastConverter and
+        Registry::getFunction("TUNE_IN32", "TUNE_OUT32") == &fastConverter and
+        Registry::resolve(source, target) == tuned and Registry::tune(source, target) == tuned;
+    Registry::setAutoTuning(false);
+    if (not selected)
+    {
+        printf("FAIL\n  -> expected the fastest priority with tuning\n");
+        return false;
+    }
+
+    const auto path = Registry::getTuningCachePath();
+    std::ifstream file(path);
+    std::string line, entry;
+    while (std::getline(file, line))
+    {
+        if (line.compare(0, 10, "TUNE_IN32 ") == 0) entry = line;
+    }
+    file.close();
+    std::remove(path.c_str());
+#ifdef _WIN32
+    _rmdir(TUNING_CACHE_DIR);
+#else
+    rmdir(TUNING_CACHE_DIR);
+#endif
+    if (entry != "TUNE_IN32 TUNE_OUT32 0 0,5")
+    {
+        printf("FAIL\n  -> unexpected cache entry '%s' in %s\n", entry.c_str(), path.c_str());
+        return false;
+    }
+
+    if (Registry::resolve(source, target)->function != &slowConverter)
+    {
+        printf("FAIL\n  -> expected the highest priority after disabling tuning\n");
+        return false;
+    }
+    printf("PASS\n");
+    return true;
+}
+
+int main(void)
+{
+    bool ok(true);
+
+    printf("Check vectorized converters:\n");
+    ok = ok and checkAllPriorities<int16_t, float>(SOAPY_SDR_CS16, SOAPY_SDR_CF32);
+    ok = ok and checkAllPriorities<float, int16_t>(SOAPY_SDR_CF32, SOAPY_SDR_CS16);
+    ok = ok and checkAllPriorities<int8_t, float>(SOAPY_SDR_CS8, SOAPY_SDR_CF32);
+    ok = ok and checkAllPriorities<float, int8_t>(SOAPY_SDR_CF32, SOAPY_SDR_CS8);
+    ok = ok and checkAllPriorities<uint8_t, float>(SOAPY_SDR_CU8, SOAPY_SDR_CF32);
+    ok = ok and checkAllPriorities<float, uint8_t>(SOAPY_SDR_CF32, SOAPY_SDR_CU8);
+    ok = ok and checkAllPriorities<uint8_t, int16_t>(SOAPY_SDR_CS12, SOAPY_SDR_CS16);
+    ok = ok and checkAllPriorities<int16_t, uint8_t>(SOAPY_SDR_CS16, SOAPY_SDR_CS12);
+    ok = ok and checkAllPriorities<uint8_t, float>(SOAPY_SDR_CS12, SOAPY_SDR_CF32);
+    ok = ok and checkAllPriorities<float, uint8_t>(SOAPY_SDR_CF32, SOAPY_SDR_CS12);
+    ok = ok and checkAllPriorities<uint8_t, int8_t>(SOAPY_SDR_CS4, SOAPY_SDR_CS8);
+    ok = ok and checkAllPriorities<int8_t, uint8_t>(SOAPY_SDR_CS8, SOAPY_SDR_CS4);
+    ok = ok and checkAllPriorities<uint8_t, float>(SOAPY_SDR_CS4, SOAPY_SDR_CF32);
+    ok = ok and checkAllPriorities<float, uint8_t>(SOAPY_SDR_CF32, SOAPY_SDR_CS4);
+    ok = ok and checkAllPriorities<double, float>(SOAPY_SDR_F64, SOAPY_SDR_F32);
+    ok = ok and checkAllPriorities<float, double>(SOAPY_SDR_F32, SOAPY_SDR_F64);
+    ok = ok and checkAllPriorities<double, int16_t>(SOAPY_SDR_F64, SOAPY_SDR_S16);
+    ok = ok and checkAllPriorities<int16_t, double>(SOAPY_SDR_S16, SOAPY_SDR_F64);
+    ok = ok and checkAllPriorities<double, int8_t>(SOAPY_SDR_F64, SOAPY_SDR_S8);
+    ok = ok and checkAllPriorities<int8_t, double>(SOAPY_SDR_S8, SOAPY_SDR_F64);
+    ok = ok and checkAllPriorities<double, float>(SOAPY_SDR_CF64, SOAPY_SDR_CF32);
+    ok = ok and checkAllPriorities<float, double>(SOAPY_SDR_CF32, SOAPY_SDR_CF64);
+    ok = ok and checkAllPriorities<double, int16_t>(SOAPY_SDR_CF64, SOAPY_SDR_CS16);
+    ok = ok and checkAllPriorities<int16_t, double>(SOAPY_SDR_CS16, SOAPY_SDR_CF64);
+    ok = ok and checkAllPriorities<double, int8_t>(SOAPY_SDR_CF64, SOAPY_SDR_CS8);
+    ok = ok and checkAllPriorities<int8_t, double>(SOAPY_SDR_CS8, SOAPY_SDR_CF64);
+    ok = ok and checkPackedLayout();
+    ok = ok and checkClipCounts<int16_t>(SOAPY_SDR_CS16, -32768.0, 32767.0);
+    ok = ok and checkClipCounts<int8_t>(SOAPY_SDR_CS8, -128.0, 127.0);
+    ok = ok and checkClipCounts<uint8_t>(SOAPY_SDR_CU8, -128.0, 127.0);
+    ok = ok and checkNotANumber<float, int16_t>(SOAPY_SDR_CF32, SOAPY_SDR_CS16);
+    ok = ok and checkNotANumber<float, int8_t>(SOAPY_SDR_CF32, SOAPY_SDR_CS8);
+    ok = ok and checkNotANumber<float, uint8_t>(SOAPY_SDR_CF32, SOAPY_SDR_CU8);
+    ok = ok and checkNotANumber<double, int16_t>(SOAPY_SDR_CF64, SOAPY_SDR_CS16);
+    ok = ok and checkNotANumber<double, int8_t>(SOAPY_SDR_CF64, SOAPY_SDR_CS8);
+    if (not ok) return EXIT_FAILURE;
+
+    printf("Check converter handles:\n");
+    if (not checkHandles()) return EXIT_FAILURE;
+    if (not checkBuiltinOverlay()) return EXIT_FAILURE;
+    if (not checkConcurrentRegistration()) return EXIT_FAILURE;
+    if (not checkConvertChannels()) return EXIT_FAILURE;
+    if (not checkConverterMatrix("real", SOAPY_SDR_F32, {SOAPY_SDR_F64, SOAPY_SDR_F32, SOAPY_SDR_S32, SOAPY_SDR_U32,
+        SOAPY_SDR_S16, SOAPY_SDR_U16, SOAPY_SDR_S8, SOAPY_SDR_U8})) return EXIT_FAILURE;
+    if (not checkConverterMatrix("complex", SOAPY_SDR_CF32, {SOAPY_SDR_CF64, SOAPY_SDR_CF32, SOAPY_SDR_CS32, SOAPY_SDR_CU32,
+        SOAPY_SDR_CS16, SOAPY_SDR_CU16, SOAPY_SDR_CS12, SOAPY_SDR_CU12,
+        SOAPY_SDR_CS8, SOAPY_SDR_CU8, SOAPY_SDR_CS4, SOAPY_SDR_CU4})) return EXIT_FAILURE;
+    if (not checkInPlace("real", SOAPY_SDR_F32, {SOAPY_SDR_F64, SOAPY_SDR_F32, SOAPY_SDR_S32, SOAPY_SDR_U32,
+        SOAPY_SDR_S16, SOAPY_SDR_U16, SOAPY_SDR_S8, SOAPY_SDR_U8})) return EXIT_FAILURE;
+    if (not checkInPlace("complex", SOAPY_SDR_CF32, {SOAPY_SDR_CF64, SOAPY_SDR_CF32, SOAPY_SDR_CS32, SOAPY_SDR_CU32,
+        SOAPY_SDR_CS16, SOAPY_SDR_CU16, SOAPY_SDR_CS12, SOAPY_SDR_CU12,
+        SOAPY_SDR_CS8, SOAPY_SDR_CU8, SOAPY_SDR_CS4, SOAPY_SDR_CU4})) return EXIT_FAILURE;
+    if (not checkConverterPaths()) return EXIT_FAILURE;
+
+    printf("Check streaming stores:\n");
+    if (not checkStreamingStores<int16_t>(SOAPY_SDR_CS16)) return EXIT_FAILURE;
+    if (not checkStreamingStores<int8_t>(SOAPY_SDR_CS8)) return EXIT_FAILURE;
+    if (not checkStreamingStores<uint8_t>(SOAPY_SDR_CU8)) return EXIT_FAILURE;
+    if (not checkStoreModes()) return EXIT_FAILURE;
+
+    printf("Check correction converters:\n");
+    if (not checkCorrection<int16_t>(SOAPY_SDR_CS16)) return EXIT_FAILURE;
+    if (not checkCorrection<int8_t>(SOAPY_SDR_CS8)) return EXIT_FAILURE;
+    if (not checkCorrection<uint8_t>(SOAPY_SDR_CU8)) return EXIT_FAILURE;
+    if (not checkCorrection<float>(SOAPY_SDR_CF32)) return EXIT_FAILURE;
+    if (not checkDCTracking()) return EXIT_FAILURE;
+
+    printf("Check stats converters:\n");
+    if (not checkStats<int16_t, float>(SOAPY_SDR_CS16, SOAPY_SDR_CF32, 32768.0)) return EXIT_FAILURE;
+    if (not checkStats<int8_t, float>(SOAPY_SDR_CS8, SOAPY_SDR_CF32, 128.0)) return EXIT_FAILURE;
+    if (not checkStats<uint8_t, float>(SOAPY_SDR_CU8, SOAPY_SDR_CF32, 128.0)) return EXIT_FAILURE;
+    if (not checkStats<float, int16_t>(SOAPY_SDR_CF32, SOAPY_SDR_CS16, 32768.0)) return EXIT_FAILURE;
+    if (not checkStats<float, int8_t>(SOAPY_SDR_CF32, SOAPY_SDR_CS8, 128.0)) return EXIT_FAILURE;
+
+    printf("Check auto-tuning:\n");
+    if (not checkAutoTuning()) return EXIT_FAILURE;
+
+    printf("Check channel converters:\n");
+    if (not checkChannelConverters()) return EXIT_FAILURE;
+
+    printf("DONE!\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,309 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/ConvertingStream.hpp>
+#include <SoapySDR/StreamRing.hpp>
+#include <SoapySDR/Formats.hpp>
+#include <SoapySDR/Time.hpp>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+/***********************************************************************
+ * A 12-bit device with a native CS16 stream.
+ * With direct access, buffers pass through stream rings,
+ * otherwise readStream() and writeStream() copy one MTU at a time.
+ **********************************************************************/
+class NativeDevice : public SoapySDR::Device
+{
+public:
+    NativeDevice(const bool direct):
+        direct(direct),
+        rxRing(4, 64, sizeof(int16_t)*2),
+        txRing(4, 64, sizeof(int16_t)*2),
+        numClosed(0){}
+
+    std::string getNativeStreamFormat(const int, const size_t, double &fullScale) const
+    {
+        fullScale = 2048;
+        return SOAPY_SDR_CS16;
+    }
+
+    SoapySDR::Stream *setupStream(const int, const std::string &format, const std::vector<size_t> &, const SoapySDR::Kwargs &args)
+    {
+        setupFormat = format;
+        setupArgs = args;
+        return reinterpret_cast<SoapySDR::Stream *>(this);
+    }
+
+    void closeStream(SoapySDR::Stream *)
+    {
+        numClosed++;
+    }
+
+    size_t getStreamMTU(SoapySDR::Stream *) const
+    {
+        return 16;
+    }
+
+    double getSampleRate(const int, const size_t) const
+    {
+        return 1e6;
+    }
+
+    size_t getNumDirectAccessBuffers(SoapySDR::Stream *)
+    {
+        return direct?rxRing.getNumBuffs():0;
+    }
+
+    int acquireReadBuffer(SoapySDR::Stream *, size_t &handle, const void **buffs, int &flags, long long &timeNs, const long timeoutUs)
+    {
+        return rxRing.acquireReadBuffer(handle, buffs, flags, timeNs, timeoutUs);
+    }
+
+    void releaseReadBuffer(SoapySDR::Stream *, const size_t handle)
+    {
+        rxRing.releaseReadBuffer(handle);
+    }
+
+    int acquireWriteBuffer(SoapySDR::Stream *, size_t &handle, void **buffs, const long timeoutUs)
+    {
+        return txRing.acquireWriteBuffer(handle, buffs, timeoutUs);
+    }
+
+    void releaseWriteBuffer(SoapySDR::Stream *, const size_t handle, const size_t numElems, int &flags, const long long timeNs)
+    {
+        txRing.releaseWriteBuffer(handle, numElems, flags, timeNs);
+    }
+
+    int readStream(SoapySDR::Stream *, void * const *buffs, const size_t numElems, int &flags, long long &timeNs, const long)
+    {
+        auto out = static_cast<int16_t *>(buffs[0]);
+        for (size_t i = 0; i < numElems*2; i++) out[i] = int16_t(i*16);
+        flags = SOAPY_SDR_HAS_TIME;
+        timeNs = 1000;
+        return int(numElems);
+    }
+
+    int writeStream(SoapySDR::Stream *, const void * const *buffs, const size_t numElems, int &, const long long, const long)
+    {
+        auto in = static_cast<const int16_t *>(buffs[0]);
+        written.assign(in, in + numElems*2);
+        return int(numElems);
+    }
+
+    //! Release one receive buffer of 64 elements with a ramp
+    void produce(const int flags, const long long timeNs)
+    {
+        size_t handle(0);
+        void *buffs[1];
+        rxRing.acquireWriteBuffer(handle, buffs, 0);
+        auto out = static_cast<int16_t *>(buffs[0]);
+        for (size_t i = 0; i < 64*2; i++) out[i] = int16_t(i*16);
+        rxRing.releaseWriteBuffer(handle, 64, flags, timeNs);
+    }
+
+    bool direct;
+    SoapySDR::StreamRing rxRing;
+    SoapySDR::StreamRing txRing;
+    std::string setupFormat;
+    SoapySDR::Kwargs setupArgs;
+    std::vector<int16_t> written;
+    int numClosed;
+};
+
+//! The ramp of NativeDevice in CF32 with the 12-bit full scale
+static bool checkRamp(const std::complex<float> *buff, const size_t numElems, const size_t offset)
+{
+    for (size_t i = 0; i < numElems; i++)
+    {
+        const size_t k = (offset+i)*2;
+        const std::complex<float> expected(k*16/2048.0f, (k+1)*16/2048.0f);
+        if (std::abs(buff[i] - expected) > 1e-6f)
+        {
+            printf("FAIL: element %d is (%f, %f)\n", int(offset+i), buff[i].real(), buff[i].imag());
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool checkReadDirect(void)
+{
+    NativeDevice device(true);
+    {
+        SoapySDR::ConvertingStream stream(&device, SOAPY_SDR_RX, SOAPY_SDR_CF32);
+        if (device.setupFormat != SOAPY_SDR_CS16 or not stream.usesDirectAccess())
+        {
+            printf("FAIL: setup format %s, direct access %d\n", device.setupFormat.c_str(), int(stream.usesDirectAccess()));
+            return false;
+        }
+
+        //a buffer of 64 elements is read as two fragments
+        device.produce(SOAPY_SDR_HAS_TIME | SOAPY_SDR_END_BURST, 5000);
+        std::vector<std::complex<float>> buff(40);
+        void *buffs[1] = {buff.data()};
+        int flags(0);
+        long long timeNs(0);
+        int ret = stream.readStream(buffs, buff.size(), flags, timeNs, 0);
+        if (ret != 40 or flags != (SOAPY_SDR_HAS_TIME | SOAPY_SDR_MORE_FRAGMENTS) or timeNs != 5000)
+        {
+            printf("FAIL: first fragment ret %d, flags %d, time %lld\n", ret, flags, timeNs);
+            return false;
+        }
+        if (not checkRamp(buff.data(), 40, 0)) return false;
+
+        ret = stream.readStream(buffs, buff.size(), flags, timeNs, 0);
+        if (ret != 24 or flags != (SOAPY_SDR_HAS_TIME | SOAPY_SDR_END_BURST) or timeNs != 5000 + SoapySDR::ticksToTimeNs(40, 1e6))
+        {
+            printf("FAIL: last fragment ret %d, flags %d, time %lld\n", ret, flags, timeNs);
+            return false;
+        }
+        if (not checkRamp(buff.data(), 24, 40)) return false;
+
+        //every buffer was released back to the device
+        ret = stream.readStream(buffs, buff.size(), flags, timeNs, 0);
+        if (ret != SOAPY_SDR_TIMEOUT)
+        {
+            printf("FAIL: empty readStream() = %d\n", ret);
+            return false;
+        }
+    }
+    if (device.numClosed != 1)
+    {
+        printf("FAIL: closeStream() called %d times\n", device.numClosed);
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkWriteDirect(void)
+{
+    NativeDevice device(true);
+    SoapySDR::ConvertingStream stream(&device, SOAPY_SDR_TX, SOAPY_SDR_CF32);
+
+    //a write larger than the device buffer only carries the end of burst on the last element
+    std::vector<std::complex<float>> buff(100, std::complex<float>(0.5f, -0.25f));
+    const void *buffs[1] = {buff.data()};
+    int flags(SOAPY_SDR_END_BURST);
+    int ret = stream.writeStream(buffs, buff.size(), flags, 0, 0);
+    if (ret != 64 or flags != 0)
+    {
+        printf("FAIL: writeStream() = %d, flags %d\n", ret, flags);
+        return false;
+    }
+
+    size_t handle(0);
+    const void *rbuffs[1] = {nullptr};
+    long long timeNs(0);
+    ret = device.txRing.acquireReadBuffer(handle, rbuffs, flags, timeNs, 0);
+    auto native = static_cast<const int16_t *>(rbuffs[0]);
+    if (ret != 64 or native[0] != 1024 or native[1] != -512 or native[126] != 1024 or native[127] != -512)
+    {
+        printf("FAIL: device buffer %d elements, first (%d, %d)\n", ret, native[0], native[1]);
+        return false;
+    }
+    device.txRing.releaseReadBuffer(handle);
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkScratch(void)
+{
+    NativeDevice device(false);
+
+    //without direct access each call converts up to one MTU
+    SoapySDR::ConvertingStream rxStream(&device, SOAPY_SDR_RX, SOAPY_SDR_CF32);
+    std::vector<std::complex<float>> buff(40);
+    void *buffs[1] = {buff.data()};
+    int flags(0);
+    long long timeNs(0);
+    int ret = rxStream.readStream(buffs, buff.size(), flags, timeNs);
+    if (rxStream.usesDirectAccess() or ret != 16 or flags != SOAPY_SDR_HAS_TIME or timeNs != 1000)
+    {
+        printf("FAIL: readStream() = %d, flags %d, time %lld\n", ret, flags, timeNs);
+        return false;
+    }
+    if (not checkRamp(buff.data(), 16, 0)) return false;
+
+    SoapySDR::ConvertingStream txStream(&device, SOAPY_SDR_TX, SOAPY_SDR_CF32);
+    const void *cbuffs[1] = {buff.data()};
+    flags = 0;
+    ret = txStream.writeStream(cbuffs, 8, flags);
+    if (ret != 8 or device.written.size() != 16 or device.written[2] != 32 or device.written[3] != 48)
+    {
+        printf("FAIL: writeStream() = %d\n", ret);
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkOptions(void)
+{
+    NativeDevice device(false);
+
+    //the native format passes straight through
+    SoapySDR::ConvertingStream native(&device, SOAPY_SDR_RX, SOAPY_SDR_CS16);
+    std::vector<int16_t> buff(2*100);
+    void *buffs[1] = {buff.data()};
+    int flags(0);
+    long long timeNs(0);
+    int ret = native.readStream(buffs, 100, flags, timeNs);
+    if (ret != 100 or native.getNativeFormat() != SOAPY_SDR_CS16)
+    {
+        printf("FAIL: pass through readStream() = %d\n", ret);
+        return false;
+    }
+
+    //the scaler overrides the full scale, and is not passed to the device
+    SoapySDR::Kwargs args;
+    args["scaler"] = "1.0";
+    args["other"] = "value";
+    SoapySDR::ConvertingStream scaled(&device, SOAPY_SDR_RX, SOAPY_SDR_CF32, std::vector<size_t>(), args);
+    if (scaled.getScaler() != 1.0 or device.setupArgs.count("scaler") != 0 or device.setupArgs.count("other") != 1)
+    {
+        printf("FAIL: scaler %f, device args %d\n", scaled.getScaler(), int(device.setupArgs.size()));
+        return false;
+    }
+
+    bool threw(false);
+    try {SoapySDR::ConvertingStream(&device, SOAPY_SDR_RX, "NOT_A_FORMAT");}
+    catch (const std::runtime_error &) {threw = true;}
+    if (not threw)
+    {
+        printf("FAIL: unknown format accepted\n");
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+int main(void)
+{
+    bool ok(true);
+
+    printf("Check direct read... ");
+    ok = ok and checkReadDirect();
+
+    printf("Check direct write... ");
+    ok = ok and checkWriteDirect();
+
+    printf("Check scratch buffer... ");
+    ok = ok and checkScratch();
+
+    printf("Check options... ");
+    ok = ok and checkOptions();
+
+    printf("DONE!\n");
+    return ok?EXIT_SUCCESS:EXIT_FAILURE;
+}
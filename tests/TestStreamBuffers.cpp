@@ -0,0 +1,163 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/StreamBuffers.hpp>
+#include <SoapySDR/Device.h>
+#include <SoapySDR/Formats.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+/***********************************************************************
+ * A device with an odd MTU that may hint its DMA alignment
+ **********************************************************************/
+class MTUDevice : public SoapySDR::Device
+{
+public:
+    MTUDevice(const std::string &alignment = ""):
+        alignment(alignment){}
+
+    size_t getStreamMTU(SoapySDR::Stream *) const
+    {
+        return 1000;
+    }
+
+    SoapySDR::ArgInfoList getStreamArgsInfo(const int, const size_t) const
+    {
+        SoapySDR::ArgInfoList infos;
+        if (alignment.empty()) return infos;
+        SoapySDR::ArgInfo info;
+        info.key = "alignment";
+        info.value = alignment;
+        info.type = SoapySDR::ArgInfo::INT;
+        infos.push_back(info);
+        return infos;
+    }
+
+    const std::string alignment;
+};
+
+//! Check that every buffer is aligned, separate, and writable
+static bool checkBuffers(void **buffs, const size_t numBuffs, const size_t buffSize, const size_t alignment)
+{
+    for (size_t i = 0; i < numBuffs; i++)
+    {
+        if ((uintptr_t(buffs[i]) % alignment) != 0)
+        {
+            printf("FAIL: buffer %d not aligned to %d\n", int(i), int(alignment));
+            return false;
+        }
+        if (i != 0 and size_t((char *)buffs[i] - (char *)buffs[i-1]) < buffSize)
+        {
+            printf("FAIL: buffers %d and %d overlap\n", int(i-1), int(i));
+            return false;
+        }
+        std::memset(buffs[i], int(i), buffSize);
+    }
+    for (size_t i = 0; i < numBuffs; i++)
+    {
+        if (((unsigned char *)buffs[i])[buffSize-1] != i)
+        {
+            printf("FAIL: buffer %d overwritten\n", int(i));
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool checkAlloc(const SoapySDR::Kwargs &args, const std::string &hint, const size_t alignment)
+{
+    MTUDevice device(hint);
+    void **buffs = SoapySDR::allocStreamBuffers(&device, nullptr, SOAPY_SDR_RX, SOAPY_SDR_CS16, 4, args);
+    const bool ok = checkBuffers(buffs, 4, 1000*4, alignment);
+    SoapySDR::freeStreamBuffers(buffs);
+    if (ok) printf("OK\n");
+    return ok;
+}
+
+static bool checkErrors(void)
+{
+    MTUDevice device;
+    SoapySDR::freeStreamBuffers(nullptr);
+
+    bool threw(false);
+    try {SoapySDR::allocStreamBuffers(&device, nullptr, SOAPY_SDR_RX, SOAPY_SDR_CS16, 0);}
+    catch (const std::invalid_argument &) {threw = true;}
+    if (not threw)
+    {
+        printf("FAIL: zero buffers accepted\n");
+        return false;
+    }
+
+    SoapySDR::Kwargs args;
+    args["alignment"] = "100";
+    threw = false;
+    try {SoapySDR::allocStreamBuffers(&device, nullptr, SOAPY_SDR_RX, SOAPY_SDR_CS16, 1, args);}
+    catch (const std::invalid_argument &) {threw = true;}
+    if (not threw)
+    {
+        printf("FAIL: alignment of 100 accepted\n");
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkAllocC(void)
+{
+    MTUDevice device;
+    auto cdevice = reinterpret_cast<SoapySDRDevice *>(&device);
+    void **buffs = SoapySDRDevice_allocStreamBuffers(cdevice, nullptr, SOAPY_SDR_TX, SOAPY_SDR_CF32, 2, nullptr);
+    if (buffs == nullptr or not checkBuffers(buffs, 2, 1000*8, 64))
+    {
+        printf("FAIL: SoapySDRDevice_allocStreamBuffers() %s\n", SoapySDRDevice_lastError());
+        return false;
+    }
+    SoapySDRDevice_freeStreamBuffers(buffs);
+
+    //errors are reported through the last error
+    buffs = SoapySDRDevice_allocStreamBuffers(cdevice, nullptr, SOAPY_SDR_TX, SOAPY_SDR_CF32, 0, nullptr);
+    if (buffs != nullptr or std::strlen(SoapySDRDevice_lastError()) == 0)
+    {
+        printf("FAIL: zero buffers accepted by C API\n");
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+int main(void)
+{
+    bool ok(true);
+    SoapySDR::Kwargs args;
+
+    printf("Check default alignment... ");
+    ok = ok and checkAlloc(args, "", 64);
+
+    printf("Check driver alignment hint... ");
+    ok = ok and checkAlloc(args, "4096", 4096);
+
+    args["alignment"] = "256";
+    printf("Check alignment arg... ");
+    ok = ok and checkAlloc(args, "4096", 256);
+
+    //huge pages and locking fall back when the system declines them
+    args.clear();
+    args["hugePages"] = "true";
+    args["lock"] = "true";
+    printf("Check huge pages and lock... ");
+    ok = ok and checkAlloc(args, "", 64);
+
+    printf("Check errors... ");
+    ok = ok and checkErrors();
+
+    printf("Check C API... ");
+    ok = ok and checkAllocC();
+
+    printf("DONE!\n");
+    return ok?EXIT_SUCCESS:EXIT_FAILURE;
+}
@@ -0,0 +1,341 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/Device.hpp>
+#include <SoapySDR/Device.h>
+#include <SoapySDR/StreamRing.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/***********************************************************************
+ * A device with direct buffer access over a stream ring,
+ * filled by a producer thread like a driver's transport callback.
+ **********************************************************************/
+class RingDevice : public SoapySDR::Device
+{
+public:
+    RingDevice(void):
+        ring(8, 16, 4){}
+
+    size_t getNumChannels(const int) const
+    {
+        return 1;
+    }
+
+    size_t getNumDirectAccessBuffers(SoapySDR::Stream *)
+    {
+        return ring.getNumBuffs();
+    }
+
+    int acquireReadBuffer(SoapySDR::Stream *, size_t &handle, const void **buffs, int &flags, long long &timeNs, const long timeoutUs)
+    {
+        return ring.acquireReadBuffer(handle, buffs, flags, timeNs, timeoutUs);
+    }
+
+    void releaseReadBuffer(SoapySDR::Stream *, const size_t handle)
+    {
+        ring.releaseReadBuffer(handle);
+    }
+
+    void produce(const size_t numBuffs)
+    {
+        for (size_t i = 0; i < numBuffs;)
+        {
+            size_t handle(0);
+            void *buffs[1];
+            if (ring.acquireWriteBuffer(handle, buffs) < 0) continue;
+            std::memcpy(buffs[0], &i, sizeof(i));
+            ring.releaseWriteBuffer(handle, 16, SOAPY_SDR_HAS_TIME, (long long)(i));
+            i++;
+        }
+    }
+
+    SoapySDR::StreamRing ring;
+};
+
+static bool checkNotSupported(void)
+{
+    //the generic implementation requires direct buffer access
+    struct NoAccessDevice : SoapySDR::Device {} noAccess;
+    const int setRet = noAccess.setStreamCallback(nullptr, [](SoapySDR::Stream *, const size_t, const void * const *, const int, const int, const long long){});
+    if (setRet != SOAPY_SDR_NOT_SUPPORTED)
+    {
+        printf("FAIL: setStreamCallback() without direct access = %d\n", setRet);
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkCallback(void)
+{
+    const size_t numBuffs(10000);
+    RingDevice device;
+    std::atomic<size_t> numDelivered(0);
+    std::atomic<bool> ok(true);
+    int ret = device.setStreamCallback(nullptr, [&](SoapySDR::Stream *stream, const size_t handle, const void * const *buffs, const int numElems, const int flags, const long long timeNs)
+    {
+        size_t seq(0);
+        std::memcpy(&seq, buffs[0], sizeof(seq));
+        if (numElems != 16 or flags != SOAPY_SDR_HAS_TIME or seq != numDelivered or timeNs != (long long)(seq)) ok = false;
+        numDelivered++;
+        device.releaseReadBuffer(stream, handle);
+    });
+    if (ret != 0)
+    {
+        printf("FAIL: setStreamCallback() = %d\n", ret);
+        return false;
+    }
+
+    device.produce(numBuffs);
+    const auto exitTime = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (numDelivered != numBuffs and std::chrono::steady_clock::now() < exitTime)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ret = device.setStreamCallback(nullptr, SoapySDR::StreamCallback());
+    if (ret != 0 or numDelivered != numBuffs or not ok)
+    {
+        printf("FAIL: delivered %d of %d buffers\n", int(numDelivered), int(numBuffs));
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+struct CallbackCounter
+{
+    RingDevice *device;
+    std::atomic<size_t> numDelivered;
+};
+
+static void countCallback(SoapySDRStream *stream, const size_t handle, const void * const *, const int ret, const int, const long long, void *userData)
+{
+    auto counter = static_cast<CallbackCounter *>(userData);
+    if (ret < 0) return;
+    counter->numDelivered++;
+    SoapySDRDevice_releaseReadBuffer(reinterpret_cast<SoapySDRDevice *>(counter->device), stream, handle);
+}
+
+static bool checkCallbackC(void)
+{
+    const size_t numBuffs(1000);
+    RingDevice device;
+    CallbackCounter counter;
+    counter.device = &device;
+    counter.numDelivered = 0;
+
+    auto cdevice = reinterpret_cast<SoapySDRDevice *>(&device);
+    const int ret = SoapySDRDevice_setStreamCallback(cdevice, nullptr, &countCallback, &counter);
+    device.produce(numBuffs);
+    const auto exitTime = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (counter.numDelivered != numBuffs and std::chrono::steady_clock::now() < exitTime)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const int stopRet = SoapySDRDevice_setStreamCallback(cdevice, nullptr, nullptr, nullptr);
+    if (ret != 0 or stopRet != 0 or counter.numDelivered != numBuffs)
+    {
+        printf("FAIL: C callback delivered %d of %d buffers\n", int(counter.numDelivered), int(numBuffs));
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkStopFromCallback(void)
+{
+    //the callback stops its own delivery without waiting on itself
+    RingDevice device;
+    std::atomic<size_t> numDelivered(0);
+    std::atomic<int> stopRet(-1);
+    device.setStreamCallback(nullptr, [&](SoapySDR::Stream *stream, const size_t handle, const void * const *, const int, const int, const long long)
+    {
+        numDelivered++;
+        device.releaseReadBuffer(stream, handle);
+        stopRet = device.setStreamCallback(stream, SoapySDR::StreamCallback());
+    });
+
+    device.produce(4);
+    const auto exitTime = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (stopRet == -1 and std::chrono::steady_clock::now() < exitTime)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (stopRet != 0 or numDelivered != 1)
+    {
+        printf("FAIL: stop from callback = %d, delivered %d buffers\n", int(stopRet), int(numDelivered));
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+/***********************************************************************
+ * A device whose stream has failed: every acquire returns an error
+ **********************************************************************/
+class FailedDevice : public RingDevice
+{
+public:
+    int acquireReadBuffer(SoapySDR::Stream *, size_t &, const void **, int &, long long &, const long)
+    {
+        return SOAPY_SDR_STREAM_ERROR;
+    }
+};
+
+static bool checkErrorBackoff(void)
+{
+    //a persistent error is delivered at a decreasing rate
+    FailedDevice device;
+    std::atomic<size_t> numErrors(0);
+    device.setStreamCallback(nullptr, [&](SoapySDR::Stream *, const size_t, const void * const *, const int ret, const int, const long long)
+    {
+        if (ret == SOAPY_SDR_STREAM_ERROR) numErrors++;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    device.setStreamCallback(nullptr, SoapySDR::StreamCallback());
+    if (numErrors == 0 or numErrors > 20)
+    {
+        printf("FAIL: %d errors delivered in 300 ms\n", int(numErrors));
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkCloseStream(void)
+{
+    //the default closeStream() stops the delivery
+    RingDevice device;
+    std::atomic<size_t> numDelivered(0);
+    device.setStreamCallback(nullptr, [&](SoapySDR::Stream *stream, const size_t handle, const void * const *, const int, const int, const long long)
+    {
+        numDelivered++;
+        device.releaseReadBuffer(stream, handle);
+    });
+    device.closeStream(nullptr);
+    device.produce(4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (numDelivered != 0)
+    {
+        printf("FAIL: delivered %d buffers after closeStream()\n", int(numDelivered));
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+/***********************************************************************
+ * A device that counts the acquire calls of the delivery thread
+ **********************************************************************/
+static std::atomic<size_t> numAcquires(0);
+
+class CountingDevice : public SoapySDR::Device
+{
+public:
+    size_t getNumDirectAccessBuffers(SoapySDR::Stream *)
+    {
+        return 1;
+    }
+
+    int acquireReadBuffer(SoapySDR::Stream *, size_t &, const void **, int &, long long &, const long)
+    {
+        numAcquires++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return SOAPY_SDR_TIMEOUT;
+    }
+};
+
+static bool checkDestroy(void)
+{
+    //the delivery is stopped before the device is deleted, no thread outlives it
+    auto device = new CountingDevice();
+    device->setStreamCallback(nullptr, [](SoapySDR::Stream *, const size_t, const void * const *, const int, const int, const long long){});
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    device->setStreamCallback(nullptr, SoapySDR::StreamCallback());
+    const size_t numAfterStop = numAcquires;
+    delete device;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (numAfterStop == 0 or numAcquires != numAfterStop)
+    {
+        printf("FAIL: %d acquires after the delivery was stopped\n", int(numAcquires - numAfterStop));
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkConcurrentSet(void)
+{
+    //concurrent calls replace the delivery without orphaning a thread
+    CountingDevice device;
+    std::vector<std::thread> setters;
+    for (size_t i = 0; i < 4; i++)
+    {
+        setters.emplace_back([&device]()
+        {
+            for (size_t j = 0; j < 20; j++)
+            {
+                device.setStreamCallback(nullptr, [](SoapySDR::Stream *, const size_t, const void * const *, const int, const int, const long long){});
+            }
+        });
+    }
+    for (auto &setter : setters) setter.join();
+    device.setStreamCallback(nullptr, SoapySDR::StreamCallback());
+    const size_t numAfterStop = numAcquires;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (numAcquires != numAfterStop)
+    {
+        printf("FAIL: %d acquires after the delivery was stopped\n", int(numAcquires - numAfterStop));
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+int main(void)
+{
+    bool ok(true);
+
+    printf("Check not supported... ");
+    ok = ok and checkNotSupported();
+
+    printf("Check callback... ");
+    ok = ok and checkCallback();
+
+    printf("Check C callback... ");
+    ok = ok and checkCallbackC();
+
+    printf("Check stop from callback... ");
+    ok = ok and checkStopFromCallback();
+
+    printf("Check error backoff... ");
+    ok = ok and checkErrorBackoff();
+
+    printf("Check close stream... ");
+    ok = ok and checkCloseStream();
+
+    printf("Check destroy... ");
+    ok = ok and checkDestroy();
+
+    printf("Check concurrent set... ");
+    ok = ok and checkConcurrentSet();
+
+    printf("DONE!\n");
+    return ok?EXIT_SUCCESS:EXIT_FAILURE;
+}
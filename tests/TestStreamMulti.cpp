@@ -0,0 +1,192 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/Device.hpp>
+#include <SoapySDR/Device.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/***********************************************************************
+ * A device without a native batched implementation:
+ * the stream has a number of packets ready, then times out.
+ * Writes accept up to a number of elements, then time out.
+ * A one-shot error can be injected into one call.
+ **********************************************************************/
+class MockDevice : public SoapySDR::Device
+{
+public:
+    MockDevice(void):
+        packetsReady(0),
+        elemsWritable(0),
+        numCalls(0),
+        numWaits(0),
+        errorCall(0),
+        errorCode(0){}
+
+    int readStream(SoapySDR::Stream *, void * const *buffs, const size_t numElems, int &flags, long long &timeNs, const long timeoutUs)
+    {
+        numCalls++;
+        if (timeoutUs != 0) numWaits++;
+        if (numCalls == errorCall) return errorCode;
+        if (packetsReady == 0) return SOAPY_SDR_TIMEOUT;
+        packetsReady--;
+        static_cast<int *>(buffs[0])[0] = numCalls;
+        flags = SOAPY_SDR_HAS_TIME;
+        timeNs = 1000*numCalls;
+        return int(numElems/2);
+    }
+
+    int writeStream(SoapySDR::Stream *, const void * const *, const size_t numElems, int &flags, const long long, const long timeoutUs)
+    {
+        numCalls++;
+        if (timeoutUs != 0) numWaits++;
+        if (numCalls == errorCall) return errorCode;
+        if (elemsWritable == 0) return SOAPY_SDR_TIMEOUT;
+        const size_t n = std::min(numElems, elemsWritable);
+        elemsWritable -= n;
+        flags = 0;
+        return int(n);
+    }
+
+    size_t packetsReady;
+    size_t elemsWritable;
+    int numCalls;
+    int numWaits;
+    int errorCall;
+    int errorCode;
+};
+
+static bool checkReadStreamMulti(void)
+{
+    MockDevice device;
+    std::vector<int> data(4*16);
+    std::vector<void *> ptrs(4);
+    std::vector<SoapySDR::StreamPacket> packets(4);
+    for (size_t i = 0; i < packets.size(); i++)
+    {
+        ptrs[i] = data.data() + i*16;
+        packets[i].buffs = &ptrs[i];
+        packets[i].numElems = 16;
+        packets[i].flags = 0;
+        packets[i].timeNs = 0;
+    }
+
+    //nothing ready: the first packet reports the timeout
+    int ret = device.readStreamMulti(nullptr, packets.data(), packets.size(), 1000);
+    if (ret != SOAPY_SDR_TIMEOUT or packets[0].ret != SOAPY_SDR_TIMEOUT)
+    {
+        printf("FAIL: empty readStreamMulti() = %d\n", ret);
+        return false;
+    }
+
+    //three packets ready: only the first read waits
+    device.packetsReady = 3;
+    device.numCalls = 0;
+    device.numWaits = 0;
+    ret = device.readStreamMulti(nullptr, packets.data(), packets.size(), 1000);
+    if (ret != 3 or device.numWaits != 1 or device.numCalls != 4)
+    {
+        printf("FAIL: readStreamMulti() = %d, calls %d, waits %d\n", ret, device.numCalls, device.numWaits);
+        return false;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        if (packets[i].ret != 8 or packets[i].flags != SOAPY_SDR_HAS_TIME or
+            packets[i].timeNs != 1000*(i+1) or data[i*16] != i+1)
+        {
+            printf("FAIL: packet %d ret %d, flags %d, time %lld\n", i, packets[i].ret, packets[i].flags, packets[i].timeNs);
+            return false;
+        }
+    }
+
+    //an overflow on the second packet stops the call and is kept in its descriptor
+    device.packetsReady = 3;
+    device.numCalls = 0;
+    device.errorCall = 2;
+    device.errorCode = SOAPY_SDR_OVERFLOW;
+    ret = device.readStreamMulti(nullptr, packets.data(), packets.size(), 1000);
+    if (ret != 1 or packets[0].ret != 8 or packets[1].ret != SOAPY_SDR_OVERFLOW)
+    {
+        printf("FAIL: overflow readStreamMulti() = %d, packet 2 ret %d\n", ret, packets[1].ret);
+        return false;
+    }
+    device.errorCall = 0;
+
+    //the C API uses the same descriptors
+    device.packetsReady = 2;
+    ret = SoapySDRDevice_readStreamMulti(reinterpret_cast<SoapySDRDevice *>(&device), nullptr,
+        reinterpret_cast<SoapySDRStreamPacket *>(packets.data()), packets.size(), 1000);
+    if (ret != 2 or packets[1].ret != 8)
+    {
+        printf("FAIL: SoapySDRDevice_readStreamMulti() = %d\n", ret);
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkWriteStreamMulti(void)
+{
+    MockDevice device;
+    std::vector<int> data(16);
+    void *ptrs[1] = {data.data()};
+    std::vector<SoapySDR::StreamPacket> packets(4);
+    for (auto &packet : packets)
+    {
+        packet.buffs = ptrs;
+        packet.numElems = 16;
+        packet.flags = SOAPY_SDR_HAS_TIME;
+        packet.timeNs = 0;
+    }
+
+    //space for two and a half packets: the call stops at the partial packet
+    device.elemsWritable = 40;
+    int ret = device.writeStreamMulti(nullptr, packets.data(), packets.size(), 1000);
+    if (ret != 3 or packets[0].ret != 16 or packets[1].ret != 16 or packets[2].ret != 8 or device.numWaits != 1)
+    {
+        printf("FAIL: writeStreamMulti() = %d, rets %d %d %d\n", ret, packets[0].ret, packets[1].ret, packets[2].ret);
+        return false;
+    }
+
+    //an underflow on the second packet stops the call and is kept in its descriptor
+    device.elemsWritable = 64;
+    device.numCalls = 0;
+    device.errorCall = 2;
+    device.errorCode = SOAPY_SDR_UNDERFLOW;
+    ret = device.writeStreamMulti(nullptr, packets.data(), packets.size(), 1000);
+    if (ret != 1 or packets[0].ret != 16 or packets[1].ret != SOAPY_SDR_UNDERFLOW)
+    {
+        printf("FAIL: underflow writeStreamMulti() = %d, packet 2 ret %d\n", ret, packets[1].ret);
+        return false;
+    }
+    device.errorCall = 0;
+    device.elemsWritable = 0;
+
+    //no space: the first packet reports the timeout
+    ret = device.writeStreamMulti(nullptr, packets.data(), packets.size(), 1000);
+    if (ret != SOAPY_SDR_TIMEOUT)
+    {
+        printf("FAIL: full writeStreamMulti() = %d\n", ret);
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+int main(void)
+{
+    bool ok(true);
+
+    printf("Check readStreamMulti... ");
+    ok = ok and checkReadStreamMulti();
+
+    printf("Check writeStreamMulti... ");
+    ok = ok and checkWriteStreamMulti();
+
+    printf("DONE!\n");
+    return ok?EXIT_SUCCESS:EXIT_FAILURE;
+}
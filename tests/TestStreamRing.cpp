@@ -0,0 +1,205 @@
+// Copyright (c) 2021-2021 Josh Blum
+// SPDX-License-Identifier: BSL-1.0
+
+#include <SoapySDR/StreamRing.hpp>
+#include <SoapySDR/Constants.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+static bool checkConfiguration(void)
+{
+    SoapySDR::StreamRing ring(5, 25, 4, 2);
+    if (ring.getNumBuffs() != 8 or ring.getNumElems() != 25 or ring.getElemSize() != 4 or
+        ring.getBuffSize() != 100 or ring.getNumChans() != 2)
+    {
+        printf("FAIL: configuration %d buffs, %d elems, %d bytes, %d chans\n",
+            int(ring.getNumBuffs()), int(ring.getNumElems()), int(ring.getBuffSize()), int(ring.getNumChans()));
+        return false;
+    }
+
+    //every channel buffer is aligned and separate from its neighbors
+    for (size_t handle = 0; handle < ring.getNumBuffs(); handle++)
+    {
+        void *buffs[2];
+        ring.getBuffers(handle, buffs);
+        for (size_t ch = 0; ch < 2; ch++)
+        {
+            if ((uintptr_t(buffs[ch]) % 64) != 0)
+            {
+                printf("FAIL: buffer %d chan %d not aligned\n", int(handle), int(ch));
+                return false;
+            }
+        }
+        if (size_t((char *)buffs[1] - (char *)buffs[0]) < ring.getBuffSize())
+        {
+            printf("FAIL: buffer %d channels overlap\n", int(handle));
+            return false;
+        }
+    }
+
+    bool threw(false);
+    try {SoapySDR::StreamRing(0, 100, 1);}
+    catch (const std::invalid_argument &) {threw = true;}
+    if (not threw)
+    {
+        printf("FAIL: zero buffers accepted\n");
+        return false;
+    }
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkSingleThread(void)
+{
+    SoapySDR::StreamRing ring(4, 16, 4);
+    size_t handle(0);
+    void *wbuffs[1];
+    const void *rbuffs[1];
+    int flags(0);
+    long long timeNs(0);
+
+    //an empty ring times out for the consumer
+    const auto t0 = std::chrono::steady_clock::now();
+    int ret = ring.acquireReadBuffer(handle, rbuffs, flags, timeNs, 2000);
+    const auto elapsed = std::chrono::steady_clock::now() - t0;
+    if (ret != SOAPY_SDR_TIMEOUT or elapsed < std::chrono::microseconds(2000))
+    {
+        printf("FAIL: empty ring acquireReadBuffer() = %d\n", ret);
+        return false;
+    }
+
+    //fill the ring, then the producer times out
+    for (size_t i = 0; i < ring.getNumBuffs(); i++)
+    {
+        ret = ring.acquireWriteBuffer(handle, wbuffs, 0);
+        //the capacity is reported in elements like Device::acquireWriteBuffer()
+        if (ret != int(ring.getNumElems()) or handle != i)
+        {
+            printf("FAIL: acquireWriteBuffer() = %d, handle %d\n", ret, int(handle));
+            return false;
+        }
+        std::memset(wbuffs[0], int(i), ring.getBuffSize());
+        ring.releaseWriteBuffer(handle, 10+i, SOAPY_SDR_HAS_TIME, 1000*i);
+    }
+    ret = ring.acquireWriteBuffer(handle, wbuffs, 1000);
+    if (ret != SOAPY_SDR_TIMEOUT)
+    {
+        printf("FAIL: full ring acquireWriteBuffer() = %d\n", ret);
+        return false;
+    }
+
+    //the dropped data is reported in order after the queued buffers
+    ring.reportOverflow();
+    for (size_t i = 0; i < ring.getNumBuffs(); i++)
+    {
+        ret = ring.acquireReadBuffer(handle, rbuffs, flags, timeNs, 0);
+        if (ret != int(10+i) or flags != SOAPY_SDR_HAS_TIME or timeNs != (long long)(1000*i) or
+            ((const unsigned char *)rbuffs[0])[ring.getBuffSize()-1] != i)
+        {
+            printf("FAIL: acquireReadBuffer() = %d, flags %d, time %lld\n", ret, flags, timeNs);
+            return false;
+        }
+        ring.releaseReadBuffer(handle);
+    }
+    ring.acquireWriteBuffer(handle, wbuffs, 0);
+    ring.releaseWriteBuffer(handle, 42);
+    ret = ring.acquireReadBuffer(handle, rbuffs, flags, timeNs, 0);
+    if (ret != SOAPY_SDR_OVERFLOW)
+    {
+        printf("FAIL: overflow not reported, acquireReadBuffer() = %d\n", ret);
+        return false;
+    }
+    ret = ring.acquireReadBuffer(handle, rbuffs, flags, timeNs, 0);
+    if (ret != 42)
+    {
+        printf("FAIL: buffer after overflow, acquireReadBuffer() = %d\n", ret);
+        return false;
+    }
+    ring.releaseReadBuffer(handle);
+
+    printf("OK\n");
+    return true;
+}
+
+static bool checkThreaded(const size_t numBuffs, const long timeoutUs)
+{
+    const size_t numTransfers(100000);
+    SoapySDR::StreamRing ring(numBuffs, 64, 4);
+
+    std::thread producer([&ring, timeoutUs, numTransfers]()
+    {
+        size_t handle(0);
+        void *buffs[1];
+        for (size_t i = 0; i < numTransfers;)
+        {
+            //a polling side yields so a single core makes progress
+            if (ring.acquireWriteBuffer(handle, buffs, timeoutUs) < 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            std::memcpy(buffs[0], &i, sizeof(i));
+            ring.releaseWriteBuffer(handle, i%256, 0, (long long)(i));
+            i++;
+        }
+    });
+
+    bool ok(true);
+    size_t handle(0);
+    const void *buffs[1];
+    int flags(0);
+    long long timeNs(0);
+    for (size_t i = 0; i < numTransfers and ok;)
+    {
+        const int ret = ring.acquireReadBuffer(handle, buffs, flags, timeNs, timeoutUs);
+        if (ret == SOAPY_SDR_TIMEOUT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        size_t seq(0);
+        std::memcpy(&seq, buffs[0], sizeof(seq));
+        if (ret != int(i%256) or seq != i or timeNs != (long long)(i))
+        {
+            printf("FAIL: transfer %d got ret %d, seq %d, time %lld\n", int(i), ret, int(seq), timeNs);
+            ok = false;
+        }
+        ring.releaseReadBuffer(handle);
+        i++;
+    }
+
+    //drain so the producer can finish after a failure
+    while (not ok and ring.acquireReadBuffer(handle, buffs, flags, timeNs, 100000) >= 0) ring.releaseReadBuffer(handle);
+    producer.join();
+
+    if (ok) printf("OK\n");
+    return ok;
+}
+
+int main(void)
+{
+    bool ok(true);
+
+    printf("Check configuration... ");
+    ok = ok and checkConfiguration();
+
+    printf("Check single thread... ");
+    ok = ok and checkSingleThread();
+
+    printf("Check threaded blocking... ");
+    ok = ok and checkThreaded(4, 100000);
+
+    printf("Check threaded single buffer... ");
+    ok = ok and checkThreaded(1, 100000);
+
+    printf("Check threaded polling... ");
+    ok = ok and checkThreaded(16, 0);
+
+    printf("DONE!\n");
+    return ok?EXIT_SUCCESS:EXIT_FAILURE;
+}